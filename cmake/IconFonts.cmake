@@ -7,10 +7,16 @@ include(IconFontsPython)
 include(IconFontsStrings)
 include(IconFontsUtilities)
 
+# the QML modules of fonts registered with ICONFONTS_QML_FONT_MODULES are placed below this directory
+if (NOT ICONFONTS_QML_OUTPUT_DIRECTORY)
+    set(ICONFONTS_QML_OUTPUT_DIRECTORY "${CMAKE_BINARY_DIR}/qml")
+endif()
+
 # FIXME doxs
 function(iconfonts_add_font)
     set(options
         OPTIONAL                # the option for enabling this font is disabled by default for OPTIONAL fonts
+        OUTLINES                # extract glyph outlines at build time, so that they are drawn without QFontDatabase
         PYTHON_REQUIRED         # skip and warn if no Python interpreter is available
         SKIP_RESOURCES)         # do not generate Qt resources
 
@@ -195,6 +201,19 @@ function(iconfonts_add_font)
             PROPERTY QT_RESOURCE_ALIAS "${opentype_filename}")
 
         list(APPEND resources_list "${opentype_filepath}")
+
+        if (ICONFONTS_OUTLINES) # --------------------------------------------------------------- maybe extract outlines
+            __iconfonts_extract_outlines("${opentype_filepath}" "${resource_dirpath}" outlines_filepath)
+            cmake_path(GET outlines_filepath FILENAME outlines_filename)
+
+            set_property(
+                SOURCE "${outlines_filepath}"
+                PROPERTY QT_RESOURCE_ALIAS "${outlines_filename}")
+
+            list(APPEND resources_list "${outlines_filepath}")
+        endif()
+    elseif (ICONFONTS_OUTLINES)
+        message(WARNING "Ignoring OUTLINES for the system font ${ICONFONTS_FONT_FAMILY} ${ICONFONTS_FONT_VARIANT}")
     endif()
 
     if (ICONFONTS_RESOURCE_PREFIX) # ------------------------------------------------------------- download license file
@@ -217,6 +236,7 @@ function(iconfonts_add_font)
         INFO_OPTIONS        "${ICONFONTS_INFO_OPTIONS}"
         INFO_FILETYPE       "${ICONFONTS_INFO_FILETYPE}"
         LICENSE_FILEPATH    "${ICONFONTS_LICENSE_FILEPATH}"
+        OUTLINES_FILENAME   "${outlines_filename}"
     )
 
     if (NOT ICONFONTS_SKIP_RESOURCES) # ------------------------------------------------------ generate Qt resource file
@@ -245,6 +265,7 @@ endfunction(iconfonts_add_font)
 function(iconfonts_add_font_family)
     set(options
         OPTIONAL                # the option for enabling this font is disabled by default for OPTIONAL fonts
+        OUTLINES                # extract glyph outlines at build time, so that they are drawn without QFontDatabase
         PYTHON_REQUIRED)        # skip and warn if no Python interpreter is available
 
     set(mandatory_values
@@ -282,6 +303,10 @@ function(iconfonts_add_font_family)
         list(APPEND extra_options "PYTHON_REQUIRED")
     endif()
 
+    if (ICONFONTS_OUTLINES)
+        list(APPEND extra_options "OUTLINES")
+    endif()
+
     unset(combined_resources_list) # ------------------------------------------------------------- collect font variants
 
     foreach(variant_spec IN LISTS ICONFONTS_FONT_VARIANTS)
@@ -62,6 +62,120 @@ function(__iconfonts_generate_from_template SOURCE_FILEPATH TARGET_FILEPATH)
     configure_file("${SOURCE_FILEPATH}" "${TARGET_FILEPATH}")
 endfunction()
 
+# ----------------------------------------------------------------------------------------------------------------------
+# Generates a compact symbol table from `ICON_DEFINITIONS` as used by `IconFonts::Private::SymbolTable`.
+# The C++ definition of this table is reported to `OUTPUT_VARIABLE`.
+# ----------------------------------------------------------------------------------------------------------------------
+function(__iconfonts_generate_symbol_table ICON_DEFINITIONS OUTPUT_VARIABLE)
+    string(
+        REGEX MATCHALL "\n    [A-Za-z_][A-Za-z0-9_]* *= *[^,\n]+,"
+        definition_list "\n${ICON_DEFINITIONS}")
+
+    unset(symbol_list) # ------------------------------------------------ resolve aliases, and sort symbols by codepoint
+    set(index 0)
+
+    foreach(definition IN LISTS definition_list)
+        string(REGEX MATCH "([A-Za-z_][A-Za-z0-9_]*) *= *([^,]+)," _ "${definition}")
+        set(name "${CMAKE_MATCH_1}")
+        set(value "${CMAKE_MATCH_2}")
+
+        if (value MATCHES "^(0x[0-9A-Fa-f]+|[0-9]+)\$")
+            math(EXPR unicode "${value}")
+        elseif (DEFINED "unicode_of_${value}")
+            set(unicode "${unicode_of_${value}}")
+        else()
+            message(WARNING "Skipping symbol ${name} with unsupported value: ${value}")
+            continue()
+        endif()
+
+        set("unicode_of_${name}" "${unicode}")
+
+        # the zero padded definition index keeps the order of aliases stable
+        string(LENGTH "${unicode}" unicode_length)
+        string(LENGTH "${index}" index_length)
+        math(EXPR unicode_padding "7 - ${unicode_length}")
+        math(EXPR index_padding "6 - ${index_length}")
+        string(REPEAT "0" ${unicode_padding} unicode_padding)
+        string(REPEAT "0" ${index_padding} index_padding)
+
+        list(APPEND symbol_list "${unicode_padding}${unicode}:${index_padding}${index}:${name}")
+        math(EXPR index "${index} + 1")
+    endforeach()
+
+    list(SORT symbol_list)
+    list(LENGTH symbol_list symbol_count)
+
+    set(unicode_list "") # ----------------------------------------------------------------- generate the table's fields
+    set(offset_list "")
+    set(key_list "")
+    set(key_pool_size 0)
+
+    foreach(symbol IN LISTS symbol_list)
+        string(REGEX MATCH "^0*([0-9]+):[0-9]+:(.*)\$" _ "${symbol}")
+        math(EXPR unicode "${CMAKE_MATCH_1}" OUTPUT_FORMAT HEXADECIMAL)
+        set(name "${CMAKE_MATCH_2}")
+
+        string(APPEND unicode_list "        Private::littleEndian(${unicode}), // ${name}\n")
+        string(APPEND offset_list "        Private::littleEndian(${key_pool_size}),\n")
+        string(APPEND key_list "    \"${name}\\0\"\n")
+
+        string(LENGTH "${name}" name_length)
+        math(EXPR key_pool_size "${key_pool_size} + ${name_length} + 1")
+    endforeach()
+
+    set(table_type "Private::StaticSymbolTable<${symbol_count}, ${key_pool_size}>")
+
+    string(
+        CONCAT table_header
+        "Private::littleEndian(Private::SymbolTable::Magic), Private::littleEndian(Private::SymbolTable::Version), "
+        "Private::littleEndian(${symbol_count}), Private::littleEndian(${key_pool_size})")
+
+    string(
+        CONCAT table_definition
+        "\nstatic constexpr auto s_symbolTable = ${table_type}{\n"
+        "    {${table_header}},\n"
+        "    {\n${unicode_list}    },\n"
+        "    {\n${offset_list}    },\n"
+        "${key_list}}\;\n")
+
+    set("${OUTPUT_VARIABLE}" "${table_definition}" PARENT_SCOPE)
+endfunction()
+
+# ----------------------------------------------------------------------------------------------------------------------
+# Collects the search tags found in the comments of `ICON_DEFINITIONS`, like `// tags: trash, delete, bin`.
+# The C++ definition of a string with a "Key=tag,tag" line for each tagged symbol is reported to `OUTPUT_VARIABLE`,
+# the expression returning this string as `QByteArrayView` is reported to `EXPRESSION_VARIABLE`.
+# ----------------------------------------------------------------------------------------------------------------------
+function(__iconfonts_generate_search_tags ICON_DEFINITIONS OUTPUT_VARIABLE EXPRESSION_VARIABLE)
+    string(
+        REGEX MATCHALL "\n    [A-Za-z_][A-Za-z0-9_]* *= *[^,\n]+, *//[^\n]*tags: [^\n]+"
+        definition_list "\n${ICON_DEFINITIONS}")
+
+    set(tag_list "")
+
+    foreach(definition IN LISTS definition_list)
+        string(REGEX MATCH "([A-Za-z_][A-Za-z0-9_]*) *=.*tags: (.+)" _ "${definition}")
+        set(name "${CMAKE_MATCH_1}")
+
+        # only keep what is safe within a string literal, and what the search index considers anyway
+        string(REGEX REPLACE "[^A-Za-z0-9 ,_-]" "" tags "${CMAKE_MATCH_2}")
+        string(REGEX REPLACE " *, *" "," tags "${tags}")
+        string(STRIP "${tags}" tags)
+
+        if (tags)
+            string(APPEND tag_list "    \"${name}=${tags}\\n\"\n")
+        endif()
+    endforeach()
+
+    if (tag_list)
+        set("${OUTPUT_VARIABLE}" "\nstatic constexpr char s_searchTags[] =\n${tag_list}\;\n" PARENT_SCOPE)
+        set("${EXPRESSION_VARIABLE}" "QByteArrayView{s_searchTags, sizeof s_searchTags - 1}" PARENT_SCOPE)
+    else()
+        set("${OUTPUT_VARIABLE}" "" PARENT_SCOPE)
+        set("${EXPRESSION_VARIABLE}" "{}" PARENT_SCOPE)
+    endif()
+endfunction()
+
 # ----------------------------------------------------------------------------------------------------------------------
 # Generates C++ code from `ICON_DEFINITIONS`.
 # ----------------------------------------------------------------------------------------------------------------------
@@ -77,6 +191,7 @@ function(__iconfonts_generate_source_code)
         FONT_VARIANT
         INFO_FILETYPE
         INFO_OPTIONS
+        OUTLINES_FILENAME
         QUICK_TARGET)
 
     set(single_values ${mandatory_values} ${optional_values})
@@ -142,14 +257,26 @@ function(__iconfonts_generate_source_code)
         message(FATAL_ERROR "Either FONT_FILEPATH or FONT_FAMILY is needed")
     endif()
 
+    if (ICONFONTS_OUTLINES_FILENAME) # --------------------------------- resolve resource filename of the glyph outlines
+        set(outlines_literal "u\":${ICONFONTS_RESOURCE_PREFIX}/${ICONFONTS_OUTLINES_FILENAME}\"_s")
+        set(glyph_outlines_expression "Private::staticGlyphOutlines<Symbols::${font_namespace}::Symbol>(${outlines_literal})")
+    else()
+        set(glyph_outlines_expression "nullptr")
+    endif()
+
     if (ICONFONTS_LICENSE_FILEPATH MATCHES "\\.md\$") # ------------------ resolve resource filename of the font license
         set(license_filename "LICENSE.md")
     else()
         set(license_filename "LICENSE.txt")
     endif()
 
+    # the stamp only gets touched when changing ICONFONTS_COMPACT_METADATA or OUTLINES, which triggers code generation
+    set(metadata_stamp "${ICONFONTS_GENERATED_SOURCES_DIR}/${basename}.stamp")
+    file(CONFIGURE OUTPUT "${metadata_stamp}" CONTENT
+        "compact-metadata=${ICONFONTS_COMPACT_METADATA}\noutlines=${ICONFONTS_OUTLINES_FILENAME}\n")
+
     set(current_list_file ${CMAKE_CURRENT_FUNCTION_LIST_FILE}) # ------------------------------- generate code if needed
-    set(common_dependency_list ICONFONTS_INFO_FILEPATH CMAKE_CURRENT_LIST_FILE current_list_file)
+    set(common_dependency_list ICONFONTS_INFO_FILEPATH CMAKE_CURRENT_LIST_FILE current_list_file metadata_stamp)
 
     __iconfonts_check_recent(header_is_recent header_filepath header_template ${common_dependency_list})
     __iconfonts_check_recent(source_is_recent source_filepath source_template ${common_dependency_list})
@@ -178,6 +305,19 @@ function(__iconfonts_generate_source_code)
             quick_icon_definition_list "${icon_definition_list}")
 
         iconfonts_assert(NOT icon_definition_list STREQUAL quick_icon_definition_list)
+
+        if (ICONFONTS_COMPACT_METADATA) # --------------------------------- store symbol names in a compact symbol table
+            __iconfonts_generate_symbol_table("${icon_definition_list}" symbol_table_definition)
+            set(symbol_table_expression "Private::staticSymbolTable<Symbols::${font_namespace}::Symbol>(s_symbolTable)")
+            set(enum_registration "// symbol names are stored in a compact symbol table instead of a meta-enum")
+        else()
+            set(symbol_table_definition "")
+            set(symbol_table_expression "nullptr")
+            set(enum_registration "Q_ENUM_NS(Symbol)")
+        endif()
+
+        __iconfonts_generate_search_tags( # ------------------------------- keep the search tags found in the metadata
+            "${icon_definition_list}" search_tags_definition search_tags_expression)
     endif()
 
     set(mandatory_variables # ----------------------------------------------------- define variables for code generation
@@ -195,19 +335,25 @@ function(__iconfonts_generate_source_code)
         FONT_NAME               # Font name for displaying to the user
         FONT_FAMILY_EXPRESSION  # C++ expression for querying the font family
         FONT_FILENAME_LITERAL   # C++ literal with the font filename without path
+        GLYPH_OUTLINES_EXPRESSION # C++ expression returning the glyph outlines, if any
         HEADER_FILENAME         # filename of the header to include
         LICENSE_FILEPATH        # filepath of the license text
-        RESOURCE_SYMBOL)        # C++ symbol name of the Qt resource
+        RESOURCE_SYMBOL         # C++ symbol name of the Qt resource
+        SEARCH_TAGS_EXPRESSION  # C++ expression returning the search tags, if any
+        SYMBOL_TABLE_EXPRESSION)# C++ expression returning the compact symbol table, if any
 
     set(quick_mandatory_variables ${header_mandatory_variables}
         HEADER_FILENAME)        # filename of the header to include
 
     list(
         APPEND header_mandatory_variables
+        ENUM_REGISTRATION       # registers the symbol enum with Qt's meta-object system, unless compact
         FONT_TAG)               # unique tag for symbols of this font
 
     set(optional_variables
-        FONT_VARIANT_SYMBOL)    # C++ symbol for the font variant
+        FONT_VARIANT_SYMBOL     # C++ symbol for the font variant
+        SEARCH_TAGS_DEFINITION  # C++ definition of the search tags, if any
+        SYMBOL_TABLE_DEFINITION)# C++ definition of the compact symbol table, if any
 
     if (NOT header_is_recent) # -------------------------------------------------------- generate static fontinfo header
         __iconfonts_generate_from_template(
@@ -223,6 +369,7 @@ function(__iconfonts_generate_source_code)
             INFO_FILEPATH           "${pretty_info_filename}"
             LIST_FILEPATH           "${pretty_list_filename}"
             ICON_DEFINITIONS        "${icon_definition_list}"
+            ENUM_REGISTRATION       "${enum_registration}"
             VARIABLES                header_mandatory_variables
             OPTIONAL_VARIABLES       optional_variables)
     endif()
@@ -237,12 +384,17 @@ function(__iconfonts_generate_source_code)
             FONT_FAMILY_SYMBOL      "${family_symbol}"
             FONT_VARIANT_SYMBOL     "${variant_symbol}"
             FONT_FILENAME_LITERAL   "${font_filename_literal}"
+            GLYPH_OUTLINES_EXPRESSION "${glyph_outlines_expression}"
             HEADER_FILENAME         "${basename}.h"
             FONT_NAME               "${font_name}"
             INFO_FILEPATH           "${pretty_info_filename}"
             LIST_FILEPATH           "${pretty_list_filename}"
             LICENSE_FILEPATH        "${ICONFONTS_RESOURCE_PREFIX}/${license_filename}"
             RESOURCE_SYMBOL         "${family_symbol}"
+            SEARCH_TAGS_DEFINITION  "${search_tags_definition}"
+            SEARCH_TAGS_EXPRESSION  "${search_tags_expression}"
+            SYMBOL_TABLE_DEFINITION "${symbol_table_definition}"
+            SYMBOL_TABLE_EXPRESSION "${symbol_table_expression}"
             VARIABLES                source_mandatory_variables
             OPTIONAL_VARIABLES       optional_variables)
     endif()
@@ -276,7 +428,24 @@ function(__iconfonts_generate_source_code)
         "${header_filepath}"
         "${source_filepath}")
 
-    if (ICONFONTS_QUICK_TARGET)
+    if (ICONFONTS_QUICK_TARGET AND ICONFONTS_QML_FONT_MODULES)
+        # a plugin-only QML module per font, so that only the fonts imported by QML get registered
+        set(font_symbol "${family_symbol}${variant_symbol}")
+        set(font_module_target "${ICONFONTS_QUICK_TARGET}${font_symbol}")
+
+        qt_add_qml_module(
+            "${font_module_target}"
+            URI "IconFonts.${font_symbol}"
+            PLUGIN_TARGET "${font_module_target}"
+            OUTPUT_DIRECTORY "${ICONFONTS_QML_OUTPUT_DIRECTORY}/IconFonts/${font_symbol}"
+            SOURCES "${quick_filepath}")
+
+        target_link_libraries("${font_module_target}" PRIVATE "${ICONFONTS_QUICK_TARGET}")
+
+        set_property(
+            TARGET "${ICONFONTS_QUICK_TARGET}" APPEND PROPERTY
+            ICONFONTS_FONT_MODULES "${font_module_target}")
+    elseif (ICONFONTS_QUICK_TARGET)
         target_sources("${ICONFONTS_QUICK_TARGET}" PRIVATE "${quick_filepath}")
     endif()
 
@@ -436,6 +436,14 @@ function(__iconfonts_collect_icons_icomoon OUTPUT_VARIABLE INFO_FILEPATH)
     set("${OUTPUT_VARIABLE}" ${icon_definitions} PARENT_SCOPE)
 endfunction()
 
+# ----------------------------------------------------------------------------------------------------------------------
+# Collects icon definitions from the character map and glyph names of OpenType font `INFO_FILEPATH`.
+# ----------------------------------------------------------------------------------------------------------------------
+function(__iconfonts_collect_icons_opentype OUTPUT_VARIABLE INFO_FILEPATH)
+    __iconfonts_collect_icons_python(icon_definitions "${INFO_FILEPATH}")
+    set("${OUTPUT_VARIABLE}" ${icon_definitions} PARENT_SCOPE)
+endfunction()
+
 # ----------------------------------------------------------------------------------------------------------------------
 # Collects icon definitions in `FORMAT`from `FILENAME` for `FONT_VARIANT`.
 # `FILENAME` is considered relative to `DIRECTORY`.
@@ -477,6 +485,8 @@ function(__iconfonts_collect_icons)
         __iconfonts_collect_icons_microsoft_idl(
             icon_definitions "${COLLECT_FILEPATH}" "${COLLECT_FONT_VARIANT}"
             "Microsoft.UI.Xaml.Controls" "Symbol")
+    elseif (COLLECT_FILETYPE STREQUAL "opentype")
+        __iconfonts_collect_icons_opentype(icon_definitions "${COLLECT_FILEPATH}")
     else()
         message(FATAL_ERROR "Unknown icon info format ${COLLECT_FILETYPE} for '${COLLECT_FILEPATH}'")
     endif()
@@ -84,6 +84,8 @@ function(__iconfonts_guess_info_type INFO_FILEPATH FONT_FILEPATH FONT_VARIANT OU
         set(info_type "mapping")
     elseif (info_filename MATCHES "\\.idl$")
         set(info_type "microsoft-idl")
+    elseif (info_filename MATCHES "\\.(otf|ttf|woff2?)$")
+        set(info_type "opentype")
     endif()
 
     if (NOT info_type AND FONT_FILEPATH)
@@ -113,7 +115,7 @@ endfunction()
 # ----------------------------------------------------------------------------------------------------------------------
 function(__iconfonts_convert_webfont FONT_FILEPATH OUTPUT_DIRECTORY OUTPUT_VARIABLE)
     if (FONT_FILEPATH MATCHES "\\.woff")
-        if (NOT Python3::Interpreter)
+        if (NOT TARGET Python3::Interpreter)
             message(FATAL_ERROR "A Python interpreter is needed to convert webfonts")
             return()
         endif()
@@ -146,6 +148,32 @@ function(__iconfonts_convert_webfont FONT_FILEPATH OUTPUT_DIRECTORY OUTPUT_VARIA
     endif()
 endfunction()
 
+# ----------------------------------------------------------------------------------------------------------------------
+# Extracts the glyph outlines of `FONT_FILEPATH` into `OUTPUT_DIRECTORY` as used by `IconFonts::Private::GlyphOutlines`.
+# The path of the generated file is reported to `OUTPUT_VARIABLE`.
+# ----------------------------------------------------------------------------------------------------------------------
+function(__iconfonts_extract_outlines FONT_FILEPATH OUTPUT_DIRECTORY OUTPUT_VARIABLE)
+    if (NOT TARGET Python3::Interpreter)
+        message(FATAL_ERROR "A Python interpreter is needed to extract glyph outlines")
+        return()
+    endif()
+
+    cmake_path(GET FONT_FILEPATH STEM basename)
+    set(outlines_filepath "${OUTPUT_DIRECTORY}/${basename}.outlines")
+
+    add_custom_command(
+        OUTPUT "${outlines_filepath}"
+        DEPENDS "${FONT_FILEPATH}" "${ICONFONTS_TOOL_EXECUTABLE}"
+        COMMAND Python3::Interpreter "${ICONFONTS_TOOL_EXECUTABLE}" --outlines "${FONT_FILEPATH}" "${outlines_filepath}"
+        COMMENT "Generating ${outlines_filepath}")
+
+    set_source_files_properties(
+        "${outlines_filepath}"
+        PROPERTIES GENERATED YES)
+
+    set("${OUTPUT_VARIABLE}" "${outlines_filepath}" PARENT_SCOPE)
+endfunction()
+
 # ----------------------------------------------------------------------------------------------------------------------
 # Adds a CMake option for adding the font named by `FONT_FAMILY` and `FONT_VARIANT` to `TARGET`.
 # ----------------------------------------------------------------------------------------------------------------------
@@ -306,5 +334,8 @@ if (ICONFONTS_ENABLE_TESTING)
     __iconfonts_guess_info_type("controls/microsoft.ui.xaml.controls.controls2.idl" "" "" test_string)
     iconfonts_assert(test_string STREQUAL "microsoft-idl")
 
+    __iconfonts_guess_info_type("fonts/icons.ttf" "fonts/icons.ttf" "" test_string)
+    iconfonts_assert(test_string STREQUAL "opentype")
+
     list(POP_BACK CMAKE_MESSAGE_INDENT)
 endif(ICONFONTS_ENABLE_TESTING)
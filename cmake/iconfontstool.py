@@ -5,32 +5,51 @@
 This module provides a command line tool for processing icon font metadata.
 """
 
+from enum    import IntEnum
 from inspect import cleandoc
 from pathlib import Path
-from typing  import List, Tuple
+from typing  import Any, List, Set, Tuple
 
 import json
 import re
+import struct
 import sys
 
 
 IconList = List[Tuple[str, str|None, str|None]]
 
+OUTLINES_MAGIC   = 0x4f474649 # "IFGO"
+OUTLINES_VERSION = 1
+
+
+class OutlineCommand(IntEnum):
+    """
+    The opcodes of the command stream written by `write_opentype_outlines()`.
+    """
+
+    MOVE_TO  = 1
+    LINE_TO  = 2
+    QUAD_TO  = 3
+    CUBIC_TO = 4
+    CLOSE    = 5
+
 
 def make_enumkey(name: str) -> str:
     """
     Converts `name` into a camelcase enum key.
-    The result gets prefixed with "_" if `name` starts with a number.
+    The result gets prefixed with "_" if `name` starts with a number,
+    and is empty if `name` consists of separators only.
     """
 
     sections =  [
         s[0].upper() + s[1:].lower()
         for s in re.split(r'[ \t_-]', name)
+        if s
     ]
 
     name = ''.join(sections)
 
-    if name[0].isdigit():
+    if name and name[0].isdigit():
         name = f'_{name}'
 
     return name
@@ -139,6 +158,12 @@ def convert_fontawesome_metadata(filepath: Path, license_name: str, style_name:
             name = make_enumkey(name)
             comment = f'supported styles: {", ".join(supported_styles)}'
 
+            terms = info.get('search', {}).get('terms', [])
+
+            # semicolons would split the definitions when they get processed as CMake list
+            if tags := ', '.join(term.replace(';', '') for term in terms):
+                comment += f', tags: {tags}'
+
             if style_name not in supported_styles:
                 icons.append((name, None, comment))
                 continue
@@ -194,6 +219,138 @@ def convert_materialsymbols_codepoints(filepath: Path) -> IconList:
     return icons
 
 
+def read_custom_glyphnames(font: Any) -> Set[str]:
+    """
+    Returns the glyph names which `font` defines itself, like `OpenTypeReader::glyphNames()`
+    reads them: the custom names of a version 2 `post` table, or otherwise the non-standard
+    names of the `CFF ` table.
+    """
+
+    # only needed for fonts without separate metadata, therefore imported lazily
+    from fontTools.cffLib import cffStandardStrings # type: ignore # pylint: disable=import-outside-toplevel
+
+    if 'post' in font and font['post'].formatType == 2.0:
+        return set(font['post'].extraNames)
+    if 'CFF ' in font:
+        return set(font.getGlyphOrder()) - set(cffStandardStrings)
+
+    return set()
+
+
+def convert_opentype_glyphnames(filepath: Path) -> IconList:
+    """
+    Transforms character map and glyph names of the OpenType font in `filepath` into an `IconList`.
+    """
+
+    # only needed for fonts without separate metadata, therefore imported lazily
+    from fontTools.ttLib import TTFont # type: ignore # pylint: disable=import-outside-toplevel
+
+    icons: IconList = []
+
+    with TTFont(filepath, lazy=True) as font:
+        # fontTools makes up names like "glyph00042" for unnamed glyphs, and reports standard
+        # names, while OpenTypeReader only reads custom names, and otherwise follows the
+        # Adobe Glyph List specification
+        custom_glyphnames = read_custom_glyphnames(font)
+
+        for codepoint, glyphname in sorted(font.getBestCmap().items()):
+            if codepoint <= 0x20 or glyphname.startswith('.'):
+                continue
+
+            if glyphname not in custom_glyphnames:
+                glyphname = f'uni{codepoint:04X}' if codepoint <= 0xffff else f'u{codepoint:04X}'
+
+            name = re.sub(r'[^A-Za-z0-9 \t_-]', '', glyphname.replace('.', '_'))
+
+            if key := make_enumkey(name):
+                icons.append((key, f'0x{codepoint:x}', None))
+
+    return icons
+
+
+def quantize_int16(value: float) -> int:
+    """
+    Rounds `value` to the nearest integer within the range of 16 bit integers.
+    """
+
+    return max(-0x8000, min(0x7fff, round(value)))
+
+
+def write_opentype_outlines(filepath: Path, outputpath: Path) -> None:
+    """
+    Writes the glyph outlines of the OpenType font in `filepath` to `outputpath`,
+    quantized to 16 bit integers. The layout is described by `GlyphOutlines`.
+    """
+
+    # only needed for fonts using the OUTLINES option, therefore imported lazily
+    from fontTools.pens.basePen import BasePen # type: ignore # pylint: disable=import-outside-toplevel
+    from fontTools.ttLib import TTFont # type: ignore # pylint: disable=import-outside-toplevel
+
+    class CommandPen(BasePen): # type: ignore # pylint: disable=abstract-method
+        """
+        Records outlines as opcodes that are followed by their coordinates.
+        """
+
+        def __init__(self, glyphset, commands: list[int]) -> None:
+            super().__init__(glyphset)
+            self.commands = commands
+
+        def emit(self, opcode: OutlineCommand, *points: Tuple[float, float]) -> None:
+            """
+            Appends `opcode` and the quantized coordinates of `points` to the command stream.
+            """
+
+            self.commands.append(opcode)
+
+            for x, y in points:
+                self.commands += [quantize_int16(x), quantize_int16(y)]
+
+        def _moveTo(self, pt): # pylint: disable=invalid-name
+            self.emit(OutlineCommand.MOVE_TO, pt)
+
+        def _lineTo(self, pt): # pylint: disable=invalid-name
+            self.emit(OutlineCommand.LINE_TO, pt)
+
+        def _qCurveToOne(self, pt1, pt2): # pylint: disable=invalid-name
+            self.emit(OutlineCommand.QUAD_TO, pt1, pt2)
+
+        def _curveToOne(self, pt1, pt2, pt3): # pylint: disable=invalid-name
+            self.emit(OutlineCommand.CUBIC_TO, pt1, pt2, pt3)
+
+        def _closePath(self): # pylint: disable=invalid-name
+            self.emit(OutlineCommand.CLOSE)
+
+    unicodes: list[int] = []
+    offsets: list[int] = []
+    advances: list[int] = []
+    commands: list[int] = []
+
+    with TTFont(filepath, lazy=True) as font:
+        glyphset = font.getGlyphSet()
+
+        for codepoint, glyphname in sorted(font.getBestCmap().items()):
+            if codepoint <= 0x20 or glyphname.startswith('.'):
+                continue
+
+            unicodes.append(codepoint)
+            offsets.append(len(commands))
+            advances.append(min(0xffff, max(0, glyphset[glyphname].width)))
+            glyphset[glyphname].draw(CommandPen(glyphset, commands))
+
+        offsets.append(len(commands))
+
+        header = struct.pack(
+            '<4I4h', OUTLINES_MAGIC, OUTLINES_VERSION, len(unicodes), len(commands),
+            font['head'].unitsPerEm, font['hhea'].ascent, font['hhea'].descent, 0)
+
+    with open(outputpath, 'wb') as output:
+        output.write(header)
+        output.write(struct.pack(f'<{len(unicodes)}I', *unicodes))
+        output.write(struct.pack(f'<{len(offsets)}I', *offsets))
+        output.write(struct.pack(f'<{len(advances)}H', *advances))
+        output.write(struct.pack(f'<{len(commands)}h', *commands))
+
+
 def print_usage(error_message: str) -> None:
     """
     Prints usage information for the tool.
@@ -205,6 +362,8 @@ def print_usage(error_message: str) -> None:
         Usage:
             {sys.argv[0]} metadata.json license style
             {sys.argv[0]} metadata.codepoints
+            {sys.argv[0]} font.otf
+            {sys.argv[0]} --outlines font.otf font.outlines
     '''), file=sys.stderr)
 
     sys.exit(2)
@@ -218,6 +377,13 @@ def main(args: list[str]) -> None:
     if len(args) < 2:
         print_usage('The filename is missing')
 
+    if args[1] == '--outlines':
+        if len(args) < 4:
+            print_usage('The required arguments are missing')
+
+        write_opentype_outlines(Path(args[2]), Path(args[3]))
+        return
+
     filepath = Path(args[1])
 
     if filepath.name == 'selection.json':
@@ -238,6 +404,11 @@ def main(args: list[str]) -> None:
         icons = deduplicate_icons(icons)
         print_icon_definitions(icons)
 
+    elif filepath.suffix in ('.otf', '.ttf', '.woff', '.woff2'):
+        icons = convert_opentype_glyphnames(filepath)
+        icons = deduplicate_icons(icons)
+        print_icon_definitions(icons)
+
     else:
         print_usage('Unsupported filename')
 
@@ -0,0 +1,371 @@
+#include "distancefield_p.h"
+#include "glyphoutlines_p.h"
+#include "glyphrasterizer_p.h"
+#include "iconfonts_p.h"
+
+#include <QRawFont>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+
+namespace IconFonts {
+
+using namespace Private;
+
+namespace Private {
+namespace {
+
+// Calls `function` for each index up to `count`, distributed over all available cores.
+template<typename Function>
+void parallelFor(std::size_t count, Function &&function)
+{
+    const auto cores = std::max(std::thread::hardware_concurrency(), 1u);
+    const auto threadCount = std::clamp<std::size_t>(count, 1, cores);
+    auto nextIndex = std::atomic<std::size_t>{0};
+
+    const auto worker = [&] {
+        for (auto index = nextIndex++; index < count; index = nextIndex++)
+            function(index);
+    };
+
+    auto threads = std::vector<std::jthread>{};
+    threads.reserve(threadCount - 1);
+
+    for (auto i = std::size_t{1}; i < threadCount; ++i)
+        threads.emplace_back(worker);
+
+    worker();
+}
+
+// Lowers the squared distances of all pixels within the spread of the line from `a` to `b` to their distance to it.
+void updateDistances(std::vector<float> &distances, const QSize &size, const QPointF &a, const QPointF &b)
+{
+    const auto xBegin = std::max(0, qFloor(std::min(a.x(), b.x())) - DistanceField::Spread);
+    const auto xEnd = std::min(size.width(), qCeil(std::max(a.x(), b.x())) + DistanceField::Spread);
+    const auto yBegin = std::max(0, qFloor(std::min(a.y(), b.y())) - DistanceField::Spread);
+    const auto yEnd = std::min(size.height(), qCeil(std::max(a.y(), b.y())) + DistanceField::Spread);
+
+    const auto ax = static_cast<float>(a.x());
+    const auto ay = static_cast<float>(a.y());
+    const auto abx = static_cast<float>(b.x() - a.x());
+    const auto aby = static_cast<float>(b.y() - a.y());
+    const auto length = abx * abx + aby * aby;
+
+    for (auto y = yBegin; y < yEnd; ++y) {
+        const auto row = &distances[static_cast<std::size_t>(y * size.width())];
+        const auto cy = static_cast<float>(y) + 0.5f;
+
+        for (auto x = xBegin; x < xEnd; ++x) {
+            const auto cx = static_cast<float>(x) + 0.5f;
+            const auto t = length > 0 ? std::clamp(((cx - ax) * abx + (cy - ay) * aby) / length, 0.0f, 1.0f) : 0.0f;
+            const auto dx = ax + t * abx - cx;
+            const auto dy = ay + t * aby - cy;
+
+            row[x] = std::min(row[x], dx * dx + dy * dy);
+        }
+    }
+}
+
+struct DistanceFieldSource
+{
+    FontInfo font;
+    const GlyphOutlines *outlines;
+};
+
+// Holds the distance fields of one font. Outlines are taken from the build-time
+// glyph outlines if the font has them, and otherwise are read via QRawFont.
+class DistanceFieldCache
+{
+public:
+    explicit DistanceFieldCache(const DistanceFieldSource &source);
+
+    [[nodiscard]] DistanceField find(char32_t unicode) const;
+    void prepare(std::span<const char32_t> unicodes) const;
+    [[nodiscard]] qint64 clear() const;
+
+private:
+    struct Glyph
+    {
+        char32_t     unicode;
+        QPainterPath path;
+        qreal        advance;
+    };
+
+    [[nodiscard]] QRawFont rawFont() const;
+    [[nodiscard]] std::optional<Glyph> glyph(char32_t unicode, const QRawFont &rawFont) const;
+    [[nodiscard]] DistanceField generate(const Glyph &glyph) const;
+
+    const GlyphOutlines *m_outlines;
+    std::optional<QFont> m_font;  // only for fonts without outlines
+    qreal    m_ascent = 0;
+    qreal    m_descent = 0;
+
+    mutable QMutex m_mutex;
+    mutable std::unordered_map<char32_t, DistanceField> m_fields;
+};
+
+DistanceFieldCache::DistanceFieldCache(const DistanceFieldSource &source)
+    : m_outlines{source.outlines}
+{
+    if (m_outlines) {
+        m_ascent = m_outlines->ascent(DistanceField::ReferenceSize);
+        m_descent = m_outlines->descent(DistanceField::ReferenceSize);
+    } else if (source.font.isAvailable()) {
+        m_font = source.font.font();
+
+        const auto rawFont = DistanceFieldCache::rawFont();
+        m_ascent = rawFont.ascent();
+        m_descent = rawFont.descent();
+    }
+}
+
+DistanceField DistanceFieldCache::find(char32_t unicode) const
+{
+    const auto lock = QMutexLocker{&m_mutex};
+    auto it = m_fields.find(unicode);
+
+    if (it == m_fields.end()) {
+        const auto glyph = DistanceFieldCache::glyph(unicode, rawFont());
+        it = m_fields.emplace(unicode, glyph ? generate(*glyph) : DistanceField{}).first;
+    }
+
+    return it->second;
+}
+
+void DistanceFieldCache::prepare(std::span<const char32_t> unicodes) const
+{
+    const auto rawFont = DistanceFieldCache::rawFont();
+    auto glyphs = std::vector<Glyph>{};
+
+    {
+        const auto lock = QMutexLocker{&m_mutex};
+
+        for (const auto unicode : unicodes) {
+            if (m_fields.contains(unicode))
+                continue;
+
+            if (auto glyph = DistanceFieldCache::glyph(unicode, rawFont))
+                glyphs.emplace_back(std::move(*glyph));
+            else
+                m_fields.emplace(unicode, DistanceField{});
+        }
+    }
+
+    // only generating the fields is expensive, and can happen without holding the lock
+    auto fields = std::vector<DistanceField>(glyphs.size());
+    parallelFor(glyphs.size(), [this, &glyphs, &fields](std::size_t index) {
+        fields[index] = generate(glyphs[index]);
+    });
+
+    const auto lock = QMutexLocker{&m_mutex};
+
+    for (auto i = std::size_t{0}; i < glyphs.size(); ++i)
+        m_fields.try_emplace(glyphs[i].unicode, std::move(fields[i]));
+}
+
+qint64 DistanceFieldCache::clear() const
+{
+    const auto lock = QMutexLocker{&m_mutex};
+    auto bytes = qint64{0};
+
+    for (const auto &[unicode, field] : m_fields)
+        bytes += field.image().sizeInBytes();
+
+    m_fields.clear();
+    return bytes;
+}
+
+// QRawFont is bound to the thread that created it, but fields are requested from any thread;
+// therefore each request creates its own instance instead of sharing one
+QRawFont DistanceFieldCache::rawFont() const
+{
+    if (!m_font)
+        return {};
+
+    auto rawFont = QRawFont::fromFont(*m_font);
+    rawFont.setPixelSize(DistanceField::ReferenceSize);
+    return rawFont;
+}
+
+std::optional<DistanceFieldCache::Glyph> DistanceFieldCache::glyph(char32_t unicode, const QRawFont &rawFont) const
+{
+    if (m_outlines) {
+        if (auto path = m_outlines->path(unicode, DistanceField::ReferenceSize); !path.isEmpty())
+            return Glyph{unicode, std::move(path), m_outlines->advance(unicode, DistanceField::ReferenceSize)};
+
+        return {};
+    }
+
+    if (!rawFont.isValid())
+        return {};
+
+    const auto glyphs = rawFont.glyphIndexesForString(QString::fromUcs4(&unicode, 1));
+
+    if (glyphs.isEmpty() || glyphs[0] == 0)
+        return {};
+
+    const auto advances = rawFont.advancesForGlyphIndexes(glyphs);
+    return Glyph{unicode, rawFont.pathForGlyph(glyphs[0]), advances.value(0).x()};
+}
+
+DistanceField DistanceFieldCache::generate(const Glyph &glyph) const
+{
+    return DistanceField::fromPath(glyph.path, glyph.advance, m_ascent, m_descent);
+}
+
+[[nodiscard]] FontTagCache<DistanceFieldCache> &distanceFieldCaches()
+{
+    static auto s_caches = FontTagCache<DistanceFieldCache>{};
+    return s_caches;
+}
+
+[[nodiscard]] const DistanceFieldCache &distanceFieldCache(const DistanceFieldSource &source)
+{
+    return distanceFieldCaches().find(source.font.tag(), [&source] { return source; });
+}
+
+} // namespace
+
+qint64 trimDistanceFields()
+{
+    auto bytes = qint64{0};
+
+    distanceFieldCaches().forEach([&bytes](const DistanceFieldCache &cache) {
+        bytes += cache.clear();
+    });
+
+    return bytes;
+}
+
+// DistanceField class // ==============================================================================================
+
+DistanceField DistanceField::fromPath(const QPainterPath &path, qreal advance, qreal ascent, qreal descent)
+{
+    auto field = DistanceField{};
+
+    field.m_advance = advance;
+    field.m_ascent = ascent;
+    field.m_descent = descent;
+
+    if (path.isEmpty())
+        return field;
+
+    const auto bounds = path.boundingRect();
+    const auto left = qFloor(bounds.left()) - Spread;
+    const auto top = qFloor(bounds.top()) - Spread;
+    const auto size = QSize{qCeil(bounds.right()) + Spread - left, qCeil(bounds.bottom()) + Spread - top};
+    const auto toImage = QTransform::fromTranslate(-left, -top);
+
+    // the rasterizer resolves the winding rule, which provides the sign of the distances
+    const auto coverage = GlyphRasterizer::rasterize(path, size, toImage);
+
+    if (coverage.isNull())
+        return field;
+
+    auto distances = std::vector<float>(static_cast<std::size_t>(size.width() * size.height()), Spread * Spread);
+
+    for (const auto &polygon : path.toSubpathPolygons(toImage)) {
+        for (auto i = qsizetype{0}; i < polygon.size(); ++i)
+            updateDistances(distances, size, polygon[i], polygon[(i + 1) % polygon.size()]);
+    }
+
+    field.m_image = QImage{size, QImage::Format_Grayscale8};
+    field.m_origin = {static_cast<qreal>(left), static_cast<qreal>(top)};
+
+    for (auto y = 0; y < size.height(); ++y) {
+        const auto inside = coverage.constScanLine(y);
+        const auto line = field.m_image.scanLine(y);
+        const auto row = &distances[static_cast<std::size_t>(y * size.width())];
+
+        for (auto x = 0; x < size.width(); ++x) {
+            const auto distance = inside[x] >= 128 ? std::sqrt(row[x]) : -std::sqrt(row[x]);
+            const auto value = std::clamp(0.5f + distance / (2 * Spread), 0.0f, 1.0f);
+            line[x] = static_cast<uchar>(value * 255 + 0.5f);
+        }
+    }
+
+    return field;
+}
+
+QImage DistanceField::render(const QSize &size, const QTransform &transform) const
+{
+    auto mask = QImage{size, QImage::Format_Alpha8};
+    mask.fill(0);
+
+    if (Q_UNLIKELY(isNull() || !transform.isInvertible()))
+        return mask;
+
+    const auto inverse = transform.inverted();
+
+    // turns distances in reference pixels into distances in pixels of the mask
+    const auto scale = std::sqrt(std::abs(transform.m11() * transform.m22() - transform.m12() * transform.m21()));
+
+    for (auto y = 0; y < size.height(); ++y) {
+        const auto line = mask.scanLine(y);
+
+        for (auto x = 0; x < size.width(); ++x) {
+            const auto value = sample(inverse.map(QPointF{x + 0.5, y + 0.5}));
+            const auto distance = (value - 0.5) * 2 * Spread * scale;
+            line[x] = static_cast<uchar>(std::clamp(distance + 0.5, 0.0, 1.0) * 255 + 0.5);
+        }
+    }
+
+    return mask;
+}
+
+qreal DistanceField::sample(const QPointF &position) const noexcept
+{
+    // pixel values are sampled at their center
+    const auto u = position.x() - m_origin.x() - 0.5;
+    const auto v = position.y() - m_origin.y() - 0.5;
+    const auto x = qFloor(u);
+    const auto y = qFloor(v);
+    const auto fx = u - x;
+    const auto fy = v - y;
+
+    const auto pixel = [this](int x, int y) -> qreal {
+        if (x < 0 || y < 0 || x >= m_image.width() || y >= m_image.height())
+            return 0;
+
+        return m_image.constScanLine(y)[x] / 255.0;
+    };
+
+    return (pixel(x, y)     * (1 - fx) + pixel(x + 1, y)     * fx) * (1 - fy)
+         + (pixel(x, y + 1) * (1 - fx) + pixel(x + 1, y + 1) * fx) * fy;
+}
+
+} // namespace Private
+
+// FontInfo class // ===================================================================================================
+
+DistanceField FontInfo::distanceField(char32_t unicode) const
+{
+    if (Q_UNLIKELY(isNull()))
+        return {};
+
+    return distanceFieldCache({*this, glyphOutlines()}).find(unicode);
+}
+
+void FontInfo::prepareDistanceFields() const
+{
+    if (Q_UNLIKELY(isNull()))
+        return;
+
+    auto unicodes = std::vector<char32_t>{};
+    unicodes.reserve(static_cast<std::size_t>(symbolCount()));
+
+    for (auto count = symbolCount(), i = 0; i < count; ++i)
+        unicodes.emplace_back(unicode(i));
+
+    std::ranges::sort(unicodes);
+    const auto duplicates = std::ranges::unique(unicodes);
+    unicodes.erase(duplicates.begin(), duplicates.end());
+
+    distanceFieldCache({*this, glyphOutlines()}).prepare(unicodes);
+}
+
+} // namespace IconFonts
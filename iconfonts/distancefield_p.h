@@ -0,0 +1,58 @@
+#ifndef ICONFONTS_DISTANCEFIELD_P_H
+#define ICONFONTS_DISTANCEFIELD_P_H
+
+#include "iconfonts.h"
+
+#include <QImage>
+#include <QPainterPath>
+
+#include <span>
+#include <vector>
+
+namespace IconFonts::Private {
+
+// DistanceField class // ==============================================================================================
+
+// The signed distance field of a glyph, generated once at a reference pixel size. Each pixel stores the distance of its
+// center to the outline, mapped from [-Spread, +Spread] to [0, 255] with positive values inside. Edges get
+// reconstructed from it at any scale, and under any transformation, so that one field serves all sizes of a symbol.
+class ICONFONTS_EXPORT DistanceField final
+{
+public:
+    static constexpr int ReferenceSize = 64;    // the pixel size at which distance fields are generated
+    static constexpr int Spread = 8;            // the distance in reference pixels at which fields saturate
+
+    DistanceField() noexcept = default;
+
+    // Generates the field of `path`, which has its origin on the baseline and is scaled to `ReferenceSize`.
+    [[nodiscard]] static DistanceField fromPath(const QPainterPath &path, qreal advance, qreal ascent, qreal descent);
+
+    [[nodiscard]] bool isNull() const noexcept { return m_image.isNull(); }
+
+    [[nodiscard]] QImage image() const noexcept { return m_image; }
+    [[nodiscard]] QRectF bounds() const noexcept { return {m_origin, QSizeF{m_image.size()}}; }
+
+    [[nodiscard]] qreal advance() const noexcept { return m_advance; }
+    [[nodiscard]] qreal ascent() const noexcept { return m_ascent; }
+    [[nodiscard]] qreal descent() const noexcept { return m_descent; }
+
+    // Reconstructs the coverage of the glyph into an Alpha8 mask of `size`. The `transform`
+    // maps from the glyph's reference pixels, with their origin on the baseline, to the mask.
+    [[nodiscard]] QImage render(const QSize &size, const QTransform &transform) const;
+
+private:
+    [[nodiscard]] qreal sample(const QPointF &position) const noexcept;
+
+    QImage  m_image;
+    QPointF m_origin;
+    qreal   m_advance = 0;
+    qreal   m_ascent = 0;
+    qreal   m_descent = 0;
+};
+
+// Releases the distance fields generated so far, and returns the number of bytes released.
+qint64 trimDistanceFields();
+
+} // namespace IconFonts::Private
+
+#endif // ICONFONTS_DISTANCEFIELD_P_H
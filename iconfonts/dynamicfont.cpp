@@ -0,0 +1,293 @@
+#include "dynamicfont_p.h"
+#include "iconfonts_p.h"
+#include "metadataparser_p.h"
+#include "opentypereader_p.h"
+
+#include <QFileInfo>
+#include <QFontDatabase>
+#include <QMutex>
+
+#include <array>
+#include <atomic>
+#include <memory>
+
+namespace IconFonts {
+
+using namespace Private;
+using namespace Qt::StringLiterals;
+
+namespace Private {
+namespace {
+
+class FontRegistry
+{
+public:
+    [[nodiscard]] static FontRegistry &instance()
+    {
+        static auto s_registry = FontRegistry{};
+        return s_registry;
+    }
+
+    [[nodiscard]] FontInfo add(FontId fontId, SymbolTable &&symbols, const DynamicFontOptions &options)
+    {
+        const auto lock = QMutexLocker{&m_mutex};
+
+        // dynamic fonts share the tag space with the built-in fonts, and continue right after them
+        const auto index = static_cast<quint32>(FontInfo::knownFonts().size())
+                + static_cast<quint32>(m_fonts.size()) + 1;
+
+        if (Q_UNLIKELY(index > FontTag::maximum())) {
+            qCWarning(lcIconFonts, "Cannot register more than %u icon fonts", FontTag::maximum());
+            return {};
+        }
+
+        const auto tag = FontTag::fromValue(index << FontTag::shift());
+        const auto &font = m_fonts.emplace_back(std::make_unique<RuntimeFont>(tag, fontId, std::move(symbols), options));
+        m_fontsByTag[index].store(font.get(), std::memory_order_release);
+
+        return font->fontInfo();
+    }
+
+    [[nodiscard]] const RuntimeFont *find(FontTag tag) const noexcept
+    {
+        return m_fontsByTag[tag.index()].load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]] QList<FontInfo> fonts()
+    {
+        const auto lock = QMutexLocker{&m_mutex};
+
+        auto fontList = QList<FontInfo>{};
+        fontList.reserve(static_cast<qsizetype>(m_fonts.size()));
+
+        for (const auto &font : m_fonts)
+            fontList.emplaceBack(font->fontInfo());
+
+        return fontList;
+    }
+
+private:
+    FontRegistry() = default;
+    Q_DISABLE_COPY_MOVE(FontRegistry)
+
+    QMutex m_mutex;
+
+    // fonts never get released: just like built-in fonts, FontInfo refers to them by plain pointer
+    std::vector<std::unique_ptr<RuntimeFont>> m_fonts;
+    std::array<std::atomic<const RuntimeFont *>, FontTag::maximum() + 1> m_fontsByTag = {};
+};
+
+[[nodiscard]] DynamicFontOptions::Format guessFormat(const QString &infoFileName)
+{
+    const auto fileName = QFileInfo{infoFileName}.fileName();
+
+    if (fileName.endsWith(".css"_L1))
+        return DynamicFontOptions::Format::Css;
+    if (fileName.endsWith(".codepoints"_L1))
+        return DynamicFontOptions::Format::Codepoints;
+    if (fileName == "selection.json"_L1)
+        return DynamicFontOptions::Format::IcoMoon;
+    if (fileName.endsWith(".json"_L1) || fileName.endsWith(".js"_L1))
+        return DynamicFontOptions::Format::Mapping;
+    if (fileName.endsWith(".otf"_L1) || fileName.endsWith(".ttf"_L1))
+        return DynamicFontOptions::Format::GlyphNames;
+
+    return DynamicFontOptions::Format::Automatic;
+}
+
+[[nodiscard]] SymbolTable parseSymbols(QByteArrayView info, const DynamicFontOptions &options)
+{
+    auto symbols = SymbolTableBuilder{};
+    auto succeeded = false;
+
+    switch (options.format) {
+    case DynamicFontOptions::Format::Automatic:
+        qCWarning(lcIconFonts, "Cannot detect format of the icon font's metadata");
+        return {};
+
+    case DynamicFontOptions::Format::Codepoints:
+        succeeded = parseCodepoints(info, symbols);
+        break;
+
+    case DynamicFontOptions::Format::Css:
+        succeeded = parseCss(info, options.prefix.toUtf8(), options.suffix.toUtf8(), symbols);
+        break;
+
+    case DynamicFontOptions::Format::IcoMoon:
+        succeeded = parseIcoMoonSelection(info, symbols);
+        break;
+
+    case DynamicFontOptions::Format::Mapping:
+        succeeded = parseMapping(info, options.mapping.toUtf8(), symbols);
+        break;
+
+    case DynamicFontOptions::Format::GlyphNames:
+        succeeded = parseOpenType(info, symbols);
+        break;
+    }
+
+    if (Q_UNLIKELY(!succeeded))
+        return {};
+
+    auto table = symbols.build();
+
+    if (Q_UNLIKELY(table.isNull()))
+        qCWarning(lcIconFonts, "No symbols found in the icon font's metadata");
+
+    return table;
+}
+
+} // namespace
+
+// RuntimeFont class // ================================================================================================
+
+RuntimeFont::RuntimeFont(FontTag tag, FontId fontId, SymbolTable &&symbols, const DynamicFontOptions &options)
+    : m_data{this, tag}
+    , m_fontId{fontId}
+    , m_font{loadApplicationFont(fontId)}
+    , m_fontName{options.fontName}
+    , m_licenseFileName{options.licenseFileName}
+    , m_symbols{std::move(symbols)}
+{
+    if (m_fontName.isEmpty())
+        m_fontName = m_font.family();
+}
+
+QString RuntimeFont::licenseText() const
+{
+    if (m_licenseFileName.isEmpty())
+        return {};
+
+    return readText(m_licenseFileName);
+}
+
+FontInfo RuntimeFont::registerFont(FontId fontId, SymbolTable &&symbols, const DynamicFontOptions &options)
+{
+    if (const auto font = FontRegistry::instance().add(fontId, std::move(symbols), options); Q_LIKELY(font.isValid())) {
+        qCDebug(lcIconFonts, "%ls is available via font id %d and %d symbols",
+                qUtf16Printable(font.fontName()), font.fontId().value, font.symbolCount());
+
+        return font;
+    }
+
+    QFontDatabase::removeApplicationFont(fontId);
+    return {};
+}
+
+QList<FontInfo> RuntimeFont::registeredFonts()
+{
+    return FontRegistry::instance().fonts();
+}
+
+FontInfo RuntimeFont::fromTag(FontTag tag)
+{
+    if (const auto font = FontRegistry::instance().find(tag))
+        return font->fontInfo();
+
+    return {};
+}
+
+} // namespace Private
+
+// FontInfo::Data struct // ============================================================================================
+
+FontInfo::Data::Data(const RuntimeFont *runtimeFont, FontTag fontTag)
+    : type{Type::Application}
+    , fontTag{fontTag}
+    , fontId{[](const Data &d) { return d.runtimeFont->fontId(); }}
+    , fontName{[](const Data &d) { return d.runtimeFont->fontName(); }}
+    , fontFamily{[](const Data &d) { return d.runtimeFont->fontFamily(); }}
+    , licenseFileName{[](const Data &d) { return d.runtimeFont->licenseFileName(); }}
+    , licenseText{[](const Data &d) { return d.runtimeFont->licenseText(); }}
+    , font{[](const Data &d) { return d.runtimeFont->font(); }}
+    , symbols{[](const Data &d) { return &d.runtimeFont->symbols(); }}
+    , runtimeFont{runtimeFont}
+{}
+
+// DynamicFont class // ================================================================================================
+
+FontInfo DynamicFont::registerFont(const QString &fontFileName, const QString &infoFileName, const Options &options)
+{
+    auto effectiveOptions = options;
+    auto effectiveInfoFileName = infoFileName;
+
+    if (effectiveInfoFileName.isEmpty()) {
+        effectiveInfoFileName = fontFileName;
+
+        if (effectiveOptions.format == Format::Automatic)
+            effectiveOptions.format = Format::GlyphNames;
+    }
+
+    if (effectiveOptions.format == Format::Automatic)
+        effectiveOptions.format = guessFormat(effectiveInfoFileName);
+
+    auto infoFile = QFile{effectiveInfoFileName};
+
+    if (Q_UNLIKELY(!infoFile.open(QFile::ReadOnly))) {
+        qCWarning(lcIconFonts, R"(Cannot read from "%ls": %ls)",
+                  qUtf16Printable(infoFile.fileName()),
+                  qUtf16Printable(infoFile.errorString()));
+
+        return {};
+    }
+
+    // avoid copying the metadata or font, which can be several megabytes in size
+    auto info = QByteArray{};
+    auto infoView = QByteArrayView{};
+
+    if (const auto size = infoFile.size(); size > 0) {
+        if (const auto mapped = infoFile.map(0, size)) {
+            infoView = QByteArrayView{mapped, size};
+        } else {
+            info = infoFile.readAll();
+            infoView = info;
+        }
+    }
+
+    auto symbols = parseSymbols(infoView, effectiveOptions);
+
+    if (Q_UNLIKELY(symbols.isNull())) {
+        qCWarning(lcIconFonts, R"(Cannot read symbols from "%ls")", qUtf16Printable(effectiveInfoFileName));
+        return {};
+    }
+
+    const auto fontId = FontId{QFontDatabase::addApplicationFont(fontFileName)};
+
+    if (Q_UNLIKELY(!fontId.isValid())) {
+        qCWarning(lcIconFonts, R"(Cannot load font from "%ls")", qUtf16Printable(fontFileName));
+        return {};
+    }
+
+    return RuntimeFont::registerFont(fontId, std::move(symbols), effectiveOptions);
+}
+
+FontInfo DynamicFont::registerFont(const QByteArray &fontData, QByteArrayView info, const Options &options)
+{
+    auto effectiveOptions = options;
+
+    if (info.isEmpty() && effectiveOptions.format == Format::Automatic)
+        effectiveOptions.format = Format::GlyphNames;
+
+    const auto symbolSource = (effectiveOptions.format == Format::GlyphNames && info.isEmpty()
+                               ? QByteArrayView{fontData} : info);
+    auto symbols = parseSymbols(symbolSource, effectiveOptions);
+
+    if (Q_UNLIKELY(symbols.isNull()))
+        return {};
+
+    const auto fontId = FontId{QFontDatabase::addApplicationFontFromData(fontData)};
+
+    if (Q_UNLIKELY(!fontId.isValid())) {
+        qCWarning(lcIconFonts, "Cannot load font from memory");
+        return {};
+    }
+
+    return RuntimeFont::registerFont(fontId, std::move(symbols), effectiveOptions);
+}
+
+QList<FontInfo> DynamicFont::registeredFonts()
+{
+    return RuntimeFont::registeredFonts();
+}
+
+} // namespace IconFonts
@@ -0,0 +1,58 @@
+#ifndef ICONFONTS_DYNAMICFONT_H
+#define ICONFONTS_DYNAMICFONT_H
+
+#include "iconfonts.h"
+
+namespace IconFonts {
+
+// DynamicFontOptions struct // ========================================================================================
+
+struct ICONFONTS_EXPORT DynamicFontOptions
+{
+    Q_GADGET
+
+public:
+    enum class Format {
+        Automatic,      // guessed from the info file's name, like iconfonts_add_font() does
+        Codepoints,
+        Css,
+        IcoMoon,
+        Mapping,
+        GlyphNames,     // read from the font's character map and glyph names
+    };
+
+    Q_ENUM(Format)
+
+    Format  format = Format::Automatic;
+    QString fontName = {};          // defaults to the font's family name
+    QString licenseFileName = {};
+    QString prefix = {};            // selector prefix for CSS, e.g. ".ti-"
+    QString suffix = {};            // selector suffix for CSS
+    QString mapping = {};           // variable holding the mapping in JavaScript files
+};
+
+// DynamicFont class // ================================================================================================
+
+// Registers icon fonts at runtime, without generating a symbol enumeration at build time.
+// The returned FontInfo behaves like the one of any built-in font, symbols of dynamic fonts
+// can be constructed from their SymbolTag, and therefore also are usable from QML.
+class ICONFONTS_EXPORT DynamicFont final
+{
+public:
+    using Format = DynamicFontOptions::Format;
+    using Options = DynamicFontOptions;
+
+    DynamicFont() = delete;
+
+    // without info file the symbols are read from the font's character map and glyph names
+    [[nodiscard]] static FontInfo registerFont(const QString &fontFileName, const QString &infoFileName = {},
+                                               const Options &options = {});
+    [[nodiscard]] static FontInfo registerFont(const QByteArray &fontData, QByteArrayView info,
+                                               const Options &options);
+
+    [[nodiscard]] static QList<FontInfo> registeredFonts();
+};
+
+} // namespace IconFonts
+
+#endif // ICONFONTS_DYNAMICFONT_H
@@ -0,0 +1,43 @@
+#ifndef ICONFONTS_DYNAMICFONT_P_H
+#define ICONFONTS_DYNAMICFONT_P_H
+
+#include "dynamicfont.h"
+#include "symboltable_p.h"
+
+namespace IconFonts::Private {
+
+// RuntimeFont class // ================================================================================================
+
+class RuntimeFont final
+{
+public:
+    RuntimeFont(FontTag tag, FontId fontId, SymbolTable &&symbols, const DynamicFontOptions &options);
+    Q_DISABLE_COPY_MOVE(RuntimeFont)
+
+    [[nodiscard]] FontInfo fontInfo() const noexcept { return FontInfo{&m_data}; }
+    [[nodiscard]] const SymbolTable &symbols() const noexcept { return m_symbols; }
+
+    [[nodiscard]] FontId fontId() const noexcept { return m_fontId; }
+    [[nodiscard]] QString fontName() const { return m_fontName; }
+    [[nodiscard]] QString fontFamily() const { return m_font.family(); }
+    [[nodiscard]] QString licenseFileName() const { return m_licenseFileName; }
+    [[nodiscard]] QString licenseText() const;
+    [[nodiscard]] QFont font() const { return m_font; }
+
+    [[nodiscard]] static FontInfo registerFont(FontId fontId, SymbolTable &&symbols,
+                                               const DynamicFontOptions &options);
+    [[nodiscard]] static QList<FontInfo> registeredFonts();
+    [[nodiscard]] static FontInfo fromTag(FontTag tag);
+
+private:
+    FontInfo::Data m_data;
+    FontId         m_fontId;
+    QFont          m_font;
+    QString        m_fontName;
+    QString        m_licenseFileName;
+    SymbolTable    m_symbols;
+};
+
+} // namespace IconFonts::Private
+
+#endif // ICONFONTS_DYNAMICFONT_P_H
@@ -0,0 +1,215 @@
+#include "glyphcoverage.h"
+#include "iconfonts_p.h"
+#include "opentypereader_p.h"
+
+#include <QRawFont>
+
+#include <bit>
+#include <functional>
+
+namespace IconFonts {
+
+using namespace Private;
+
+namespace Private {
+namespace {
+
+[[nodiscard]] GlyphCoverage readCoverage(const FontInfo &font)
+{
+    if (Q_UNLIKELY(!font.isAvailable()))
+        return {};
+
+    // QRawFont also provides the tables of system fonts, which are not bundled as resource
+    const auto cmap = QRawFont::fromFont(font.font()).fontTable("cmap");
+
+    if (Q_UNLIKELY(cmap.isEmpty())) {
+        qCWarning(lcIconFonts, "Cannot read the character map of %ls", qUtf16Printable(font.fontName()));
+        return {};
+    }
+
+    return GlyphCoverage::fromCharacterMap(cmap);
+}
+
+} // namespace
+} // namespace Private
+
+// GlyphCoverage class // ==============================================================================================
+
+GlyphCoverage::GlyphCoverage(std::span<const char32_t> codepoints)
+{
+    for (const auto unicode : codepoints)
+        insert(unicode);
+}
+
+qsizetype GlyphCoverage::count() const noexcept
+{
+    auto count = qsizetype{0};
+
+    for (const auto &page : m_pages) {
+        for (const auto word : page)
+            count += std::popcount(word);
+    }
+
+    return count;
+}
+
+GlyphCoverage GlyphCoverage::fromCharacterMap(QByteArrayView cmap)
+{
+    auto coverage = GlyphCoverage{};
+
+    for (const auto &mapping : OpenTypeReader::readCharacterMap(cmap))
+        coverage.insert(mapping.unicode);
+
+    return coverage;
+}
+
+template<typename Operation>
+GlyphCoverage GlyphCoverage::combine(const GlyphCoverage &lhs, const GlyphCoverage &rhs, Operation operation)
+{
+    auto result = GlyphCoverage{};
+
+    if (lhs.m_pageIndex.empty() && rhs.m_pageIndex.empty())
+        return result;
+
+    for (auto pageNumber = std::size_t{0}; pageNumber < PageCount; ++pageNumber) {
+        const auto &lhsPage = lhs.page(pageNumber);
+        const auto &rhsPage = rhs.page(pageNumber);
+
+        // a plain loop over whole words, which compilers turn into vector instructions
+        auto combined = Page{};
+
+        for (auto i = std::size_t{0}; i < combined.size(); ++i)
+            combined[i] = operation(lhsPage[i], rhsPage[i]);
+
+        if (combined != Page{})
+            result.detachPage(pageNumber) = combined;
+    }
+
+    return result;
+}
+
+GlyphCoverage operator|(const GlyphCoverage &lhs, const GlyphCoverage &rhs)
+{
+    return GlyphCoverage::combine(lhs, rhs, std::bit_or<GlyphCoverage::Word>{});
+}
+
+GlyphCoverage operator&(const GlyphCoverage &lhs, const GlyphCoverage &rhs)
+{
+    return GlyphCoverage::combine(lhs, rhs, std::bit_and<GlyphCoverage::Word>{});
+}
+
+GlyphCoverage operator-(const GlyphCoverage &lhs, const GlyphCoverage &rhs)
+{
+    return GlyphCoverage::combine(lhs, rhs, [](GlyphCoverage::Word lhsWord, GlyphCoverage::Word rhsWord) {
+        return lhsWord & ~rhsWord;
+    });
+}
+
+bool operator==(const GlyphCoverage &lhs, const GlyphCoverage &rhs) noexcept
+{
+    for (auto pageNumber = std::size_t{0}; pageNumber < GlyphCoverage::PageCount; ++pageNumber) {
+        if (lhs.page(pageNumber) != rhs.page(pageNumber))
+            return false;
+    }
+
+    return true;
+}
+
+const GlyphCoverage::Page &GlyphCoverage::page(std::size_t pageNumber) const noexcept
+{
+    static constexpr auto s_emptyPage = Page{};
+
+    if (m_pageIndex.empty())
+        return s_emptyPage;
+
+    return m_pages[m_pageIndex[pageNumber]];
+}
+
+GlyphCoverage::Page &GlyphCoverage::detachPage(std::size_t pageNumber)
+{
+    if (m_pageIndex.empty()) {
+        m_pageIndex.resize(PageCount);
+        m_pages.resize(1);
+    }
+
+    auto &index = m_pageIndex[pageNumber];
+
+    if (index == 0) {
+        index = static_cast<quint16>(m_pages.size());
+        m_pages.emplace_back();
+    }
+
+    return m_pages[index];
+}
+
+void GlyphCoverage::insert(char32_t unicode)
+{
+    if (Q_UNLIKELY(unicode > MaximumUnicode))
+        return;
+
+    auto &page = detachPage(unicode >> PageShift);
+    page[(unicode & PageMask) / WordBits] |= Word{1} << (unicode % WordBits);
+}
+
+// FallbackChain class // ==============================================================================================
+
+FallbackChain::FallbackChain(const QList<FontInfo> &fonts)
+    : m_fonts{fonts}
+{
+    m_coverages.reserve(static_cast<std::size_t>(m_fonts.size()));
+
+    for (const auto &font : m_fonts)
+        m_coverages.emplace_back(&font.coverage());
+}
+
+FontInfo FallbackChain::fontFor(char32_t unicode) const
+{
+    for (auto i = std::size_t{0}; i < m_coverages.size(); ++i) {
+        if (m_coverages[i]->contains(unicode))
+            return m_fonts[static_cast<qsizetype>(i)];
+    }
+
+    return {};
+}
+
+Symbol FallbackChain::resolve(const Symbol &symbol) const
+{
+    if (Q_UNLIKELY(symbol.isNull()))
+        return symbol;
+    if (symbol.fontInfo().hasGlyph(symbol.unicode()))
+        return symbol;
+    if (const auto font = fontFor(symbol.unicode()); !font.isNull())
+        return {font, symbol.unicode()};
+
+    return symbol;
+}
+
+GlyphCoverage FallbackChain::coverage() const
+{
+    auto coverage = GlyphCoverage{};
+
+    for (const auto fontCoverage : m_coverages)
+        coverage |= *fontCoverage;
+
+    return coverage;
+}
+
+// FontInfo class // ===================================================================================================
+
+const GlyphCoverage &FontInfo::coverage() const
+{
+    static const auto s_emptyCoverage = GlyphCoverage{};
+
+    if (Q_UNLIKELY(isNull()))
+        return s_emptyCoverage;
+
+    static auto s_cache = FontTagCache<GlyphCoverage>{};
+    return s_cache.find(tag(), [this] { return readCoverage(*this); });
+}
+
+bool FontInfo::hasGlyph(char32_t unicode) const
+{
+    return coverage().contains(unicode);
+}
+
+} // namespace IconFonts
@@ -0,0 +1,104 @@
+#ifndef ICONFONTS_GLYPHCOVERAGE_H
+#define ICONFONTS_GLYPHCOVERAGE_H
+
+#include "iconfonts.h"
+
+#include <array>
+#include <span>
+#include <vector>
+
+namespace IconFonts {
+
+// GlyphCoverage class // ==============================================================================================
+
+// A set of codepoints, usually those a font has glyphs for, as read from its character map.
+// Codepoints are grouped into pages of 256 bits, and only pages containing codepoints get allocated,
+// so that lookups take constant time, and set operations run over a few machine words per page.
+class ICONFONTS_EXPORT GlyphCoverage final
+{
+public:
+    static constexpr char32_t MaximumUnicode = 0x10ffff;
+
+    GlyphCoverage() noexcept = default;
+    explicit GlyphCoverage(std::span<const char32_t> codepoints);
+
+    [[nodiscard]] bool contains(char32_t unicode) const noexcept
+    {
+        if (Q_UNLIKELY(unicode > MaximumUnicode || m_pageIndex.empty()))
+            return false;
+
+        const auto &page = m_pages[m_pageIndex[unicode >> PageShift]];
+        return (page[(unicode & PageMask) / WordBits] >> (unicode % WordBits)) & 1;
+    }
+
+    [[nodiscard]] bool isEmpty() const noexcept { return m_pages.size() <= 1; }
+    [[nodiscard]] qsizetype count() const noexcept;
+
+    // reads the best Unicode subtable of an OpenType `cmap` table
+    [[nodiscard]] static GlyphCoverage fromCharacterMap(QByteArrayView cmap);
+
+    GlyphCoverage &operator|=(const GlyphCoverage &other) { return *this = *this | other; }
+    GlyphCoverage &operator&=(const GlyphCoverage &other) { return *this = *this & other; }
+    GlyphCoverage &operator-=(const GlyphCoverage &other) { return *this = *this - other; }
+
+    friend ICONFONTS_EXPORT GlyphCoverage operator|(const GlyphCoverage &lhs, const GlyphCoverage &rhs);
+    friend ICONFONTS_EXPORT GlyphCoverage operator&(const GlyphCoverage &lhs, const GlyphCoverage &rhs);
+    friend ICONFONTS_EXPORT GlyphCoverage operator-(const GlyphCoverage &lhs, const GlyphCoverage &rhs);
+    friend ICONFONTS_EXPORT bool operator==(const GlyphCoverage &lhs, const GlyphCoverage &rhs) noexcept;
+
+private:
+    using Word = quint64;
+
+    static constexpr std::size_t WordBits  = 64;
+    static constexpr std::size_t PageShift = 8;
+    static constexpr std::size_t PageSize  = 1 << PageShift;
+    static constexpr char32_t    PageMask  = PageSize - 1;
+    static constexpr std::size_t PageCount = (MaximumUnicode >> PageShift) + 1;
+
+    using Page = std::array<Word, PageSize / WordBits>;
+
+    template<typename Operation>
+    [[nodiscard]] static GlyphCoverage combine(const GlyphCoverage &lhs, const GlyphCoverage &rhs,
+                                               Operation operation);
+
+    [[nodiscard]] const Page &page(std::size_t pageNumber) const noexcept;
+    [[nodiscard]] Page &detachPage(std::size_t pageNumber);
+    void insert(char32_t unicode);
+
+    std::vector<quint16> m_pageIndex;   // empty, or `PageCount` indexes into `m_pages`
+    std::vector<Page>    m_pages;       // the first page is empty, and shared by all unused pages
+};
+
+// FallbackChain class // ==============================================================================================
+
+// Resolves codepoints to the first font in a list of fonts that actually has a glyph for them,
+// e.g. to draw a symbol that is missing in one variant of a font family from one of its other variants.
+// Only the character maps of the fonts are consulted, the font engine never gets probed for glyphs.
+class ICONFONTS_EXPORT FallbackChain final
+{
+public:
+    FallbackChain() noexcept = default;
+    FallbackChain(std::initializer_list<FontInfo> fonts) : FallbackChain(QList<FontInfo>{fonts}) {}
+    explicit FallbackChain(const QList<FontInfo> &fonts);
+
+    [[nodiscard]] QList<FontInfo> fonts() const { return m_fonts; }
+    [[nodiscard]] bool isEmpty() const noexcept { return m_fonts.isEmpty(); }
+
+    // the first font of the chain with a glyph for `unicode`, or an invalid FontInfo
+    [[nodiscard]] FontInfo fontFor(char32_t unicode) const;
+
+    // keeps `symbol` if its own font has a glyph for it, otherwise tries the fonts of this chain;
+    // returns `symbol` unchanged if none of the fonts has a glyph for it
+    [[nodiscard]] Symbol resolve(const Symbol &symbol) const;
+
+    // all the codepoints for which this chain can provide a glyph
+    [[nodiscard]] GlyphCoverage coverage() const;
+
+private:
+    QList<FontInfo>                     m_fonts;
+    std::vector<const GlyphCoverage *>  m_coverages;
+};
+
+} // namespace IconFonts
+
+#endif // ICONFONTS_GLYPHCOVERAGE_H
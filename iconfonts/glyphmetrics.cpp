@@ -0,0 +1,119 @@
+#include "iconfonts_p.h"
+
+#include <QRawFont>
+
+#include <algorithm>
+
+namespace IconFonts {
+
+using namespace Private;
+
+namespace Private {
+namespace {
+
+// The metrics of all symbols of a font in design units, sorted by codepoint.
+class MetricsTable
+{
+public:
+    explicit MetricsTable(const FontInfo &font);
+
+    [[nodiscard]] GlyphMetrics metrics(char32_t unicode, qreal pixelSize) const;
+
+private:
+    struct Entry
+    {
+        char32_t unicode;
+        float    advance;
+        float    left;
+        float    top;
+        float    width;
+        float    height;
+    };
+
+    std::vector<Entry> m_entries;
+    int m_unitsPerEm = 0;
+};
+
+MetricsTable::MetricsTable(const FontInfo &font)
+{
+    if (Q_UNLIKELY(!font.isAvailable()))
+        return;
+
+    auto rawFont = QRawFont::fromFont(font.font());
+
+    if (Q_UNLIKELY(!rawFont.isValid())) {
+        qCWarning(lcIconFonts, "Cannot read the glyph metrics of %ls", qUtf16Printable(font.fontName()));
+        return;
+    }
+
+    // at this size the font engine reports all metrics in design units
+    m_unitsPerEm = qRound(rawFont.unitsPerEm());
+    rawFont.setPixelSize(m_unitsPerEm);
+
+    auto codepoints = std::vector<char32_t>{};
+    codepoints.reserve(static_cast<std::size_t>(font.symbolCount()));
+
+    for (auto count = font.symbolCount(), i = 0; i < count; ++i)
+        codepoints.emplace_back(font.unicode(i));
+
+    std::ranges::sort(codepoints);
+    const auto duplicates = std::ranges::unique(codepoints);
+    codepoints.erase(duplicates.begin(), duplicates.end());
+
+    const auto text = QString::fromUcs4(codepoints.data(), static_cast<qsizetype>(codepoints.size()));
+    const auto glyphs = rawFont.glyphIndexesForString(text);
+    const auto advances = rawFont.advancesForGlyphIndexes(glyphs);
+
+    if (Q_UNLIKELY(glyphs.size() != static_cast<qsizetype>(codepoints.size()) || advances.size() != glyphs.size())) {
+        qCWarning(lcIconFonts, "Unexpected number of glyphs in %ls", qUtf16Printable(font.fontName()));
+        return;
+    }
+
+    m_entries.reserve(codepoints.size());
+
+    for (auto i = qsizetype{0}; i < glyphs.size(); ++i) {
+        if (glyphs[i] == 0) // the font has no glyph for this symbol
+            continue;
+
+        const auto bounds = rawFont.boundingRect(glyphs[i]);
+
+        m_entries.emplace_back(codepoints[static_cast<std::size_t>(i)],
+                               static_cast<float>(advances[i].x()),
+                               static_cast<float>(bounds.left()),
+                               static_cast<float>(bounds.top()),
+                               static_cast<float>(bounds.width()),
+                               static_cast<float>(bounds.height()));
+    }
+}
+
+GlyphMetrics MetricsTable::metrics(char32_t unicode, qreal pixelSize) const
+{
+    const auto it = std::ranges::lower_bound(m_entries, unicode, {}, &Entry::unicode);
+
+    if (it == m_entries.end() || it->unicode != unicode)
+        return {};
+
+    const auto scale = pixelSize / m_unitsPerEm;
+
+    return {
+        .advance = it->advance * scale,
+        .boundingRect = {it->left * scale, it->top * scale, it->width * scale, it->height * scale},
+    };
+}
+
+} // namespace
+} // namespace Private
+
+// FontInfo class // ===================================================================================================
+
+GlyphMetrics FontInfo::metrics(char32_t unicode, qreal pixelSize) const
+{
+    if (Q_UNLIKELY(isNull()))
+        return {};
+
+    static auto s_cache = FontTagCache<MetricsTable>{};
+    const auto &table = s_cache.find(tag(), [this] { return MetricsTable{*this}; });
+    return table.metrics(unicode, pixelSize);
+}
+
+} // namespace IconFonts
@@ -0,0 +1,210 @@
+#include "glyphoutlines_p.h"
+#include "iconfonts_p.h"
+
+#include <QResource>
+#include <QtEndian>
+
+namespace IconFonts {
+
+namespace Private {
+namespace {
+
+constexpr auto HeaderSize = 4 * sizeof(quint32) + 4 * sizeof(qint16);
+
+[[nodiscard]] quint32 readUInt32(const char *table, quint32 index) noexcept
+{
+    return qFromLittleEndian<quint32>(table + sizeof(quint32) * index);
+}
+
+[[nodiscard]] quint16 readUInt16(const char *table, quint32 index) noexcept
+{
+    return qFromLittleEndian<quint16>(table + sizeof(quint16) * index);
+}
+
+[[nodiscard]] qint16 readInt16(const char *table, quint32 index) noexcept
+{
+    return qFromLittleEndian<qint16>(table + sizeof(qint16) * index);
+}
+
+} // namespace
+
+// GlyphOutlines class // ==============================================================================================
+
+GlyphOutlines GlyphOutlines::fromData(const QByteArray &data)
+{
+    if (Q_UNLIKELY(static_cast<std::size_t>(data.size()) < HeaderSize)) {
+        qCWarning(lcIconFonts, "Glyph outlines are truncated");
+        return {};
+    }
+
+    const auto header = data.constData();
+    const auto magic = readUInt32(header, 0);
+    const auto version = readUInt32(header, 1);
+    const auto count = readUInt32(header, 2);
+    const auto commandCount = readUInt32(header, 3);
+
+    if (Q_UNLIKELY(magic != Magic || version != Version)) {
+        qCWarning(lcIconFonts, "Unsupported glyph outlines (magic: 0x%08x, version: %u)", magic, version);
+        return {};
+    }
+
+    const auto expectedSize = HeaderSize
+            + sizeof(quint32) * std::size_t{count}          // unicodes
+            + sizeof(quint32) * (std::size_t{count} + 1)    // offsets
+            + sizeof(quint16) * std::size_t{count}          // advances
+            + sizeof(qint16) * std::size_t{commandCount};   // commands
+
+    if (Q_UNLIKELY(static_cast<std::size_t>(data.size()) != expectedSize)) {
+        qCWarning(lcIconFonts, "Glyph outlines are corrupted (expected size: %zu, actual size: %lld)",
+                  expectedSize, static_cast<qlonglong>(data.size()));
+        return {};
+    }
+
+    auto outlines = GlyphOutlines{};
+
+    outlines.m_data = data;
+    outlines.m_count = count;
+    outlines.m_commandCount = commandCount;
+    outlines.m_unitsPerEm = readInt16(header + 4 * sizeof(quint32), 0);
+    outlines.m_ascender = readInt16(header + 4 * sizeof(quint32), 1);
+    outlines.m_descender = readInt16(header + 4 * sizeof(quint32), 2);
+    outlines.m_unicodes = header + HeaderSize;
+    outlines.m_offsets = outlines.m_unicodes + sizeof(quint32) * count;
+    outlines.m_advances = outlines.m_offsets + sizeof(quint32) * (count + 1);
+    outlines.m_commands = outlines.m_advances + sizeof(quint16) * count;
+
+    if (Q_UNLIKELY(outlines.m_unitsPerEm <= 0)) {
+        qCWarning(lcIconFonts, "Glyph outlines have invalid units per em: %d", outlines.m_unitsPerEm);
+        return {};
+    }
+
+    return outlines;
+}
+
+GlyphOutlines GlyphOutlines::fromResource(const QString &fileName)
+{
+    const auto resource = QResource{fileName};
+
+    if (Q_UNLIKELY(!resource.isValid())) {
+        qCWarning(lcIconFonts, R"(Cannot find glyph outlines at "%ls")", qUtf16Printable(fileName));
+        return {};
+    }
+
+    // only copies if the resource is compressed
+    return fromData(resource.uncompressedData());
+}
+
+QPainterPath GlyphOutlines::path(char32_t unicode, qreal pixelSize) const
+{
+    const auto index = indexOf(unicode);
+
+    if (index < 0)
+        return {};
+
+    const auto scale = pixelSize / m_unitsPerEm;
+    const auto first = readUInt32(m_offsets, static_cast<quint32>(index));
+    const auto last = std::min(readUInt32(m_offsets, static_cast<quint32>(index) + 1), m_commandCount);
+
+    auto position = first;
+
+    // design units have y pointing up, QPainterPath has it pointing down
+    const auto readPoint = [this, scale, last, &position](QPointF &point) {
+        if (Q_UNLIKELY(position + 2 > last))
+            return false;
+
+        point = {readInt16(m_commands, position) * scale, -readInt16(m_commands, position + 1) * scale};
+        position += 2;
+        return true;
+    };
+
+    auto path = QPainterPath{};
+    path.setFillRule(Qt::WindingFill); // like font rasterizers, overlapping contours must not punch holes
+
+    auto p1 = QPointF{};
+    auto p2 = QPointF{};
+    auto p3 = QPointF{};
+
+    while (position < last) {
+        switch (static_cast<Command>(readInt16(m_commands, position++))) {
+        case Command::MoveTo:
+            if (!readPoint(p1))
+                return path;
+
+            path.moveTo(p1);
+            break;
+
+        case Command::LineTo:
+            if (!readPoint(p1))
+                return path;
+
+            path.lineTo(p1);
+            break;
+
+        case Command::QuadTo:
+            if (!readPoint(p1) || !readPoint(p2))
+                return path;
+
+            path.quadTo(p1, p2);
+            break;
+
+        case Command::CubicTo:
+            if (!readPoint(p1) || !readPoint(p2) || !readPoint(p3))
+                return path;
+
+            path.cubicTo(p1, p2, p3);
+            break;
+
+        case Command::Close:
+            path.closeSubpath();
+            break;
+
+        default:
+            qCWarning(lcIconFonts, "Unsupported outline command for U+%04X", static_cast<uint>(unicode));
+            return path;
+        }
+    }
+
+    return path;
+}
+
+qreal GlyphOutlines::advance(char32_t unicode, qreal pixelSize) const
+{
+    if (const auto index = indexOf(unicode); index >= 0)
+        return readUInt16(m_advances, static_cast<quint32>(index)) * pixelSize / m_unitsPerEm;
+
+    return 0;
+}
+
+int GlyphOutlines::indexOf(char32_t unicode) const noexcept
+{
+    auto first = quint32{0};
+    auto last = m_count;
+
+    while (first < last) {
+        const auto middle = first + (last - first) / 2;
+
+        if (readUInt32(m_unicodes, middle) < unicode)
+            first = middle + 1;
+        else
+            last = middle;
+    }
+
+    if (first < m_count && readUInt32(m_unicodes, first) == unicode)
+        return static_cast<int>(first);
+
+    return -1;
+}
+
+} // namespace Private
+
+// FontInfo class // ===================================================================================================
+
+QPainterPath FontInfo::outline(char32_t unicode, qreal pixelSize) const
+{
+    if (const auto outlines = glyphOutlines())
+        return outlines->path(unicode, pixelSize);
+
+    return {};
+}
+
+} // namespace IconFonts
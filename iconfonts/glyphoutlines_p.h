@@ -0,0 +1,85 @@
+#ifndef ICONFONTS_GLYPHOUTLINES_P_H
+#define ICONFONTS_GLYPHOUTLINES_P_H
+
+#include "iconfonts.h"
+
+#include <QByteArray>
+#include <QPainterPath>
+
+namespace IconFonts::Private {
+
+// GlyphOutlines class // ==============================================================================================
+
+// The glyph outlines of a font, extracted at build time for fonts added with the OUTLINES option,
+// so that they can be drawn without registering the font with QFontDatabase. Like SymbolTable
+// this is one contiguous blob, which is read in place:
+//
+//   quint32 magic, version, count, commandCount   -- all little endian
+//   qint16  unitsPerEm, ascender, descender, 0
+//   quint32 unicodes[count]                       -- sorted ascending
+//   quint32 offsets[count + 1]                    -- offsets into the command stream, one past the last glyph
+//   quint16 advances[count]
+//   qint16  commands[commandCount]                -- opcodes followed by their coordinates in design units
+//
+class ICONFONTS_EXPORT GlyphOutlines final
+{
+public:
+    static constexpr quint32 Magic   = 0x4f474649; // "IFGO"
+    static constexpr quint32 Version = 1;
+
+    enum class Command : qint16 {
+        MoveTo = 1,     // x, y
+        LineTo,         // x, y
+        QuadTo,         // control point, and end point
+        CubicTo,        // two control points, and end point
+        Close,
+    };
+
+    GlyphOutlines() noexcept = default;
+
+    // does not copy raw data, but keeps a reference on implicitly shared data
+    [[nodiscard]] static GlyphOutlines fromData(const QByteArray &data);
+    [[nodiscard]] static GlyphOutlines fromResource(const QString &fileName);
+
+    [[nodiscard]] bool isNull() const noexcept { return m_count == 0; }
+    [[nodiscard]] int count() const noexcept { return static_cast<int>(m_count); }
+    [[nodiscard]] int unitsPerEm() const noexcept { return m_unitsPerEm; }
+
+    // scaled to `pixelSize`, with the origin on the baseline and y pointing down like QRawFont::pathForGlyph()
+    [[nodiscard]] QPainterPath path(char32_t unicode, qreal pixelSize) const;
+    [[nodiscard]] qreal advance(char32_t unicode, qreal pixelSize) const;
+    [[nodiscard]] qreal ascent(qreal pixelSize) const noexcept { return m_ascender * pixelSize / m_unitsPerEm; }
+    [[nodiscard]] qreal descent(qreal pixelSize) const noexcept { return -m_descender * pixelSize / m_unitsPerEm; }
+
+private:
+    [[nodiscard]] int indexOf(char32_t unicode) const noexcept;
+
+    QByteArray  m_data;
+    quint32     m_count = 0;
+    quint32     m_commandCount = 0;
+    int         m_unitsPerEm = 0;
+    int         m_ascender = 0;
+    int         m_descender = 0;
+    const char *m_unicodes = nullptr;
+    const char *m_offsets = nullptr;
+    const char *m_advances = nullptr;
+    const char *m_commands = nullptr;
+};
+
+// Returns the GlyphOutlines for font `S`, which got extracted at build time into the resource `fileName`.
+template<symbol_enum S>
+[[nodiscard]] const GlyphOutlines *staticGlyphOutlines(const QString &fileName)
+{
+    static const auto s_instance = [&fileName] {
+        if (loadResources<S>())
+            return GlyphOutlines::fromResource(fileName);
+
+        return GlyphOutlines{};
+    }();
+
+    return s_instance.isNull() ? nullptr : &s_instance;
+}
+
+} // namespace IconFonts::Private
+
+#endif // ICONFONTS_GLYPHOUTLINES_P_H
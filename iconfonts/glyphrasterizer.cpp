@@ -0,0 +1,197 @@
+#include "glyphrasterizer_p.h"
+#include "iconfonts_p.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace IconFonts::Private {
+namespace {
+
+// Accumulates the signed area each edge covers right of it into one cell per pixel, so that the prefix sum of a row
+// becomes the winding number weighted by the covered area; its magnitude clamped to one is the non-zero coverage.
+class CoverageAccumulator
+{
+public:
+    explicit CoverageAccumulator(const QSize &size)
+        : m_width{size.width()}
+        , m_height{size.height()}
+        , m_stride{size.width() + 2} // edges at the right border spill into two more cells
+        , m_cells(static_cast<std::size_t>(m_stride) * static_cast<std::size_t>(m_height))
+    {}
+
+    void addPath(const QPainterPath &path, const QTransform &transform);
+    void addLine(QPointF p0, QPointF p1);
+
+    [[nodiscard]] QImage toMask();
+
+private:
+    [[nodiscard]] float *row(int y) noexcept { return &m_cells[static_cast<std::size_t>(y * m_stride)]; }
+    static void addSpan(float *cells, float xBegin, float xEnd, float delta) noexcept;
+
+    int m_width;
+    int m_height;
+    int m_stride;
+
+    std::vector<float> m_cells;
+};
+
+void CoverageAccumulator::addPath(const QPainterPath &path, const QTransform &transform)
+{
+    for (const auto &polygon : path.toSubpathPolygons(transform)) {
+        if (polygon.size() < 2)
+            continue;
+
+        for (auto i = qsizetype{1}; i < polygon.size(); ++i)
+            addLine(polygon[i - 1], polygon[i]);
+
+        addLine(polygon.constLast(), polygon.constFirst()); // fills implicitly close their subpaths
+    }
+}
+
+void CoverageAccumulator::addLine(QPointF p0, QPointF p1)
+{
+    if (p0.y() == p1.y())
+        return;
+
+    auto direction = 1.0f;
+
+    if (p0.y() > p1.y()) {
+        std::swap(p0, p1);
+        direction = -1.0f;
+    }
+
+    const auto x0 = static_cast<float>(p0.x());
+    const auto y0 = static_cast<float>(p0.y());
+    const auto x1 = static_cast<float>(p1.x());
+    const auto y1 = static_cast<float>(p1.y());
+
+    const auto dxdy = (x1 - x0) / (y1 - y0);
+    const auto yBegin = std::max(0, static_cast<int>(std::floor(y0)));
+    const auto yEnd = std::min(m_height, static_cast<int>(std::ceil(y1)));
+    const auto width = static_cast<float>(m_width);
+
+    auto x = y0 < 0 ? x0 - y0 * dxdy : x0;
+
+    for (auto y = yBegin; y < yEnd; ++y) {
+        const auto top = static_cast<float>(y);
+        const auto dy = std::min(top + 1, y1) - std::max(top, y0);
+        const auto xNext = x + dxdy * dy;
+
+        // everything left of the mask still contributes to the winding number of the entire row
+        addSpan(row(y), std::clamp(x, 0.0f, width), std::clamp(xNext, 0.0f, width), dy * direction);
+        x = xNext;
+    }
+}
+
+void CoverageAccumulator::addSpan(float *cells, float xBegin, float xEnd, float delta) noexcept
+{
+    const auto [left, right] = std::minmax(xBegin, xEnd);
+    const auto leftFloor = std::floor(left);
+    const auto leftIndex = static_cast<int>(leftFloor);
+    const auto rightIndex = static_cast<int>(std::ceil(right));
+
+    if (rightIndex <= leftIndex + 1) { // the span stays within one pixel: split at its horizontal center
+        const auto center = (xBegin + xEnd) / 2 - leftFloor;
+        cells[leftIndex] += delta - delta * center;
+        cells[leftIndex + 1] += delta * center;
+        return;
+    }
+
+    // the span crosses multiple pixels: the covered area grows linearly in between, and quadratically at the ends
+    const auto slope = 1 / (right - left);
+    const auto leftFraction = left - leftFloor;
+    const auto rightFraction = right - static_cast<float>(rightIndex) + 1;
+    const auto leftArea = slope * (1 - leftFraction) * (1 - leftFraction) / 2;
+    const auto rightArea = slope * rightFraction * rightFraction / 2;
+
+    cells[leftIndex] += delta * leftArea;
+
+    if (rightIndex == leftIndex + 2) {
+        cells[leftIndex + 1] += delta * (1 - leftArea - rightArea);
+    } else {
+        const auto firstArea = slope * (1.5f - leftFraction);
+        cells[leftIndex + 1] += delta * (firstArea - leftArea);
+
+        for (auto x = leftIndex + 2; x < rightIndex - 1; ++x)
+            cells[x] += delta * slope;
+
+        const auto lastArea = firstArea + static_cast<float>(rightIndex - leftIndex - 3) * slope;
+        cells[rightIndex - 1] += delta * (1 - lastArea - rightArea);
+    }
+
+    cells[rightIndex] += delta * rightArea;
+}
+
+QImage CoverageAccumulator::toMask()
+{
+    auto mask = QImage{m_width, m_height, QImage::Format_Alpha8};
+
+    for (auto y = 0; y < m_height; ++y) {
+        const auto cells = row(y);
+        const auto coverage = mask.scanLine(y);
+
+        // the prefix sum is sequential by nature, but is kept apart from
+        // the conversion into bytes, which the compiler can vectorize
+        auto winding = 0.0f;
+
+        for (auto x = 0; x < m_width; ++x)
+            cells[x] = winding += cells[x];
+
+        for (auto x = 0; x < m_width; ++x)
+            coverage[x] = static_cast<uchar>(std::min(std::abs(cells[x]), 1.0f) * 255 + 0.5f);
+    }
+
+    return mask;
+}
+
+} // namespace
+
+// GlyphRasterizer class // ============================================================================================
+
+bool GlyphRasterizer::supports(const QSize &size) noexcept
+{
+    return !size.isEmpty()
+            && size.width() <= MaximumSize
+            && size.height() <= MaximumSize;
+}
+
+QImage GlyphRasterizer::rasterize(const QPainterPath &path, const QSize &size, const QTransform &transform)
+{
+    if (Q_UNLIKELY(!supports(size))) {
+        qCWarning(lcIconFonts, "Unsupported size for rasterizing glyphs: %dx%d", size.width(), size.height());
+        return {};
+    }
+
+    auto accumulator = CoverageAccumulator{size};
+    accumulator.addPath(path, transform);
+    return accumulator.toMask();
+}
+
+QImage GlyphRasterizer::colorize(const QImage &mask, const QColor &color)
+{
+    Q_ASSERT(mask.format() == QImage::Format_Alpha8);
+
+    const auto premultiplied = qPremultiply(color.rgba());
+    const auto scale = [](uint channel, uint coverage) {
+        return (channel * coverage + 127) / 255;
+    };
+
+    auto image = QImage{mask.size(), QImage::Format_ARGB32_Premultiplied};
+
+    for (auto y = 0; y < mask.height(); ++y) {
+        const auto coverage = mask.constScanLine(y);
+        const auto pixels = reinterpret_cast<QRgb *>(image.scanLine(y));
+
+        for (auto x = 0; x < mask.width(); ++x) {
+            pixels[x] = qRgba(scale(qRed(premultiplied), coverage[x]),
+                              scale(qGreen(premultiplied), coverage[x]),
+                              scale(qBlue(premultiplied), coverage[x]),
+                              scale(qAlpha(premultiplied), coverage[x]));
+        }
+    }
+
+    return image;
+}
+
+} // namespace IconFonts::Private
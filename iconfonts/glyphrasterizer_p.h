@@ -0,0 +1,31 @@
+#ifndef ICONFONTS_GLYPHRASTERIZER_P_H
+#define ICONFONTS_GLYPHRASTERIZER_P_H
+
+#include <QImage>
+#include <QPainterPath>
+#include <QTransform>
+
+namespace IconFonts::Private {
+
+// GlyphRasterizer class // ============================================================================================
+
+// A scanline rasterizer for glyph outlines, which computes the exact area covered in each pixel instead of sampling.
+// It is much cheaper to set up than QPainter's raster engine, but only fills using the non-zero winding rule, and is
+// meant for icon sized masks. All state lives on the stack, so it is safe to rasterize from multiple threads.
+class ICONFONTS_EXPORT GlyphRasterizer final
+{
+public:
+    static constexpr int MaximumSize = 256;
+
+    [[nodiscard]] static bool supports(const QSize &size) noexcept;
+
+    // Rasterizes `path` after mapping it by `transform` into a `Format_Alpha8` mask of `size`.
+    [[nodiscard]] static QImage rasterize(const QPainterPath &path, const QSize &size, const QTransform &transform = {});
+
+    // Turns the coverage `mask` into a `Format_ARGB32_Premultiplied` image filled with `color`.
+    [[nodiscard]] static QImage colorize(const QImage &mask, const QColor &color);
+};
+
+} // namespace IconFonts::Private
+
+#endif // ICONFONTS_GLYPHRASTERIZER_P_H
@@ -1,26 +1,46 @@
 #include "iconfonts_p.h"
+#include "distancefield_p.h"
+#include "dynamicfont_p.h"
+#include "glyphoutlines_p.h"
+#include "glyphrasterizer_p.h"
+#include "rastercache_p.h"
+#include "sharedrastercache_p.h"
+#include "symboltable_p.h"
 
 #include <QAction>
+#include <QCache>
 #include <QFile>
 #include <QFontDatabase>
+#include <QGuiApplication>
+#include <QHash>
 #include <QIconEngine>
 #include <QLoggingCategory>
 #include <QMetaEnum>
+#include <QMutex>
 #include <QPainter>
 #include <QPixmapCache>
+#include <QSet>
+#include <QtMath>
 
+#include <QtGui/private/qfont_p.h>
 #include <QtGui/private/qfontengine_p.h>
 
+#include <deque>
+#include <limits>
+#include <optional>
+#include <vector>
+
 namespace IconFonts {
 
 using namespace Private;
 using namespace Qt::StringLiterals;
 
 namespace Private {
-namespace {
 
 Q_LOGGING_CATEGORY(lcIconFonts, "iconfonts");
 
+namespace {
+
 class FontIconEngine : public QIconEngine
 {
 public:
@@ -37,14 +57,18 @@ public:
 
     bool isNull() override;
 
+    // unlike pixmaps, images can be rasterized from any thread
+    [[nodiscard]] static QImage rasterizeImage(const FontIcon &icon, const QSize &size, QIcon::Mode mode);
+
 private:
+    [[nodiscard]] static QPixmap rasterize(const FontIcon &icon, const QSize &size, QIcon::Mode mode);
+
     ModalFontIcon m_icon;
 };
 
 template<typename T>     [[nodiscard]] QString cacheKey(const T &);
 template<typename ...Ts> [[nodiscard]] QString cacheKey(const Ts &...fields);
 template<typename ...Ts> [[nodiscard]] QString cacheKey(const std::tuple<Ts...> &tuple);
-template<typename ...Ts> [[nodiscard]] QString cacheKey(const std::variant<Ts...> &tuple);
 
 template<typename T> requires std::is_enum_v<T>
 [[nodiscard]] QString cacheKey(const T &value)
@@ -52,18 +76,11 @@ template<typename T> requires std::is_enum_v<T>
     return QString::number(std::to_underlying<T>(value), 36);
 }
 
-template<typename T>
-[[nodiscard]] QString cacheKey(const std::shared_ptr<T> &ptr)
-{
-    return ptr ? cacheKey<T>(*ptr) : u"-"_s;
-}
-
-template<> [[nodiscard]] QString cacheKey(const std::monostate &) { return u"-"_s; }
 template<> [[nodiscard]] QString cacheKey(const qreal &decimal)   { return QString::number(decimal); }
 template<> [[nodiscard]] QString cacheKey(const int &number)      { return QString::number(number, 36); }
+template<> [[nodiscard]] QString cacheKey(const qint64 &number)   { return QString::number(number, 36); }
 template<> [[nodiscard]] QString cacheKey(const char32_t &code)   { return QString::number(code, 36); }
-template<> [[nodiscard]] QString cacheKey(const FontInfo &font)   { return cacheKey(font.enumType().id()); }
-template<> [[nodiscard]] QString cacheKey(const FontIcon &icon)   { return cacheKey(icon.fields()); }
+template<> [[nodiscard]] QString cacheKey(const FontInfo &font)   { return cacheKey(static_cast<int>(font.tag().index())); }
 template<> [[nodiscard]] QString cacheKey(const Symbol &symbol)   { return cacheKey(symbol.fields()); }
 
 template<>
@@ -97,36 +114,299 @@ template<>
                     transform.m31(), transform.m32(), transform.m33());
 }
 
-template<typename ...Ts>
-[[nodiscard]] QString cacheKey(const std::variant<Ts...> &variant)
+template<>
+[[nodiscard]] QString cacheKey(const FontIcon &icon)
+{
+    if (icon.transformType() == FontIcon::Transform::Matrix)
+        return cacheKey(icon.symbol(), icon.color(), icon.transform());
+
+    return cacheKey(icon.symbol(), icon.color(), icon.transformType());
+}
+
+// Tells if `transform` only moves the pixels of an icon rasterized into a box of `size`.
+[[nodiscard]] bool isPixelPermutation(FontIcon::Transform transform, const QSize &size)
+{
+    switch (transform) {
+    case FontIcon::Transform::HorizontalFlip:
+    case FontIcon::Transform::VerticalFlip:
+    case FontIcon::Transform::Rotate180:
+        return true;
+
+    case FontIcon::Transform::Rotate90:
+    case FontIcon::Transform::Rotate270:
+        return size.width() == size.height();
+
+    case FontIcon::Transform::None:
+    case FontIcon::Transform::Matrix:
+        break;
+    }
+
+    return false;
+}
+
+// Moves the pixels of `image` where `transform` would move them when applied around the image's center. The image
+// is processed in tiles, so that the rows read and the columns written by rotations both stay within the CPU cache,
+// and the inner loops only differ in their stride, which lets the compiler vectorize them.
+[[nodiscard]] QImage permuted(QImage image, FontIcon::Transform transform)
+{
+    constexpr auto TileSize = 16;
+
+    image.convertTo(QImage::Format_ARGB32_Premultiplied);
+
+    const auto width = qsizetype{image.width()};
+    const auto height = qsizetype{image.height()};
+    const auto rotated = (transform == FontIcon::Transform::Rotate90 || transform == FontIcon::Transform::Rotate270);
+
+    auto result = QImage{rotated ? image.size().transposed() : image.size(), image.format()};
+    result.setDevicePixelRatio(image.devicePixelRatio());
+
+    const auto stride = result.bytesPerLine() / qsizetype{sizeof(QRgb)};
+
+    // the offset of the pixel at (x, y) in `result` is `origin + x * xStep + y * yStep`
+    auto origin = qsizetype{0};
+    auto xStep = qsizetype{1};
+    auto yStep = stride;
+
+    switch (transform) {
+    case FontIcon::Transform::HorizontalFlip:
+        std::tie(origin, xStep, yStep) = std::tuple{width - 1, -1, stride};
+        break;
+
+    case FontIcon::Transform::VerticalFlip:
+        std::tie(origin, xStep, yStep) = std::tuple{(height - 1) * stride, 1, -stride};
+        break;
+
+    case FontIcon::Transform::Rotate90:
+        std::tie(origin, xStep, yStep) = std::tuple{height - 1, stride, -1};
+        break;
+
+    case FontIcon::Transform::Rotate180:
+        std::tie(origin, xStep, yStep) = std::tuple{(height - 1) * stride + width - 1, -1, -stride};
+        break;
+
+    case FontIcon::Transform::Rotate270:
+        std::tie(origin, xStep, yStep) = std::tuple{(width - 1) * stride, -stride, 1};
+        break;
+
+    case FontIcon::Transform::None:
+    case FontIcon::Transform::Matrix:
+        break; // just copies the pixels
+    }
+
+    const auto target = reinterpret_cast<QRgb *>(result.bits()) + origin;
+
+    for (auto top = qsizetype{0}; top < height; top += TileSize) {
+        const auto bottom = std::min(top + TileSize, height);
+
+        for (auto left = qsizetype{0}; left < width; left += TileSize) {
+            const auto right = std::min(left + TileSize, width);
+
+            for (auto y = top; y < bottom; ++y) {
+                const auto source = reinterpret_cast<const QRgb *>(image.constScanLine(static_cast<int>(y)));
+                const auto row = target + y * yStep;
+
+                for (auto x = left; x < right; ++x)
+                    row[x * xStep] = source[x];
+            }
+        }
+    }
+
+    return result;
+}
+
+// Identifies the raster of `icon` across application launches, unless it depends on an interned matrix.
+[[nodiscard]] std::optional<RasterCache::Key> rasterCacheKey(const FontIcon &icon, const QSize &size, QIcon::Mode mode)
 {
-    return std::visit([](const auto &field) {
-        return cacheKey(field);
-    }, variant);
+    constexpr auto maximumSize = int{std::numeric_limits<quint16>::max()};
+
+    if (icon.isNull()
+            || icon.transformType() == FontIcon::Transform::Matrix
+            || size.isEmpty() || size.width() > maximumSize || size.height() > maximumSize)
+        return {};
+
+    const auto symbol = icon.symbol();
+    const auto color = DrawIconOptions{.fillBox = true, .mode = mode}.effectiveColor(icon.color(), QPalette{});
+
+    return RasterCache::Key {
+        .font       = RasterCache::fingerprint(symbol.fontInfo()),
+        .unicode    = symbol.unicode(),
+        .color      = color.isValid() ? color.rgba() : QRgb{},
+        .width      = static_cast<quint16>(size.width()),
+        .height     = static_cast<quint16>(size.height()),
+        .transform  = static_cast<quint8>(icon.transformType()),
+        .mode       = static_cast<quint8>(mode),
+    };
 }
 
 QPixmap FontIconEngine::pixmap(const QSize &size, QIcon::Mode mode, QIcon::State state)
+{
+    return rasterize(state == QIcon::On ? m_icon.on : m_icon.off, size, mode);
+}
+
+[[nodiscard]] qint64 pixmapBytes(const QPixmap &pixmap)
+{
+    return qint64{pixmap.width()} * pixmap.height() * pixmap.depth() / 8;
+}
+
+// QPixmapCache cannot enumerate its entries, therefore the keys of icon pixmaps are tracked for trimCaches(),
+// and for dropping the pixmaps that got their color from an outdated palette.
+// Just like QPixmapCache itself, this must only be used from the GUI thread.
+class PixmapKeys
+{
+public:
+    enum class Palette { Independent, Dependent };
+
+    static void insert(const QString &key, const QPixmap &pixmap, Palette palette)
+    {
+        auto &self = instance();
+
+        QPixmapCache::insert(key, pixmap);
+        self.m_keys.insert(key);
+
+        if (palette == Palette::Dependent)
+            self.m_paletteKeys.insert(key);
+
+        self.pruneEvictedKeys();
+    }
+
+    [[nodiscard]] static qint64 removeAll()
+    {
+        instance().m_paletteKeys.clear();
+        return remove(std::exchange(instance().m_keys, {}));
+    }
+
+    // Identifies the application palette. Its cache key changes whenever the palette gets modified, like when the
+    // platform switches between light and dark themes. The pixmaps rasterized for the previous palette get dropped
+    // as one batch on the first lookup after such change, and only get rasterized again when painted.
+    [[nodiscard]] static qint64 paletteGeneration()
+    {
+        auto &self = instance();
+        const auto generation = QGuiApplication::palette().cacheKey();
+
+        if (std::exchange(self.m_paletteGeneration, generation) != generation) {
+            auto keys = std::exchange(self.m_paletteKeys, {});
+            self.m_keys.subtract(keys);
+
+            const auto bytes = remove(std::move(keys));
+            qCDebug(lcIconFonts, "Palette changed, dropped %lld bytes of rasters", bytes);
+        }
+
+        return generation;
+    }
+
+private:
+    [[nodiscard]] static qint64 remove(QSet<QString> &&keys)
+    {
+        auto bytes = qint64{0};
+        auto pixmap = QPixmap{};
+
+        for (const auto &key : std::as_const(keys)) {
+            if (QPixmapCache::find(key, &pixmap)) {
+                bytes += pixmapBytes(pixmap);
+                QPixmapCache::remove(key);
+            }
+        }
+
+        return bytes;
+    }
+
+    [[nodiscard]] static PixmapKeys &instance()
+    {
+        static auto s_instance = PixmapKeys{};
+        return s_instance;
+    }
+
+    // keys of pixmaps that QPixmapCache evicted on its own are dropped once the set doubled
+    void pruneEvictedKeys()
+    {
+        if (m_keys.size() < m_pruneThreshold)
+            return;
+
+        const auto isEvicted = [](const QString &key) { return !QPixmapCache::find(key, nullptr); };
+
+        m_keys.removeIf(isEvicted);
+        m_paletteKeys.removeIf(isEvicted);
+        m_pruneThreshold = std::max(MinimumPruneThreshold, m_keys.size() * 2);
+    }
+
+    static constexpr auto MinimumPruneThreshold = qsizetype{1024};
+
+    QSet<QString> m_keys;
+    QSet<QString> m_paletteKeys;                        // subset of `m_keys` colored by the palette
+    qint64        m_paletteGeneration = 0;
+    qsizetype     m_pruneThreshold = MinimumPruneThreshold;
+};
+
+QPixmap FontIconEngine::rasterize(const FontIcon &icon, const QSize &size, QIcon::Mode mode)
 {
     const auto effectiveSize = std::min(size.width(), size.height());
-    const auto &key = cacheKey(m_icon.fields(), mode, state, effectiveSize);
+    const auto options = DrawIconOptions{.fillBox = true, .mode = mode};
+
+    // only icons without color of their own, or disabled icons, get their color from the palette
+    const auto palette = (options.applyColor && icon.color().isValid() && mode != QIcon::Disabled)
+            ? PixmapKeys::Palette::Independent : PixmapKeys::Palette::Dependent;
+    const auto &key = (palette == PixmapKeys::Palette::Dependent)
+            ? cacheKey(icon, mode, effectiveSize, PixmapKeys::paletteGeneration(),
+                       options.role.value_or(DrawIconOptions::Text))
+            : cacheKey(icon, mode, effectiveSize);
 
     auto pixmap = QPixmap{};
 
     if (!key.isEmpty() && QPixmapCache::find(key, &pixmap))
         return pixmap;
 
+    // flipped and rotated icons are derived from the untransformed icon, so that only that one must be rasterized
+    if (const auto transform = icon.transformType(); isPixelPermutation(transform, size)) {
+        const auto base = rasterize(FontIcon{icon, FontIcon::Transform::None}, size, mode);
+        pixmap = QPixmap::fromImage(permuted(base.toImage(), transform), Qt::NoFormatConversion);
+    } else {
+        pixmap = QPixmap::fromImage(rasterizeImage(icon, size, mode), Qt::NoFormatConversion);
+    }
+
+    PixmapKeys::insert(key, pixmap, palette);
+    return pixmap;
+}
+
+QImage FontIconEngine::rasterizeImage(const FontIcon &icon, const QSize &size, QIcon::Mode mode)
+{
+    const auto sharedCache = SharedRasterCache::instance();
+    const auto rasterCache = RasterCache::instance();
+    const auto rasterKey = sharedCache || rasterCache ? rasterCacheKey(icon, size, mode) : std::nullopt;
+
+    if (rasterKey) {
+        if (sharedCache) {
+            if (const auto image = sharedCache->find(*rasterKey); !image.isNull())
+                return image;
+        }
+
+        if (rasterCache) {
+            if (const auto image = rasterCache->find(*rasterKey); !image.isNull()) {
+                if (sharedCache)
+                    sharedCache->insert(*rasterKey, image);
+
+                return image.copy();
+            }
+        }
+    }
+
     auto image = QImage{size, QImage::Format_ARGB32};
     image.fill(Qt::transparent);
 
-    pixmap = QPixmap::fromImage(image, Qt::NoFormatConversion);
-
     {
-        auto painter = QPainter{&pixmap};
-        paint(&painter, {0, 0, size.width(), size.height()}, mode, state);
+        auto painter = QPainter{&image};
+
+        // FIXME: get access to palette
+        icon.draw(&painter, QSizeF{size}, {}, {.fillBox = true, .mode = mode});
     }
 
-    QPixmapCache::insert(key, pixmap);
-    return pixmap;
+    if (rasterKey) {
+        if (sharedCache)
+            sharedCache->insert(*rasterKey, image);
+        if (rasterCache)
+            rasterCache->insert(*rasterKey, image);
+    }
+
+    return image;
 }
 
 void FontIconEngine::paint(QPainter *painter, const QRect &rect, QIcon::Mode mode, QIcon::State state)
@@ -148,6 +428,46 @@ bool FontIconEngine::isNull()
     return m_icon.isNull();
 }
 
+struct InternedIcons
+{
+    static constexpr auto MaximumCount = 4096;
+
+    QMutex mutex;
+    QCache<ModalFontIcon, QIcon> icons{MaximumCount};
+};
+
+[[nodiscard]] InternedIcons &internedIcons()
+{
+    static auto s_instance = InternedIcons{};
+    return s_instance;
+}
+
+// Returns a QIcon that shares its engine with all other QIcons created for an equal `icon`. Only the icons used
+// most recently are kept, which bounds the memory of this pool while still serving all icons on screen.
+[[nodiscard]] QIcon internedIcon(const ModalFontIcon &icon)
+{
+    auto &interned = internedIcons();
+    const auto lock = QMutexLocker{&interned.mutex};
+
+    if (const auto cachedIcon = interned.icons.object(icon))
+        return *cachedIcon;
+
+    auto newIcon = QIcon{new FontIconEngine{icon}};
+    interned.icons.insert(icon, new QIcon{newIcon});
+    return newIcon;
+}
+
+[[nodiscard]] qint64 trimInternedIcons()
+{
+    auto &interned = internedIcons();
+    const auto lock = QMutexLocker{&interned.mutex};
+
+    // the engines of icons still in use elsewhere survive, but their pool entries are released anyway
+    const auto bytes = interned.icons.size() * qint64{sizeof(QIcon) + sizeof(FontIconEngine)};
+    interned.icons.clear();
+    return bytes;
+}
+
 template<FontIcon::Transform> QTransform init();
 
 template<> QTransform init<FontIcon::Transform::None>()             { return QTransform{}; }
@@ -158,14 +478,90 @@ template<> QTransform init<FontIcon::Transform::Rotate180>()        { return QTr
 template<> QTransform init<FontIcon::Transform::Rotate270>()        { return QTransform{}.rotate(270); }
 
 template<FontIcon::Transform Transform>
-[[nodiscard]] std::shared_ptr<QTransform> instance()
+[[nodiscard]] const QTransform &instance()
 {
-    thread_local static const auto s_instance
-            = std::make_shared<QTransform>(init<Transform>());
-
+    static const auto s_instance = init<Transform>();
     return s_instance;
 }
 
+// Interns the arbitrary matrices of font icons, so that icons only need to store a small index. Icons are trivially
+// copyable, so nobody knows when an entry becomes unused, and entries live as long as the program. Therefore rotations
+// get rounded to one of `RotationSteps`, which keeps animated rotations bounded, and once more than `SnappingThreshold`
+// other matrices got interned, further matrices get snapped to a grid that is too fine to be noticed.
+class TransformTable
+{
+public:
+    static constexpr auto RotationSteps = 360 * 16;
+    static constexpr auto SnappingThreshold = 1024;
+
+    enum class Kind { Rotation, Matrix };
+
+    [[nodiscard]] static TransformTable &instance()
+    {
+        static auto s_instance = TransformTable{};
+        return s_instance;
+    }
+
+    [[nodiscard]] quint32 intern(const QTransform &transform, Kind kind)
+    {
+        const auto lock = QMutexLocker{&m_mutex};
+
+        const auto snapping = (kind == Kind::Matrix && m_matrixCount >= SnappingThreshold);
+        const auto effectiveTransform = snapping ? snapped(transform) : transform;
+
+        if (const auto it = m_indices.constFind(effectiveTransform); it != m_indices.constEnd())
+            return *it;
+
+        if (kind == Kind::Matrix && ++m_matrixCount == SnappingThreshold) {
+            qCWarning(lcIconFonts, "More than %d distinct transforms used by font icons, further ones get snapped",
+                      SnappingThreshold);
+        }
+
+        const auto index = static_cast<quint32>(m_transforms.size());
+
+        m_transforms.emplace_back(effectiveTransform);
+        m_indices.insert(effectiveTransform, index);
+
+        return index;
+    }
+
+    [[nodiscard]] const QTransform &at(quint32 index) const
+    {
+        const auto lock = QMutexLocker{&m_mutex};
+        return m_transforms.at(index); // a deque never moves its elements when growing
+    }
+
+    // Returns the nearest of `RotationSteps`, if `transform` only rotates around the origin.
+    [[nodiscard]] static std::optional<int> rotationStep(const QTransform &transform)
+    {
+        if (transform.type() != QTransform::TxRotate || transform.dx() != 0 || transform.dy() != 0
+                || transform.m11() != transform.m22() || transform.m12() != -transform.m21()
+                || !qFuzzyCompare(transform.m11() * transform.m11() + transform.m12() * transform.m12(), 1.0))
+            return {};
+
+        const auto degrees = qRadiansToDegrees(std::atan2(transform.m12(), transform.m11()));
+        return (qRound(degrees * RotationSteps / 360) + RotationSteps) % RotationSteps;
+    }
+
+private:
+    TransformTable() = default;
+
+    // Rounds the linear part to 1/4096, and translations to 1/64 pixel.
+    [[nodiscard]] static QTransform snapped(const QTransform &transform)
+    {
+        const auto snap = [](qreal value, qreal steps) { return std::round(value * steps) / steps; };
+
+        return {snap(transform.m11(), 4096), snap(transform.m12(), 4096), snap(transform.m13(), 4096),
+                snap(transform.m21(), 4096), snap(transform.m22(), 4096), snap(transform.m23(), 4096),
+                snap(transform.m31(), 64),   snap(transform.m32(), 64),   snap(transform.m33(), 4096)};
+    }
+
+    mutable QMutex              m_mutex;
+    std::deque<QTransform>      m_transforms;
+    QHash<QTransform, quint32>  m_indices;
+    int                         m_matrixCount = 0;
+};
+
 [[nodiscard]] QChar::Script script(const Symbol &symbol)
 {
     if (const auto &text = symbol.toString(); !text.isEmpty())
@@ -190,6 +586,129 @@ template<FontIcon::Transform Transform>
     return QFontEngine::Format_None;
 }
 
+// The thread-local index maps of FontInfo::indexOf() get dropped when this generation changes.
+constinit auto s_indexGeneration = std::atomic<quint64>{0};
+constinit auto s_indexBytes = std::atomic<qint64>{0};
+
+[[nodiscard]] qint64 trimIndexes()
+{
+    s_indexGeneration.fetch_add(1, std::memory_order_relaxed);
+    return s_indexBytes.exchange(0, std::memory_order_relaxed);
+}
+
+// The icon fonts loaded so far, so that trimming doesn't load fonts that never got used.
+struct LoadedFonts
+{
+    QMutex mutex;
+    QList<QFont> fonts;
+};
+
+[[nodiscard]] LoadedFonts &loadedFonts()
+{
+    static auto s_instance = LoadedFonts{};
+    return s_instance;
+}
+
+[[nodiscard]] QFont rememberFont(const QFont &font)
+{
+    auto &loaded = loadedFonts();
+    const auto lock = QMutexLocker{&loaded.mutex};
+    loaded.fonts.append(font);
+    return font;
+}
+
+// Qt does not report the size of its font cache, but each font engine estimates its own cost.
+[[nodiscard]] qint64 trimFontEngines()
+{
+    auto engines = QSet<const QFontEngine *>{};
+
+    const auto fonts = [] {
+        auto &loaded = loadedFonts();
+        const auto lock = QMutexLocker{&loaded.mutex};
+        return loaded.fonts;
+    }();
+
+    for (const auto &font : fonts) {
+        const auto fontPrivate = QFontPrivate::get(font);
+
+        if (!fontPrivate->engineData)
+            continue;
+
+        for (const auto engine : fontPrivate->engineData->engines) {
+            if (const auto multiEngine = dynamic_cast<const QFontEngineMulti *>(engine))
+                engines.insert(multiEngine->engine(0));
+
+            engines.insert(engine);
+        }
+    }
+
+    engines.remove(nullptr);
+
+    auto bytes = qint64{0};
+
+    for (const auto engine : std::as_const(engines))
+        bytes += engine->cache_cost;
+
+    // engines still used by text layouts survive, all others get loaded again on their next use
+    QFontCache::instance()->clear();
+
+    return bytes;
+}
+
+struct RasterTrimmers
+{
+    QMutex mutex;
+    std::vector<qint64 (*)()> functions;
+};
+
+[[nodiscard]] RasterTrimmers &rasterTrimmers()
+{
+    static auto s_instance = RasterTrimmers{};
+    return s_instance;
+}
+
+// Releases the rasters of libraries built on top, see addRasterTrimmer().
+[[nodiscard]] qint64 trimForeignRasters()
+{
+    auto &trimmers = rasterTrimmers();
+    const auto lock = QMutexLocker{&trimmers.mutex};
+    auto bytes = qint64{0};
+
+    for (const auto trim : trimmers.functions)
+        bytes += trim();
+
+    return bytes;
+}
+
+// Returns the pixel size for drawing a symbol of `font` into `rect`. All drawing paths
+// of FontIcon::draw() use it, so that outlines and distance fields match drawText().
+[[nodiscard]] qreal effectivePixelSize(const QPainter *painter, const QRectF &rect,
+                                       const DrawIconOptions &options, const QFont &font)
+{
+    if (options.fillBox.value_or(false))
+        return std::min(rect.width(), rect.height());
+    else if (options.pixelSize)
+        return *options.pixelSize;
+    else if (options.pointSize)
+        return *options.pointSize * painter->device()->logicalDpiY() / 72;
+    else if (font.pixelSize() > 0)
+        return font.pixelSize();
+    else
+        return font.pointSizeF() * painter->device()->logicalDpiY() / 72;
+}
+
+// Returns `transform` applied around the center of `rect`.
+[[nodiscard]] QTransform centered(QTransform transform, const QRectF &rect)
+{
+    const auto cx = rect.width() / 2 + rect.x();
+    const auto cy = rect.height() / 2 + rect.y();
+
+    transform *= QTransform::fromTranslate(cx, cy);
+    transform.translate(-cx, -cy);
+
+    return transform;
+}
+
 [[nodiscard]] constexpr bool isEnumeration(const QMetaType &type) noexcept
 {
     return type.flags().testFlag(QMetaType::IsEnumeration);
@@ -242,7 +761,12 @@ FontId loadApplicationFont(const QMetaType &font, const QString &fileName)
 
 QFont loadApplicationFont(FontId fontId)
 {
-    return QFont{QFontDatabase::applicationFontFamilies(fontId)};
+    return rememberFont(QFont{QFontDatabase::applicationFontFamilies(fontId)});
+}
+
+QFont loadSystemFont(const QString &family)
+{
+    return rememberFont(QFont{family});
 }
 
 QString readText(const QString &filePath)
@@ -261,6 +785,13 @@ QString readText(const QString &filePath)
     return QString::fromUtf8(file.readAll());
 }
 
+void addRasterTrimmer(qint64 (*trimmer)())
+{
+    auto &trimmers = rasterTrimmers();
+    const auto lock = QMutexLocker{&trimmers.mutex};
+    trimmers.functions.push_back(trimmer);
+}
+
 } // namespace Private
 
 QAction *createAction(const QFont &font, QStringView iconName, QObject *parent)
@@ -270,55 +801,91 @@ QAction *createAction(const QFont &font, QStringView iconName, QObject *parent)
     return action;
 }
 
+TrimResult trimCaches(TrimLevel level)
+{
+    auto result = TrimResult{};
+
+    switch (level) {
+    case TrimLevel::Fonts:
+        result.fonts = trimFontEngines();
+        [[fallthrough]];
+
+    case TrimLevel::Indexes:
+        result.indexes = trimIndexes();
+        [[fallthrough]];
+
+    case TrimLevel::Rasters:
+        result.rasters = PixmapKeys::removeAll() + trimInternedIcons() + trimDistanceFields() + trimRasterCache()
+                       + trimForeignRasters();
+        break;
+    }
+
+    qCDebug(lcIconFonts, "Trimmed caches: %lld bytes of rasters, %lld bytes of indexes, %lld bytes of fonts",
+            result.rasters, result.indexes, result.fonts);
+
+    return result;
+}
+
 const QTransform &FontIcon::transform() const
 {
-    if (const auto transform = std::get_if<Transform>(&m_transform))
-        return *instance(*transform);
-    if (const auto transform = std::get_if<std::shared_ptr<QTransform>>(&m_transform))
-        return *transform->get();
+    if (m_transform >= code(Transform::Matrix))
+        return TransformTable::instance().at(m_transform - code(Transform::Matrix));
 
-    return *Private::instance<Transform::None>();
+    return transform(Transform{static_cast<int>(m_transform)});
 }
 
 IconFonts::FontIcon::Transform FontIcon::transformType() const
 {
-    const struct {
-        Transform operator()(const std::shared_ptr<QTransform> &) const { return Transform::Matrix; }
-        Transform operator()(const std::monostate &) const { return Transform::None; }
-        Transform operator()(Transform transform) const { return transform; }
-    } visitor;
-
-    return std::visit(visitor, m_transform);
+    return Transform{static_cast<int>(std::min(m_transform, code(Transform::Matrix)))};
 }
 
 QIcon FontIcon::toIcon() const
 {
-    return QIcon{new FontIconEngine{{.on = *this, .off = *this}}};
+    return internedIcon({.on = *this, .off = *this});
+}
+
+QImage FontIcon::toImage(const QSize &size, QIcon::Mode mode) const
+{
+    if (isNull() || size.isEmpty())
+        return {};
+
+    if (const auto transform = transformType(); isPixelPermutation(transform, size)) {
+        const auto base = FontIconEngine::rasterizeImage(FontIcon{*this, Transform::None}, size, mode);
+        return permuted(base, transform);
+    }
+
+    return FontIconEngine::rasterizeImage(*this, size, mode);
 }
 
 void FontIcon::draw(QPainter *painter, const QRectF &rect, const QPalette &palette,
                     const DrawIconOptions &options, QIcon::Mode fallbackMode) const
 {
-    auto font = symbol().font();
+    const auto symbol = this->symbol();
+    const auto hasOutlines = symbol.fontInfo().hasOutlines();
 
-    if (options.fillBox.value_or(false))
-        font.setPixelSize(std::min(rect.width(), rect.height()));
-    else if (options.pixelSize)
-        font.setPixelSize(*options.pixelSize);
-    else if (options.pointSize)
-        font.setPointSizeF(*options.pointSize);
+    auto font = symbol.font();
+    const auto pixelSize = effectivePixelSize(painter, rect, options, font);
+    const auto effectiveColor = options.effectiveColor(color(), palette, fallbackMode);
 
-    painter->save();
+    if (options.distanceField && drawDistanceField(painter, rect, symbol, pixelSize, effectiveColor))
+        return;
+
+    if (hasOutlines) {
+        drawOutline(painter, rect, symbol, pixelSize, effectiveColor);
+        return;
+    }
+
+    font.setPixelSize(std::max(1, static_cast<int>(pixelSize)));
 
-    const auto effectiveColor = options.effectiveColor(m_color, palette, fallbackMode);
+    painter->save();
 
     if (!effectiveColor.isValid()) {
-        drawImmediatly(painter, rect, font);
-    } else if (glyphFormat(font, symbol()) == QFontEngine::Format_ARGB) {
-        drawAlphaBlended(painter, rect, font, effectiveColor);
+        drawImmediatly(painter, rect, symbol, font);
+    } else if (glyphFormat(font, symbol) == QFontEngine::Format_ARGB) {
+        drawAlphaBlended(painter, rect, symbol, font, effectiveColor);
     } else {
         painter->setPen(effectiveColor);
-        drawImmediatly(painter, rect, font);
+        drawImmediatly(painter, rect, symbol, font);
     }
 
     painter->restore();
@@ -352,7 +919,7 @@ QColor DrawIconOptions::effectiveColor(const QColor &color, ColorResolver resolv
     return resolveColor(effectiveMode, role.value_or(Text));
 }
 
-void FontIcon::drawImmediatly(QPainter *painter, const QRectF &rect, const QFont &font) const
+void FontIcon::drawImmediatly(QPainter *painter, const QRectF &rect, const Symbol &symbol, const QFont &font) const
 {
     painter->setRenderHints(QPainter::Antialiasing
                             | QPainter::TextAntialiasing
@@ -368,10 +935,11 @@ void FontIcon::drawImmediatly(QPainter *painter, const QRectF &rect, const QFont
     painter->setFont(font);
     painter->setTransform(transform);
 
-    painter->drawText(rect, Qt::AlignCenter, symbol().toString());
+    painter->drawText(rect, Qt::AlignCenter, symbol.toString());
 }
 
-void FontIcon::drawAlphaBlended(QPainter *painter, const QRectF &rect, const QFont &font, const QColor &color) const
+void FontIcon::drawAlphaBlended(QPainter *painter, const QRectF &rect, const Symbol &symbol,
+                                const QFont &font, const QColor &color) const
 {
     const auto scale = painter->device()->devicePixelRatioF();
     const auto height = qCeil(rect.height() * scale);
@@ -389,14 +957,94 @@ void FontIcon::drawAlphaBlended(QPainter *painter, const QRectF &rect, const QFo
                                 | QPainter::TextAntialiasing
                                 | QPainter::VerticalSubpixelPositioning);
 
-    drawImmediatly(&imagePainter, {0, 0, rect.width(), rect.height()}, font);
+    drawImmediatly(&imagePainter, {0, 0, rect.width(), rect.height()}, symbol, font);
     imagePainter.setCompositionMode(QPainter::CompositionMode_SourceIn);
     imagePainter.fillRect(0, 0, image.width(), image.height(), color);
 
     painter->drawImage(rect.x(), rect.y(), image);
 }
 
-FontIcon::TransformVariant FontIcon::optimize(const QTransform &transform)
+void FontIcon::drawOutline(QPainter *painter, const QRectF &rect, const Symbol &symbol,
+                           qreal pixelSize, const QColor &color) const
+{
+    const auto outlines = symbol.fontInfo().glyphOutlines();
+    const auto unicode = symbol.unicode();
+
+    // place the glyph like drawText() with Qt::AlignCenter does
+    const auto ascent = outlines->ascent(pixelSize);
+    const auto descent = outlines->descent(pixelSize);
+    const auto x = rect.center().x() - outlines->advance(unicode, pixelSize) / 2;
+    const auto y = rect.center().y() - (ascent + descent) / 2 + ascent;
+
+    const auto transform = QTransform::fromTranslate(x, y) * centered(FontIcon::transform(), rect);
+    const auto path = outlines->path(unicode, pixelSize);
+    const auto effectiveColor = color.isValid() ? color : painter->pen().color();
+
+    // icon sized glyphs are rasterized directly into device pixels, which avoids setting up the raster engine
+    if (painter->worldTransform().type() <= QTransform::TxTranslate) {
+        const auto &world = painter->worldTransform();
+        const auto scale = painter->device()->devicePixelRatioF();
+        const auto deviceTransform = transform * world * QTransform::fromScale(scale, scale);
+        const auto deviceRect = deviceTransform.map(path).boundingRect().toAlignedRect();
+
+        if (GlyphRasterizer::supports(deviceRect.size())) {
+            const auto maskTransform = deviceTransform * QTransform::fromTranslate(-deviceRect.x(), -deviceRect.y());
+            auto image = GlyphRasterizer::colorize(GlyphRasterizer::rasterize(path, deviceRect.size(), maskTransform),
+                                                   effectiveColor);
+
+            const auto position = QPointF{deviceRect.x() / scale - world.dx(), deviceRect.y() / scale - world.dy()};
+
+            image.setDevicePixelRatio(scale);
+            painter->drawImage(position, image);
+            return;
+        }
+    }
+
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing);
+    painter->setTransform(transform, true);
+    painter->fillPath(path, effectiveColor);
+    painter->restore();
+}
+
+bool FontIcon::drawDistanceField(QPainter *painter, const QRectF &rect, const Symbol &symbol,
+                                 qreal pixelSize, const QColor &color) const
+{
+    const auto field = symbol.fontInfo().distanceField(symbol.unicode());
+
+    if (field.isNull())
+        return false;
+
+    // place the glyph like drawText() with Qt::AlignCenter does
+    const auto scale = pixelSize / DistanceField::ReferenceSize;
+    const auto x = rect.center().x() - field.advance() * scale / 2;
+    const auto y = rect.center().y() - (field.ascent() + field.descent()) * scale / 2 + field.ascent() * scale;
+
+    // the field gets reconstructed directly in device pixels, whatever transformations apply
+    const auto transform = QTransform::fromScale(scale, scale)
+            * QTransform::fromTranslate(x, y)
+            * centered(FontIcon::transform(), rect)
+            * painter->deviceTransform();
+
+    const auto deviceRect = transform.mapRect(field.bounds()).toAlignedRect();
+
+    if (deviceRect.isEmpty())
+        return true;
+
+    const auto maskTransform = transform * QTransform::fromTranslate(-deviceRect.x(), -deviceRect.y());
+    const auto mask = field.render(deviceRect.size(), maskTransform);
+
+    const auto image = GlyphRasterizer::colorize(mask, color.isValid() ? color : painter->pen().color());
+
+    painter->save();
+    painter->setWorldTransform(painter->deviceTransform().inverted() * painter->worldTransform());
+    painter->drawImage(deviceRect.topLeft(), image);
+    painter->restore();
+
+    return true;
+}
+
+FontIcon::TransformCode FontIcon::optimize(const QTransform &transform)
 {
     constexpr auto is90Degrees = [](const QTransform &transform) {
         return transform.m11() == 0 && transform.m22() == 0;
@@ -410,20 +1058,20 @@ FontIcon::TransformVariant FontIcon::optimize(const QTransform &transform)
 
     switch (transform.type()) {
     case QTransform::TxNone:
-        return Transform::None;
+        return code(Transform::None);
 
     case QTransform::TxScale:
         if (transform.m11() == -1) {
             if (transform.m22() == 1) {
                 if (transform.m33() == 1)
-                    return Transform::HorizontalFlip;
+                    return code(Transform::HorizontalFlip);
             } else if (transform.m22() == -1) {
                 if (transform.m33() == 1)
-                    return Transform::Rotate180;
+                    return code(Transform::Rotate180);
             }
         } else if (transform.m11() == 1) {
             if (transform.m22() == -1 && transform.m33() == 1)
-                return Transform::VerticalFlip;
+                return code(Transform::VerticalFlip);
         }
 
         break;
@@ -431,10 +1079,10 @@ FontIcon::TransformVariant FontIcon::optimize(const QTransform &transform)
     case QTransform::TxRotate:
         if (transform.m12() == 1 && transform.m21() == -1) {
             if (is90Degrees(transform) && isXAxisOnly(transform))
-                return Transform::Rotate90;
+                return code(Transform::Rotate90);
         } else if (transform.m12() == -1 && transform.m21() == 1) {
             if (is90Degrees(transform) && isXAxisOnly(transform))
-                return Transform::Rotate270;
+                return code(Transform::Rotate270);
         }
 
         break;
@@ -445,10 +1093,26 @@ FontIcon::TransformVariant FontIcon::optimize(const QTransform &transform)
         break;
     }
 
-    return std::make_shared<QTransform>(transform);
+    auto &table = TransformTable::instance();
+
+    // rounding rotations keeps animating them from interning a new matrix for each frame
+    if (const auto step = TransformTable::rotationStep(transform)) {
+        constexpr auto QuarterSteps = TransformTable::RotationSteps / 4;
+        constexpr auto quarters = std::array{Transform::None, Transform::Rotate90,
+                                             Transform::Rotate180, Transform::Rotate270};
+
+        // rotations rounded to a multiple of 90 degrees are predefined
+        if (*step % QuarterSteps == 0)
+            return code(quarters[static_cast<std::size_t>(*step / QuarterSteps)]);
+
+        const auto rotation = QTransform{}.rotate(*step * qreal{360} / TransformTable::RotationSteps);
+        return code(Transform::Matrix) + table.intern(rotation, TransformTable::Kind::Rotation);
+    }
+
+    return code(Transform::Matrix) + table.intern(transform, TransformTable::Kind::Matrix);
 }
 
-std::shared_ptr<QTransform> FontIcon::instance(Transform transform)
+const QTransform &FontIcon::transform(Transform transform)
 {
     switch (transform) {
     case Transform::None:           return Private::instance<Transform::None>();
@@ -460,7 +1124,7 @@ std::shared_ptr<QTransform> FontIcon::instance(Transform transform)
     case Transform::Matrix:         return Private::instance<Transform::None>();
     }
 
-    Q_UNREACHABLE_RETURN({});
+    Q_UNREACHABLE_RETURN(Private::instance<Transform::None>());
 }
 
 bool FontInfo::isNull() const
@@ -470,6 +1134,9 @@ bool FontInfo::isNull() const
 
 bool FontInfo::isValid() const
 {
+    if (const auto symbols = symbolTable())
+        return !symbols->isNull();
+
     return isEnumeration(enumType())
             && metaEnum().isValid();
 }
@@ -495,6 +1162,9 @@ bool FontInfo::isAvailable() const
 
 int FontInfo::symbolCount() const
 {
+    if (const auto symbols = symbolTable())
+        return symbols->count();
+
     return metaEnum().keyCount();
 }
 
@@ -503,15 +1173,28 @@ int FontInfo::indexOf(char32_t unicode) const
     using UnicodeIndexMap = std::unordered_map<char32_t, int>;
     using MetaTypeUnicodeIndexMap = std::unordered_map<int, UnicodeIndexMap>;
 
-    thread_local static auto s_indexes = MetaTypeUnicodeIndexMap{};
+    struct UnicodeIndexes
+    {
+        quint64 generation = 0;
+        MetaTypeUnicodeIndexMap maps;
+    };
+
+    thread_local static auto s_indexes = UnicodeIndexes{};
 
     if (Q_UNLIKELY(isNull()))
         return -1;
+    if (const auto symbols = symbolTable())
+        return symbols->indexOf(unicode);
+
+    // trimCaches() cannot reach into other threads, each thread drops its outdated maps on its next lookup
+    if (const auto generation = s_indexGeneration.load(std::memory_order_relaxed);
+            Q_UNLIKELY(s_indexes.generation != generation))
+        s_indexes = UnicodeIndexes{generation, {}};
 
-    auto mapIt = s_indexes.find(d->enumType.id());
+    auto mapIt = s_indexes.maps.find(d->enumType.id());
 
-    if (Q_UNLIKELY(mapIt == s_indexes.end())) {
-        mapIt = s_indexes.emplace(d->enumType.id(), UnicodeIndexMap{}).first;
+    if (Q_UNLIKELY(mapIt == s_indexes.maps.end())) {
+        mapIt = s_indexes.maps.emplace(d->enumType.id(), UnicodeIndexMap{}).first;
 
         const auto iconCount = FontInfo::symbolCount();
         auto &map = mapIt->second;
@@ -519,6 +1202,12 @@ int FontInfo::indexOf(char32_t unicode) const
 
         for (auto i = 0; i < iconCount; ++i)
             map.emplace_hint(map.end(), FontInfo::unicode(i), i);
+
+        // roughly one node of two pointers per entry, and one pointer per bucket
+        const auto bytes = map.size() * (sizeof(UnicodeIndexMap::value_type) + 2 * sizeof(void *))
+                + map.bucket_count() * sizeof(void *);
+
+        s_indexBytes.fetch_add(static_cast<qint64>(bytes), std::memory_order_relaxed);
     }
 
     const auto &unicodeIndexMap = mapIt->second;
@@ -532,12 +1221,18 @@ int FontInfo::indexOf(char32_t unicode) const
 
 char32_t FontInfo::unicode(int index) const
 {
+    if (const auto symbols = symbolTable())
+        return symbols->unicode(index);
+
     const auto value = metaEnum().value(index);
     return static_cast<char32_t>(value);
 }
 
 const char *FontInfo::key(int index) const
 {
+    if (const auto symbols = symbolTable())
+        return symbols->key(index);
+
     return metaEnum().key(index);
 }
 
@@ -552,11 +1247,35 @@ QString FontInfo::name(int index) const
 FontInfo FontInfo::fromTag(FontTag tag)
 {
     const auto &fontList = knownFonts();
+
+    if (tag.index() > static_cast<quint32>(fontList.size()))
+        return RuntimeFont::fromTag(tag);
+
     const auto &font = fontList.value(tag.index() - 1);
     Q_ASSERT(font.tag().index() == tag.index()); // FIXME: figure out how to implement proper equality operator
     return font;
 }
 
+FontInfo FontInfo::fromName(QStringView name)
+{
+    const auto matches = [name](const FontInfo &font) {
+        return name.compare(font.fontName(), Qt::CaseInsensitive) == 0
+                || name.compare(font.fontFamily(), Qt::CaseInsensitive) == 0;
+    };
+
+    for (const auto &font : knownFonts()) {
+        if (matches(font))
+            return font;
+    }
+
+    for (const auto &font : RuntimeFont::registeredFonts()) {
+        if (matches(font))
+            return font;
+    }
+
+    return {};
+}
+
 QMetaEnum FontInfo::metaEnum() const
 {
     if (d && d->enumType.isValid()) {
@@ -579,7 +1298,7 @@ QString ModalFontIcon::name() const
 
 QIcon ModalFontIcon::toIcon() const
 {
-    return QIcon{new FontIconEngine{*this}};
+    return internedIcon(*this);
 }
 
 void ModalFontIcon::draw(QPainter *painter, const QRectF &rect, QIcon::State state,
@@ -7,9 +7,12 @@
 
 #include <QColor>
 #include <QFont>
+#include <QHashFunctions>
 #include <QIcon>
 #include <QMetaType>
+#include <QPainterPath>
 #include <QPalette>
+#include <QRectF>
 #include <QTransform>
 
 class QAction;
@@ -17,8 +20,16 @@ class QAction;
 namespace IconFonts {
 
 class FontIcon;
+class GlyphCoverage;
 class Symbol;
 
+namespace Private {
+class DistanceField;
+class GlyphOutlines;
+class RuntimeFont;
+class SymbolTable;
+} // namespace Private
+
 // Concepts // =========================================================================================================
 
 inline namespace Concepts {
@@ -162,6 +173,17 @@ static_assert(!FontId{}.isValid());
 static_assert(FontId{} == FontId::Invalid);
 static_assert(static_cast<FontId>(13) == FontId{13});
 
+// GlyphMetrics struct // ==============================================================================================
+
+struct GlyphMetrics
+{
+    qreal  advance = 0;     // horizontal advance, like QFontMetricsF::horizontalAdvance()
+    QRectF boundingRect;    // ink bounds relative to the origin on the baseline, like QFontMetricsF::boundingRect()
+
+    [[nodiscard]] bool isNull() const noexcept { return advance == 0 && boundingRect.isNull(); }
+    bool operator==(const GlyphMetrics &) const = default;
+};
+
 // FontInfo class // ===================================================================================================
 
 class ICONFONTS_EXPORT FontInfo final
@@ -188,17 +210,18 @@ public:
 
     [[nodiscard]] Type type() const { return d ? d->type : Type::Invalid; }
     [[nodiscard]] QMetaType enumType() const { return d ? d->enumType : QMetaType{}; }
-    [[nodiscard]] QFont font() const { return d && d->font ? d->font() : QFont{}; }
-    [[nodiscard]] FontId fontId() const { return d && d->fontId ? d->fontId() : FontId{}; }
+    [[nodiscard]] QFont font() const { return d && d->font ? d->font(*d) : QFont{}; }
+    [[nodiscard]] FontId fontId() const { return d && d->fontId ? d->fontId(*d) : FontId{}; }
     [[nodiscard]] FontTag tag() const { return d ? d->fontTag : FontTag{}; }
-    [[nodiscard]] QString fontName() const { return d && d->fontName ? d->fontName() : QString{}; }
-    [[nodiscard]] QString fontFamily() const { return d && d->fontFamily ? d->fontFamily() : QString{}; }
-    [[nodiscard]] QString licenseFileName() const { return d && d->licenseFileName ? d->licenseFileName() : QString{}; }
-    [[nodiscard]] QString licenseText() const { return d && d->licenseText ? d->licenseText() : QString{}; }
+    [[nodiscard]] QString fontName() const { return d && d->fontName ? d->fontName(*d) : QString{}; }
+    [[nodiscard]] QString fontFamily() const { return d && d->fontFamily ? d->fontFamily(*d) : QString{}; }
+    [[nodiscard]] QString licenseFileName() const { return d && d->licenseFileName ? d->licenseFileName(*d) : QString{}; }
+    [[nodiscard]] QString licenseText() const { return d && d->licenseText ? d->licenseText(*d) : QString{}; }
 
     [[nodiscard]] bool isNull() const;
     [[nodiscard]] bool isValid() const;
     [[nodiscard]] bool isAvailable() const;
+    [[nodiscard]] bool isDynamic() const { return d && d->runtimeFont; }
     [[nodiscard]] int symbolCount() const;
     [[nodiscard]] inline Symbol symbol(int index) const;
     [[nodiscard]] int indexOf(char32_t unicode) const;
@@ -206,9 +229,27 @@ public:
     [[nodiscard]] const char *key(int index) const;
     [[nodiscard]] QString name(int index) const;
 
+    // read from the font's character map on first use, see glyphcoverage.h
+    [[nodiscard]] const GlyphCoverage &coverage() const;
+    [[nodiscard]] bool hasGlyph(char32_t unicode) const;
+
+    // scaled from the design units of the font, which are read once per font
+    [[nodiscard]] GlyphMetrics metrics(char32_t unicode, qreal pixelSize) const;
+
+    // only fonts added with the OUTLINES option have outlines, which are drawn without loading the font
+    [[nodiscard]] bool hasOutlines() const { return glyphOutlines() != nullptr; }
+    [[nodiscard]] QPainterPath outline(char32_t unicode, qreal pixelSize) const;
+
+    // distance fields get generated on first use, this generates them for all symbols in parallel
+    void prepareDistanceFields() const;
+
+    // search tags from the font's metadata, as one "Key=tag,tag" line per tagged symbol; see symbolsearch.h
+    [[nodiscard]] QByteArrayView searchTags() const { return d && d->tags ? d->tags(*d) : QByteArrayView{}; }
+
     template<symbol_enum S>
     [[nodiscard]] ICONFONTS_EXPORT static const FontInfo &instance() noexcept;
     [[nodiscard]] static FontInfo fromTag(FontTag tag);
+    [[nodiscard]] static FontInfo fromName(QStringView name); // ignores case, also accepts the font family
     [[nodiscard]] static QList<FontInfo> knownFonts();
 
     [[nodiscard]] operator QFont() const { return font(); }
@@ -216,28 +257,52 @@ public:
     friend inline bool operator==(const FontInfo &lhs, const FontInfo &rhs) noexcept;
 
 private:
+    friend class FontIcon;
+    friend class Private::RuntimeFont;
+
     [[nodiscard]] QMetaEnum metaEnum() const;
+    [[nodiscard]] const Private::SymbolTable *symbolTable() const { return d && d->symbols ? d->symbols(*d) : nullptr; }
+    [[nodiscard]] const Private::GlyphOutlines *glyphOutlines() const { return d && d->outlines ? d->outlines(*d) : nullptr; }
+    [[nodiscard]] Private::DistanceField distanceField(char32_t unicode) const;
 
     struct Data final
     {
         Type        type;
         QMetaType   enumType = {};
         FontTag     fontTag;
-        FontId   (* fontId)() = nullptr;
-        QString  (* fontName)() = nullptr;
-        QString  (* fontFamily)() = nullptr;
-        QString  (* licenseFileName)() = nullptr;
-        QString  (* licenseText)() = nullptr;
-        QFont    (* font)() = nullptr;
+        FontId   (* fontId)(const Data &) = nullptr;
+        QString  (* fontName)(const Data &) = nullptr;
+        QString  (* fontFamily)(const Data &) = nullptr;
+        QString  (* licenseFileName)(const Data &) = nullptr;
+        QString  (* licenseText)(const Data &) = nullptr;
+        QFont    (* font)(const Data &) = nullptr;
+
+        // compact symbol tables replace the meta-enum of fonts generated with ICONFONTS_COMPACT_METADATA
+        const Private::SymbolTable *(* symbols)(const Data &) = nullptr;
+
+        // glyph outlines extracted at build time for fonts added with the OUTLINES option
+        const Private::GlyphOutlines *(* outlines)(const Data &) = nullptr;
+
+        // search tags collected at build time, only some metadata formats provide them
+        QByteArrayView (* tags)(const Data &) = nullptr;
+
+        // fonts registered at runtime have no symbol enum, they carry their own symbol table
+        const Private::RuntimeFont *runtimeFont = nullptr;
 
         template<symbol_enum S>
         [[nodiscard]] static inline const Data *instance();
 
     private:
+        friend class Private::RuntimeFont;
+
         template<symbol_enum S>
         constexpr Data(S = {});
+
+        Data(const Private::RuntimeFont *runtimeFont, FontTag fontTag);
     };
 
+    constexpr explicit FontInfo(const Data *data) noexcept : d{data} {}
+
     const Data *d = nullptr;
 };
 
@@ -274,10 +339,14 @@ public:
     [[nodiscard]] inline bool         isNull() const { return m_font.isNull(); }
     [[nodiscard]] constexpr char32_t unicode() const { return m_unicode; }
     [[nodiscard]] inline FontInfo   fontInfo() const { return m_font; }
+    [[nodiscard]] inline SymbolTag       tag() const { return SymbolTag::fromValue(m_font.tag().value() | m_unicode); }
     [[nodiscard]] inline const char     *key() const { return m_font.key(m_font.indexOf(m_unicode)); }
     [[nodiscard]] inline QString        name() const { return m_font.name(m_font.indexOf(m_unicode)); }
     [[nodiscard]] inline QFont          font() const { return m_font.font(); }
 
+    [[nodiscard]] GlyphMetrics metrics(qreal pixelSize) const { return m_font.metrics(m_unicode, pixelSize); }
+    [[nodiscard]] QPainterPath outline(qreal pixelSize) const { return m_font.outline(m_unicode, pixelSize); }
+
     [[nodiscard]] QString toString() const
     {
         if (Q_UNLIKELY(isNull()))
@@ -314,6 +383,7 @@ struct ICONFONTS_EXPORT DrawIconOptions final : public named_options::options<bo
     option<2, qreal> pointSize = {};
 
     bool               applyColor = true;
+    bool            distanceField = false;  // render from the symbol's distance field, which serves all sizes
     std::optional<IconMode>  mode = {};
     std::optional<ColorRole> role = {};
 
@@ -356,11 +426,9 @@ public:
     constexpr FontIcon() noexcept = default;
 
     template<typename ...Args>
-    constexpr FontIcon(Args &&...args, const QColor &color = {},
-                       Transform transform = Transform::None) noexcept
-        : m_symbol{std::forward<Args>(args)...}
-        , m_transform{instance(transform)}
-        , m_color{color}
+    FontIcon(Args &&...args, const QColor &color = {},
+             Transform transform = Transform::None) noexcept
+        : FontIcon{Symbol{std::forward<Args>(args)...}, color, code(transform)}
     {}
 
     // classical constructors
@@ -368,45 +436,55 @@ public:
     template<symbol_enum S>
     FontIcon(S symbol, const QColor &color = {},
              Transform transform = Transform::None) noexcept
-        : FontIcon{Symbol{symbol}, color, TransformVariant{transform}} {}
+        : FontIcon{Symbol{symbol}, color, code(transform)} {}
 
     FontIcon(const Symbol &symbol, const QColor &color = {},
              Transform transform = Transform::None) noexcept
-        : FontIcon{symbol, color, TransformVariant{transform}} {}
+        : FontIcon{symbol, color, code(transform)} {}
 
     // modifying constructors
 
     FontIcon(const FontIcon &icon, const Symbol &symbol) noexcept
-        : FontIcon{symbol, icon.m_color, icon.m_transform} {}
+        : FontIcon{icon} { m_symbol = tag(symbol); }
 
     FontIcon(const FontIcon &icon, const QColor &color) noexcept
-        : FontIcon{icon.symbol(), color, icon.m_transform} {}
+        : FontIcon{icon} { std::tie(m_color, m_hasColor) = pack(color); }
 
     FontIcon(const FontIcon &icon, Transform transform) noexcept
-        : FontIcon{icon.symbol(), icon.m_color, transform} {}
+        : FontIcon{icon} { m_transform = code(transform); }
 
+    // rotations get rounded to 1/16 degree, so that animating them does not keep a matrix for each frame
     FontIcon(const FontIcon &icon, const QTransform &transform) noexcept
-        : FontIcon{icon.symbol(), icon.m_color, optimize(transform)} {}
+        : FontIcon{icon} { m_transform = optimize(transform); }
 
     // observers
 
     [[nodiscard]] inline bool          isNull() const;
-    [[nodiscard]] constexpr QColor      color() const { return m_color; }
-    [[nodiscard]] bool               hasColor() const { return m_color.isValid(); }
-    [[nodiscard]] QFont                  font() const { return m_symbol.font(); }
-    [[nodiscard]] QString                name() const { return m_symbol.name(); }
-    [[nodiscard]] Symbol               symbol() const { return m_symbol; }
-    [[nodiscard]] QString            toString() const { return m_symbol.toString(); }
+    [[nodiscard]] QColor                color() const { return m_hasColor ? QColor::fromRgba(m_color) : QColor{}; }
+    [[nodiscard]] constexpr bool     hasColor() const { return m_hasColor; }
+    [[nodiscard]] QFont                  font() const { return symbol().font(); }
+    [[nodiscard]] QString                name() const { return symbol().name(); }
+    [[nodiscard]] Symbol               symbol() const { return Symbol{m_symbol}; }
+    [[nodiscard]] QString            toString() const { return symbol().toString(); }
     [[nodiscard]] const QTransform &transform() const;
     [[nodiscard]] Transform     transformType() const;
 
     [[nodiscard]] QIcon toIcon() const;
     [[nodiscard]] operator QIcon() const { return toIcon(); }
 
-    [[nodiscard]] constexpr auto fields() const noexcept { return std::tie(m_symbol, m_color, m_transform); }
+    // Rasterizes the icon just like toIcon().pixmap() does, but can be called from any thread.
+    // The raster caches enabled by enableRasterCache() and enableSharedRasterCache() are used.
+    [[nodiscard]] QImage toImage(const QSize &size, QIcon::Mode mode = QIcon::Normal) const;
+
+    [[nodiscard]] constexpr auto fields() const noexcept
+    { return std::tie(m_symbol, m_color, m_hasColor, m_transform); }
+
     friend constexpr bool operator==(const FontIcon &l, const FontIcon &r) noexcept { return l.fields() == r.fields(); }
 
-    [[nodiscard]] static const QTransform &transform(Transform transform) { return *instance(transform); }
+    friend size_t qHash(const FontIcon &icon, size_t seed = 0) noexcept
+    { return qHashMulti(seed, icon.m_symbol.value(), icon.m_color, icon.m_hasColor, icon.m_transform); }
+
+    [[nodiscard]] static const QTransform &transform(Transform transform);
 
     // operations
 
@@ -416,26 +494,41 @@ public:
               const DrawIconOptions &options = {}, QIcon::Mode fallbackMode = QIcon::Normal) const;
 
 private:
-    using TransformVariant = std::variant<std::monostate, Transform, std::shared_ptr<QTransform>>;
+    // Transform codes below `Transform::Matrix` are predefined transforms, all others refer to interned matrices.
+    using TransformCode = quint32;
 
-    FontIcon(const Symbol &symbol, const QColor &color,
-             const TransformVariant &transform) noexcept
-        : m_symbol{symbol}
+    FontIcon(const Symbol &symbol, const QColor &color, TransformCode transform) noexcept
+        : m_symbol{tag(symbol)}
         , m_transform{transform}
-        , m_color{color}
-    {}
-
-    void drawImmediatly(QPainter *painter, const QRectF &rect, const QFont &font) const;
-    void drawAlphaBlended(QPainter *painter, const QRectF &rect, const QFont &font, const QColor &color) const;
-
-    [[nodiscard]] TransformVariant optimize(const QTransform &transform);
-    [[nodiscard]] static std::shared_ptr<QTransform> instance(Transform transform);
+    {
+        std::tie(m_color, m_hasColor) = pack(color);
+    }
 
-    Symbol              m_symbol;
-    TransformVariant    m_transform;
-    QColor              m_color;
+    // the symbol gets resolved once by draw(), resolving it looks up the font
+    void drawImmediatly(QPainter *painter, const QRectF &rect, const Symbol &symbol, const QFont &font) const;
+    void drawAlphaBlended(QPainter *painter, const QRectF &rect, const Symbol &symbol,
+                          const QFont &font, const QColor &color) const;
+    void drawOutline(QPainter *painter, const QRectF &rect, const Symbol &symbol,
+                     qreal pixelSize, const QColor &color) const;
+    bool drawDistanceField(QPainter *painter, const QRectF &rect, const Symbol &symbol,
+                           qreal pixelSize, const QColor &color) const;
+
+    [[nodiscard]] static SymbolTag tag(const Symbol &symbol) { return symbol.isNull() ? SymbolTag{} : symbol.tag(); }
+    [[nodiscard]] static std::pair<QRgb, bool> pack(const QColor &color)
+    { return {color.isValid() ? color.rgba() : QRgb{}, color.isValid()}; }
+    [[nodiscard]] static constexpr TransformCode code(Transform transform) { return std::to_underlying(transform); }
+    [[nodiscard]] static TransformCode optimize(const QTransform &transform);
+
+    // everything is stored by value, which keeps icons small, and makes copying them cheap
+    SymbolTag       m_symbol;
+    QRgb            m_color = 0;
+    bool            m_hasColor = false;
+    TransformCode   m_transform = code(Transform::None);
 };
 
+static_assert(std::is_trivially_copyable_v<FontIcon>);
+static_assert(sizeof(FontIcon) <= 16);
+
 // ModalFontIcon struct // =============================================================================================
 
 struct ICONFONTS_EXPORT ModalFontIcon final
@@ -455,6 +548,9 @@ struct ICONFONTS_EXPORT ModalFontIcon final
     friend constexpr bool operator==(const ModalFontIcon &l, const ModalFontIcon &r) noexcept
     { return l.fields() == r.fields(); }
 
+    friend size_t qHash(const ModalFontIcon &icon, size_t seed = 0) noexcept
+    { return qHashMulti(seed, icon.on, icon.off); }
+
     // operations
 
     void draw(QPainter *painter, const QRectF &rect, QIcon::State state,
@@ -506,6 +602,37 @@ template<symbol_enum S>
 
 [[nodiscard]] ICONFONTS_EXPORT QAction *createAction(const QFont &font, QStringView iconName, QObject *parent);
 
+// Keeps icons rasterized by QIcon in `directory`, or in QStandardPaths::CacheLocation, for later application launches.
+ICONFONTS_EXPORT bool enableRasterCache(const QString &directory = {});
+ICONFONTS_EXPORT void disableRasterCache();
+
+// Shares the icons rasterized by QIcon with all processes that enable a shared raster cache of the same `name`.
+// The name defaults to QCoreApplication::applicationName(), `size` is the size of the shared memory in bytes.
+ICONFONTS_EXPORT bool enableSharedRasterCache(const QString &name = {}, qsizetype size = 32 * 1024 * 1024);
+ICONFONTS_EXPORT void disableSharedRasterCache();
+
+// The caches released by trimCaches(): each level also releases the caches of all lower levels.
+enum class TrimLevel {
+    Rasters,    // pixmaps of icons rasterized for QIcon, rasters kept by the raster cache, distance fields,
+                // unused cells of the QML icon atlas, and the pool of interned QIcons
+    Indexes,    // lookup tables that map code points to symbols
+    Fonts,      // Qt's font engines, which also affects fonts other than icon fonts
+};
+
+// The bytes released per level by trimCaches(). Memory still referenced elsewhere is included, so these are estimates.
+struct TrimResult
+{
+    qint64 rasters = 0;
+    qint64 indexes = 0;
+    qint64 fonts   = 0;
+
+    [[nodiscard]] constexpr qint64 total() const noexcept { return rasters + indexes + fonts; }
+};
+
+// Releases caches that get rebuilt on demand, for instance when the system runs low on memory. Just like
+// QPixmapCache this must only be called from the GUI thread. See MemoryPressureMonitor for calling it automatically.
+ICONFONTS_EXPORT TrimResult trimCaches(TrimLevel level);
+
 template<symbol_enum S>
 [[nodiscard]] inline QAction *createAction(S symbol, QObject *parent)
 { return createAction(font<S>(), toString(symbol), parent); }
@@ -581,6 +708,9 @@ static_assert(SymbolTag::make<TestSymbol::C>()         == 0x7b'00'00'43);
 
 namespace Private {
 template<symbol_enum S> [[nodiscard]] ICONFONTS_EXPORT bool loadResources();
+template<symbol_enum S> [[nodiscard]] ICONFONTS_EXPORT const SymbolTable *symbolTable();
+template<symbol_enum S> [[nodiscard]] ICONFONTS_EXPORT const GlyphOutlines *glyphOutlines();
+template<symbol_enum S> [[nodiscard]] ICONFONTS_EXPORT QByteArrayView searchTags();
 } // namespace Private
 
 template<symbol_enum S>
@@ -588,12 +718,15 @@ constexpr FontInfo::Data::Data(S)
     : type{IconFonts::type<S>()}
     , enumType{QMetaType::fromType<S>()}
     , fontTag{IconFonts::fontTag<S>()}
-    , fontId{&IconFonts::fontId<S>}
-    , fontName{&IconFonts::fontName<S>}
-    , fontFamily{&IconFonts::fontFamily<S>}
-    , licenseFileName{&IconFonts::licenseFileName<S>}
-    , licenseText{&IconFonts::licenseText<S>}
-    , font{&IconFonts::font<S>}
+    , fontId{[](const Data &) { return IconFonts::fontId<S>(); }}
+    , fontName{[](const Data &) { return IconFonts::fontName<S>(); }}
+    , fontFamily{[](const Data &) { return IconFonts::fontFamily<S>(); }}
+    , licenseFileName{[](const Data &) { return IconFonts::licenseFileName<S>(); }}
+    , licenseText{[](const Data &) { return IconFonts::licenseText<S>(); }}
+    , font{[](const Data &) { return IconFonts::font<S>(); }}
+    , symbols{[](const Data &) { return Private::symbolTable<S>(); }}
+    , outlines{[](const Data &) { return Private::glyphOutlines<S>(); }}
+    , tags{[](const Data &) { return Private::searchTags<S>(); }}
 {}
 
 template<symbol_enum S>
@@ -619,7 +752,7 @@ inline bool operator==(const FontInfo &lhs, const FontInfo &rhs) noexcept
 {
     if (lhs.d == rhs.d)
         return true;
-    if (lhs.d && rhs.d)
+    if (lhs.d && rhs.d && lhs.d->enumType.isValid())
         return lhs.d->enumType == rhs.d->enumType;
 
     return false;
@@ -629,9 +762,9 @@ inline bool operator==(const FontInfo &lhs, const FontInfo &rhs) noexcept
 
 bool FontIcon::isNull() const
 {
-    return m_symbol.isNull()
-            && !m_color.isValid()
-            && std::holds_alternative<std::monostate>(m_transform);
+    return !m_symbol.isValid()
+            && !m_hasColor
+            && m_transform == code(Transform::None);
 }
 
 } // IconFonts
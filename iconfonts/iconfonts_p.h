@@ -5,12 +5,75 @@
 
 #include <QFile>
 #include <QFont>
+#include <QLoggingCategory>
+#include <QMutex>
+
+#include <array>
+#include <atomic>
+#include <memory>
 
 namespace IconFonts {
 namespace Private {
+Q_DECLARE_LOGGING_CATEGORY(lcIconFonts)
+
 [[nodiscard]] FontId loadApplicationFont(const QMetaType &font, const QString &fileName);
 [[nodiscard]] QFont loadApplicationFont(FontId fontId);
+[[nodiscard]] QFont loadSystemFont(const QString &family);
 [[nodiscard]] QString readText(const QString &filePath);
+
+// Lets libraries built on top, like QuickIconFonts, release their rasters when trimCaches() gets called.
+ICONFONTS_EXPORT void addRasterTrimmer(qint64 (*trimmer)());
+
+// FNV-1a, which unlike qHash() gives the same hash in every process
+[[nodiscard]] constexpr quint64 stableHash(QByteArrayView data, quint64 hash = 14695981039346656037ULL) noexcept
+{
+    for (const auto byte : data) {
+        hash ^= static_cast<uchar>(byte);
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+// Holds one lazily created value per font. Lookups only lock while creating the value of a font.
+// Values never get released: just like fonts, they are looked up by tag and returned by reference.
+template<typename T>
+class FontTagCache
+{
+public:
+    template<typename Factory>
+    [[nodiscard]] const T &find(FontTag tag, Factory &&create)
+    {
+        if (const auto value = m_valuesByTag[tag.index()].load(std::memory_order_acquire))
+            return *value;
+
+        const auto lock = QMutexLocker{&m_mutex};
+
+        if (const auto value = m_valuesByTag[tag.index()].load(std::memory_order_relaxed))
+            return *value;
+
+        const auto &value = m_values.emplace_back(std::make_unique<T>(std::forward<Factory>(create)()));
+        m_valuesByTag[tag.index()].store(value.get(), std::memory_order_release);
+
+        return *value;
+    }
+
+    // calls `function` for each value created so far
+    template<typename Function>
+    void forEach(Function &&function)
+    {
+        const auto lock = QMutexLocker{&m_mutex};
+
+        for (const auto &value : m_values)
+            function(*value);
+    }
+
+private:
+    QMutex m_mutex;
+    std::vector<std::unique_ptr<T>> m_values;
+    std::array<std::atomic<const T *>, FontTag::maximum() + 1> m_valuesByTag = {};
+};
+
 } // namespace Private
 
 template<symbol_enum S>
@@ -36,7 +99,7 @@ QFont font()
         case FontInfo::Type::Application:
             return Private::loadApplicationFont(fontId<S>());
         case FontInfo::Type::System:
-            return QFont{fontFamily<S>()};
+            return Private::loadSystemFont(fontFamily<S>());
         }
 
         Q_UNREACHABLE_RETURN(QFont{});
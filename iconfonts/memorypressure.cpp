@@ -0,0 +1,112 @@
+#include "memorypressure.h"
+#include "iconfonts_p.h"
+
+#include <QFile>
+
+namespace IconFonts {
+
+using namespace Private;
+using namespace Qt::StringLiterals;
+
+namespace {
+
+constexpr auto PressureFileName = "/proc/pressure/memory"_L1;
+
+constexpr auto FullStallThreshold = 5.0;        // percent of time all tasks stalled on memory
+constexpr auto IndexesThreshold = 20.0;         // percent of time some tasks stalled on memory
+constexpr auto RastersThreshold = 5.0;
+
+// Reads a value like "avg10=1.23" from a line like "some avg10=1.23 avg60=0.50 avg300=0.10 total=12345".
+[[nodiscard]] std::optional<double> average10(const QByteArray &pressure, QByteArrayView kind)
+{
+    for (const auto &line : pressure.split('\n')) {
+        const auto fields = line.trimmed().split(' ');
+
+        if (fields.isEmpty() || fields.front() != kind)
+            continue;
+
+        for (const auto &field : fields) {
+            if (!field.startsWith("avg10="))
+                continue;
+
+            auto ok = false;
+            const auto value = field.sliced(6).toDouble(&ok);
+            return ok ? std::optional{value} : std::nullopt;
+        }
+    }
+
+    return {};
+}
+
+} // namespace
+
+// MemoryPressureMonitor class // ======================================================================================
+
+MemoryPressureMonitor::MemoryPressureMonitor(QObject *parent)
+    : QObject{parent}
+{
+    connect(&m_timer, &QTimer::timeout, this, &MemoryPressureMonitor::poll);
+}
+
+bool MemoryPressureMonitor::startPolling(std::chrono::milliseconds interval)
+{
+    if (!QFile::exists(PressureFileName)) {
+        qCWarning(lcIconFonts, R"(Cannot monitor memory pressure: "%ls" is not available)",
+                  qUtf16Printable(QString{PressureFileName}));
+        return false;
+    }
+
+    m_pressure.reset();
+    m_timer.start(interval);
+    return true;
+}
+
+void MemoryPressureMonitor::stopPolling()
+{
+    m_timer.stop();
+}
+
+std::optional<TrimLevel> MemoryPressureMonitor::trimLevel(QByteArrayView pressure)
+{
+    const auto text = pressure.toByteArray();
+
+    if (average10(text, "full").value_or(0) >= FullStallThreshold)
+        return TrimLevel::Fonts;
+
+    const auto some = average10(text, "some").value_or(0);
+
+    if (some >= IndexesThreshold)
+        return TrimLevel::Indexes;
+    if (some >= RastersThreshold)
+        return TrimLevel::Rasters;
+
+    return {};
+}
+
+void MemoryPressureMonitor::notify(TrimLevel level)
+{
+    emit trimmed(level, trimCaches(level));
+}
+
+void MemoryPressureMonitor::poll()
+{
+    auto file = QFile{PressureFileName};
+
+    if (Q_UNLIKELY(!file.open(QFile::ReadOnly))) {
+        qCWarning(lcIconFonts, R"(Cannot read from "%ls": %ls)",
+                  qUtf16Printable(file.fileName()), qUtf16Printable(file.errorString()));
+
+        m_timer.stop();
+        return;
+    }
+
+    const auto level = trimLevel(file.readAll());
+
+    // lasting pressure only trims again when it gets worse, since the caches barely grow meanwhile
+    if (level && (!m_pressure || *level > *m_pressure))
+        notify(*level);
+
+    m_pressure = level;
+}
+
+} // namespace IconFonts
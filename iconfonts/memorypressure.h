@@ -0,0 +1,52 @@
+#ifndef ICONFONTS_MEMORYPRESSURE_H
+#define ICONFONTS_MEMORYPRESSURE_H
+
+#include "iconfonts.h"
+
+#include <QObject>
+#include <QTimer>
+
+#include <chrono>
+#include <optional>
+
+namespace IconFonts {
+
+// MemoryPressureMonitor class // ======================================================================================
+
+// Calls trimCaches() when the system runs low on memory. On Linux the monitor can poll the kernel's pressure stall
+// information, on other systems, or for application specific signals, memory pressure gets reported via notify().
+class ICONFONTS_EXPORT MemoryPressureMonitor : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr auto DefaultInterval = std::chrono::milliseconds{5000};
+
+    explicit MemoryPressureMonitor(QObject *parent = nullptr);
+
+    // Polls "/proc/pressure/memory" every `interval`. Returns `false` if the kernel doesn't provide this file.
+    bool startPolling(std::chrono::milliseconds interval = DefaultInterval);
+    void stopPolling();
+
+    [[nodiscard]] bool isPolling() const { return m_timer.isActive(); }
+
+    // Maps the contents of "/proc/pressure/memory" to the level of caches to trim, if any. Stalls of all tasks
+    // unload fonts, stalls of some tasks drop indexes or rasters, depending on their share of the last ten seconds.
+    [[nodiscard]] static std::optional<TrimLevel> trimLevel(QByteArrayView pressure);
+
+public slots:
+    void notify(IconFonts::TrimLevel level);
+
+signals:
+    void trimmed(IconFonts::TrimLevel level, IconFonts::TrimResult result);
+
+private:
+    void poll();
+
+    QTimer                   m_timer;
+    std::optional<TrimLevel> m_pressure;
+};
+
+} // namespace IconFonts
+
+#endif // ICONFONTS_MEMORYPRESSURE_H
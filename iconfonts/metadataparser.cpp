@@ -0,0 +1,739 @@
+#include "metadataparser_p.h"
+#include "iconfonts_p.h"
+#include "symboltable_p.h"
+
+#include <QVarLengthArray>
+
+#include <charconv>
+
+namespace IconFonts::Private {
+
+namespace {
+
+[[nodiscard]] constexpr bool isSpace(char ch) noexcept
+{
+    return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r' || ch == '\f' || ch == '\v';
+}
+
+[[nodiscard]] constexpr bool isIdentifier(char ch) noexcept
+{
+    return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9') || ch == '_' || ch == '$';
+}
+
+[[nodiscard]] constexpr bool isHexDigit(char ch) noexcept
+{
+    return (ch >= '0' && ch <= '9') || (ch >= 'a' && ch <= 'f') || (ch >= 'A' && ch <= 'F');
+}
+
+[[nodiscard]] std::optional<char32_t> parseHex(QByteArrayView text)
+{
+    const auto first = text.data();
+    const auto last = first + text.size();
+
+    auto value = char32_t{};
+
+    if (const auto [end, error] = std::from_chars(first, last, value, 16);
+            Q_LIKELY(error == std::errc{} && end == last))
+        return value;
+
+    return {};
+}
+
+// Symbol tags store the codepoint in their lower 24 bits, and a tag of zero is invalid.
+[[nodiscard]] std::optional<char32_t> toCodepoint(qint64 value)
+{
+    if (Q_LIKELY(value >= SymbolTag::minimum() && value <= SymbolTag::maximum()))
+        return static_cast<char32_t>(value);
+
+    return {};
+}
+
+void appendUtf8(QByteArray &text, char32_t ucs)
+{
+    if (ucs < 0x80) {
+        text.append(static_cast<char>(ucs));
+    } else if (ucs < 0x800) {
+        text.append(static_cast<char>(0xc0 | (ucs >> 6)));
+        text.append(static_cast<char>(0x80 | (ucs & 0x3f)));
+    } else if (ucs < 0x10000) {
+        text.append(static_cast<char>(0xe0 | (ucs >> 12)));
+        text.append(static_cast<char>(0x80 | ((ucs >> 6) & 0x3f)));
+        text.append(static_cast<char>(0x80 | (ucs & 0x3f)));
+    } else {
+        text.append(static_cast<char>(0xf0 | (ucs >> 18)));
+        text.append(static_cast<char>(0x80 | ((ucs >> 12) & 0x3f)));
+        text.append(static_cast<char>(0x80 | ((ucs >> 6) & 0x3f)));
+        text.append(static_cast<char>(0x80 | (ucs & 0x3f)));
+    }
+}
+
+// Returns the Unicode character of `text` if it consists of exactly one UTF-8 encoded character.
+[[nodiscard]] std::optional<char32_t> decodeSingleUtf8(QByteArrayView text)
+{
+    if (text.isEmpty())
+        return {};
+
+    const auto lead = static_cast<uchar>(text.front());
+    auto length = qsizetype{};
+    auto ucs = char32_t{};
+
+    if (lead < 0x80) {
+        length = 1, ucs = lead;
+    } else if ((lead & 0xe0) == 0xc0) {
+        length = 2, ucs = lead & 0x1f;
+    } else if ((lead & 0xf0) == 0xe0) {
+        length = 3, ucs = lead & 0x0f;
+    } else if ((lead & 0xf8) == 0xf0) {
+        length = 4, ucs = lead & 0x07;
+    } else {
+        return {};
+    }
+
+    if (text.size() != length)
+        return {};
+
+    for (auto i = 1; i < length; ++i) {
+        const auto ch = static_cast<uchar>(text[i]);
+
+        if ((ch & 0xc0) != 0x80)
+            return {};
+
+        ucs = (ucs << 6) | (ch & 0x3f);
+    }
+
+    return ucs;
+}
+
+// Skips comments and the contents of string literals while searching for `token` in `css`.
+[[nodiscard]] qsizetype findCssToken(QByteArrayView css, qsizetype position, QByteArrayView tokens)
+{
+    while (position < css.size()) {
+        const auto ch = css[position];
+
+        if (ch == '/' && position + 1 < css.size() && css[position + 1] == '*') {
+            const auto end = css.indexOf("*/", position + 2);
+            position = (end < 0 ? css.size() : end + 2);
+        } else if (ch == '"' || ch == '\'') {
+            for (++position; position < css.size() && css[position] != ch; ++position) {
+                if (css[position] == '\\')
+                    ++position;
+            }
+
+            ++position;
+        } else if (tokens.contains(ch)) {
+            return position;
+        } else {
+            ++position;
+        }
+    }
+
+    return -1;
+}
+
+// Reads the codepoint from a declaration block like `{ content: "\f101"; }`.
+[[nodiscard]] std::optional<char32_t> readCssContent(QByteArrayView block)
+{
+    for (auto position = block.indexOf("content"); position >= 0;
+         position = block.indexOf("content", position + 1)) {
+        if (position > 0 && (isIdentifier(block[position - 1]) || block[position - 1] == '-'))
+            continue;
+
+        auto value = block.sliced(position + 7).trimmed();
+
+        if (!value.startsWith(':'))
+            continue;
+
+        value = value.sliced(1).trimmed();
+
+        if (value.isEmpty() || (value.front() != '"' && value.front() != '\''))
+            return {};
+
+        const auto end = value.indexOf(value.front(), 1);
+
+        if (end < 0)
+            return {};
+
+        value = value.sliced(1, end - 1);
+
+        if (value.startsWith('\\')) {
+            auto digits = value.sliced(1);
+
+            for (auto i = 0; i < digits.size(); ++i) {
+                if (!isHexDigit(digits[i])) {
+                    digits.truncate(i);
+                    break;
+                }
+            }
+
+            return parseHex(digits);
+        }
+
+        return decodeSingleUtf8(value);
+    }
+
+    return {};
+}
+
+// Extracts the symbol name from selectors like `.prefix-name-suffix:before`.
+[[nodiscard]] QByteArrayView readCssSymbolName(QByteArrayView selector, QByteArrayView prefix, QByteArrayView suffix)
+{
+    selector = selector.trimmed();
+
+    if (selector.endsWith("::before"))
+        selector.chop(8);
+    else if (selector.endsWith(":before"))
+        selector.chop(7);
+    else
+        return {};
+
+    if (!selector.startsWith(prefix) || !selector.endsWith(suffix))
+        return {};
+
+    const auto name = selector.sliced(prefix.size(), selector.size() - prefix.size() - suffix.size());
+
+    for (const auto ch : name) {
+        if (isSpace(ch) || ch == ':' || ch == ',')
+            return {};
+    }
+
+    return name;
+}
+
+[[nodiscard]] bool parseCssRules(QByteArrayView css, QByteArrayView prefix, QByteArrayView suffix,
+                                 SymbolTableBuilder &symbols)
+{
+    auto position = qsizetype{0};
+
+    while (position < css.size()) {
+        while (position < css.size()) { // skip leading whitespace and comments of this rule
+            if (isSpace(css[position])) {
+                ++position;
+            } else if (css.sliced(position).startsWith("/*")) {
+                const auto end = css.indexOf("*/", position + 2);
+                position = (end < 0 ? css.size() : end + 2);
+            } else {
+                break;
+            }
+        }
+
+        const auto blockStart = findCssToken(css, position, "{;");
+
+        if (blockStart < 0)
+            break;
+
+        const auto selector = css.sliced(position, blockStart - position);
+
+        if (css[blockStart] == ';') { // statements like @import or @charset
+            position = blockStart + 1;
+            continue;
+        }
+
+        auto depth = 1;
+        auto blockEnd = blockStart;
+        auto isNested = false;
+
+        while (depth > 0) {
+            blockEnd = findCssToken(css, blockEnd + 1, "{}");
+
+            if (blockEnd < 0) {
+                qCWarning(lcIconFonts, "Unterminated block in style sheet at offset %lld",
+                          static_cast<qlonglong>(blockStart));
+                return false;
+            }
+
+            if (css[blockEnd] == '{') {
+                isNested = true;
+                ++depth;
+            } else {
+                --depth;
+            }
+        }
+
+        const auto block = css.sliced(blockStart + 1, blockEnd - blockStart - 1);
+
+        if (isNested) { // conditional group rules like @media
+            if (!parseCssRules(block, prefix, suffix, symbols))
+                return false;
+        } else {
+            auto names = QVarLengthArray<QByteArrayView, 4>{};
+
+            for (auto first = qsizetype{0}; first <= selector.size(); ) {
+                auto last = selector.indexOf(',', first);
+
+                if (last < 0)
+                    last = selector.size();
+
+                if (const auto name = readCssSymbolName(selector.sliced(first, last - first), prefix, suffix);
+                        !name.isEmpty())
+                    names.append(name);
+
+                first = last + 1;
+            }
+
+            if (!names.isEmpty()) {
+                if (const auto unicode = readCssContent(block)) {
+                    if (Q_UNLIKELY(!toCodepoint(*unicode))) {
+                        qCWarning(lcIconFonts, "Invalid codepoint 0x%x for \"%.*s\"", static_cast<uint>(*unicode),
+                                  static_cast<int>(names.front().size()), names.front().data());
+                        return false;
+                    }
+
+                    for (const auto &name : names)
+                        symbols.add(name, *unicode);
+                }
+            }
+        }
+
+        position = blockEnd + 1;
+    }
+
+    return true;
+}
+
+} // namespace
+
+// JsonReader class // =================================================================================================
+
+void JsonReader::skipWhitespace()
+{
+    while (m_position < m_json.size()) {
+        const auto ch = m_json[m_position];
+
+        if (isSpace(ch)) {
+            ++m_position;
+        } else if (ch == '/' && m_position + 1 < m_json.size() && m_json[m_position + 1] == '/') {
+            const auto end = m_json.indexOf('\n', m_position);
+            m_position = (end < 0 ? m_json.size() : end + 1);
+        } else if (ch == '/' && m_position + 1 < m_json.size() && m_json[m_position + 1] == '*') {
+            const auto end = m_json.indexOf("*/", m_position + 2);
+            m_position = (end < 0 ? m_json.size() : end + 2);
+        } else {
+            break;
+        }
+    }
+}
+
+char JsonReader::peek()
+{
+    skipWhitespace();
+    return m_position < m_json.size() ? m_json[m_position] : '\0';
+}
+
+bool JsonReader::fail()
+{
+    m_error = true;
+    return false;
+}
+
+bool JsonReader::expect(char ch)
+{
+    if (Q_UNLIKELY(m_error || peek() != ch))
+        return fail();
+
+    ++m_position;
+    return true;
+}
+
+bool JsonReader::beginObject()
+{
+    return expect('{');
+}
+
+bool JsonReader::beginArray()
+{
+    return expect('[');
+}
+
+bool JsonReader::nextMember(QByteArrayView &key)
+{
+    if (Q_UNLIKELY(m_error))
+        return false;
+
+    auto ch = peek();
+
+    if (ch == ',') {
+        ++m_position;
+        ch = peek();
+    }
+
+    if (ch == '}') {
+        ++m_position;
+        return false;
+    }
+
+    // JavaScript object literals also permit single quotes and plain identifiers as keys
+    const auto name = (ch == '"' || ch == '\'') ? readString() : readIdentifier();
+
+    if (Q_UNLIKELY(!name || !expect(':')))
+        return fail();
+
+    key = *name;
+    return true;
+}
+
+bool JsonReader::nextElement()
+{
+    if (Q_UNLIKELY(m_error))
+        return false;
+
+    auto ch = peek();
+
+    if (ch == ',') {
+        ++m_position;
+        ch = peek();
+    }
+
+    if (ch == ']') {
+        ++m_position;
+        return false;
+    }
+
+    if (Q_UNLIKELY(ch == '\0'))
+        return fail();
+
+    return true;
+}
+
+std::optional<QByteArrayView> JsonReader::readIdentifier()
+{
+    skipWhitespace();
+
+    const auto start = m_position;
+
+    while (m_position < m_json.size() && isIdentifier(m_json[m_position]))
+        ++m_position;
+
+    if (Q_UNLIKELY(m_position == start)) {
+        fail();
+        return {};
+    }
+
+    return m_json.sliced(start, m_position - start);
+}
+
+std::optional<QByteArrayView> JsonReader::readString()
+{
+    const auto quote = peek();
+
+    if (Q_UNLIKELY(quote != '"' && quote != '\'')) {
+        fail();
+        return {};
+    }
+
+    const auto start = ++m_position;
+    auto position = start;
+
+    for (; position < m_json.size(); ++position) { // fast path for strings without escape sequences
+        if (const auto ch = m_json[position]; ch == quote) {
+            m_position = position + 1;
+            return m_json.sliced(start, position - start);
+        } else if (ch == '\\') {
+            break;
+        }
+    }
+
+    m_scratch.resize(0);
+    m_scratch.append(m_json.sliced(start, position - start));
+
+    while (position < m_json.size()) {
+        const auto ch = m_json[position++];
+
+        if (ch == quote) {
+            m_position = position;
+            return QByteArrayView{m_scratch};
+        } else if (ch != '\\') {
+            m_scratch.append(ch);
+            continue;
+        } else if (Q_UNLIKELY(position >= m_json.size())) {
+            break;
+        }
+
+        switch (const auto escape = m_json[position++]) {
+        case 'b': m_scratch.append('\b'); break;
+        case 'f': m_scratch.append('\f'); break;
+        case 'n': m_scratch.append('\n'); break;
+        case 'r': m_scratch.append('\r'); break;
+        case 't': m_scratch.append('\t'); break;
+
+        case 'u': {
+            const auto readUtf16 = [this, &position]() -> std::optional<char32_t> {
+                if (position + 4 > m_json.size())
+                    return {};
+
+                position += 4;
+                return parseHex(m_json.sliced(position - 4, 4));
+            };
+
+            auto ucs = readUtf16();
+
+            if (ucs && *ucs >= 0xd800 && *ucs < 0xdc00
+                    && m_json.sliced(position).startsWith("\\u")) {
+                position += 2;
+
+                if (const auto low = readUtf16(); low && *low >= 0xdc00 && *low < 0xe000)
+                    ucs = 0x10000 + ((*ucs - 0xd800) << 10) + (*low - 0xdc00);
+                else
+                    ucs.reset();
+            }
+
+            if (Q_UNLIKELY(!ucs)) {
+                fail();
+                return {};
+            }
+
+            appendUtf8(m_scratch, *ucs);
+            break;
+        }
+
+        default:
+            m_scratch.append(escape);
+            break;
+        }
+    }
+
+    fail();
+    return {};
+}
+
+std::optional<qint64> JsonReader::readInteger()
+{
+    skipWhitespace();
+
+    auto first = m_json.data() + m_position;
+    const auto last = m_json.data() + m_json.size();
+    auto base = 10;
+
+    if (last - first > 2 && first[0] == '0' && (first[1] == 'x' || first[1] == 'X')) { // JavaScript
+        first += 2;
+        base = 16;
+    }
+
+    auto value = qint64{};
+    const auto [end, error] = std::from_chars(first, last, value, base);
+
+    if (Q_UNLIKELY(error != std::errc{} || (end < last && (*end == '.' || *end == 'e' || *end == 'E')))) {
+        fail();
+        return {};
+    }
+
+    m_position = end - m_json.data();
+    return value;
+}
+
+bool JsonReader::skipValue()
+{
+    switch (peek()) {
+    case '{':
+        if (beginObject()) {
+            for (auto key = QByteArrayView{}; nextMember(key); ) {
+                if (!skipValue())
+                    return false;
+            }
+        }
+
+        return !m_error;
+
+    case '[':
+        if (beginArray()) {
+            while (nextElement()) {
+                if (!skipValue())
+                    return false;
+            }
+        }
+
+        return !m_error;
+
+    case '"':
+    case '\'':
+        return readString().has_value();
+
+    case '\0':
+        return fail();
+
+    default: // numbers and literals
+        if (Q_UNLIKELY(m_error))
+            return false;
+
+        const auto start = m_position;
+
+        while (m_position < m_json.size() && (isIdentifier(m_json[m_position])
+                                              || m_json[m_position] == '.'
+                                              || m_json[m_position] == '-'
+                                              || m_json[m_position] == '+'))
+            ++m_position;
+
+        return m_position > start || fail();
+    }
+}
+
+// Metadata parsers // =================================================================================================
+
+bool parseCodepoints(QByteArrayView text, SymbolTableBuilder &symbols)
+{
+    symbols.reserve(symbols.size() + text.count('\n') + 1);
+
+    for (auto lineNumber = 1; !text.isEmpty(); ++lineNumber) {
+        auto lineLength = text.indexOf('\n');
+
+        if (lineLength < 0)
+            lineLength = text.size();
+
+        const auto line = text.first(lineLength).trimmed();
+        text = text.sliced(std::min(lineLength + 1, text.size()));
+
+        if (line.isEmpty())
+            continue;
+
+        auto separator = qsizetype{0};
+
+        while (separator < line.size() && !isSpace(line[separator]))
+            ++separator;
+
+        const auto name = line.first(separator);
+        const auto unicode = parseHex(line.sliced(separator).trimmed()).and_then(toCodepoint);
+
+        if (Q_UNLIKELY(!unicode)) {
+            qCWarning(lcIconFonts, "Unexpected codepoint definition in line %d: %.*s",
+                      lineNumber, static_cast<int>(line.size()), line.data());
+            return false;
+        }
+
+        symbols.add(name, *unicode);
+    }
+
+    return true;
+}
+
+bool parseCss(QByteArrayView css, QByteArrayView prefix, QByteArrayView suffix, SymbolTableBuilder &symbols)
+{
+    if (Q_UNLIKELY(prefix.isEmpty())) {
+        qCWarning(lcIconFonts, "A selector prefix is required for parsing style sheets");
+        return false;
+    }
+
+    return parseCssRules(css, prefix, suffix, symbols);
+}
+
+bool parseIcoMoonSelection(QByteArrayView json, SymbolTableBuilder &symbols)
+{
+    auto reader = JsonReader{json};
+    auto type = QByteArray{};
+
+    if (reader.beginObject()) {
+        for (auto key = QByteArrayView{}; reader.nextMember(key); ) {
+            if (key == "IcoMoonType") {
+                if (const auto value = reader.readString())
+                    type = value->toByteArray();
+            } else if (key == "icons" && reader.beginArray()) {
+                while (reader.nextElement() && reader.beginObject()) {
+                    auto name = QByteArray{};
+                    auto code = std::optional<qint64>{};
+
+                    for (auto iconKey = QByteArrayView{}; reader.nextMember(iconKey); ) {
+                        if (iconKey == "properties" && reader.beginObject()) {
+                            for (auto propertyKey = QByteArrayView{}; reader.nextMember(propertyKey); ) {
+                                if (propertyKey == "name") {
+                                    if (const auto value = reader.readString())
+                                        name = value->toByteArray();
+                                } else if (propertyKey == "code") {
+                                    code = reader.readInteger();
+                                } else if (!reader.skipValue()) {
+                                    break;
+                                }
+                            }
+                        } else if (!reader.skipValue()) {
+                            break;
+                        }
+                    }
+
+                    if (!name.isEmpty() && code) {
+                        const auto unicode = toCodepoint(*code);
+
+                        if (Q_UNLIKELY(!unicode)) {
+                            qCWarning(lcIconFonts, "Invalid codepoint %lld for \"%s\"",
+                                      static_cast<qlonglong>(*code), name.constData());
+                            return false;
+                        }
+
+                        symbols.add(name, *unicode);
+                    }
+                }
+            } else if (!reader.skipValue()) {
+                break;
+            }
+        }
+    }
+
+    if (Q_UNLIKELY(reader.hasError())) {
+        qCWarning(lcIconFonts, "Invalid IcoMoon selection near offset %lld", static_cast<qlonglong>(reader.position()));
+        return false;
+    }
+
+    if (Q_UNLIKELY(type != "selection")) {
+        qCWarning(lcIconFonts, "Unexpected IcoMoon file type: \"%s\"", type.constData());
+        return false;
+    }
+
+    return true;
+}
+
+bool parseMapping(QByteArrayView json, QByteArrayView variable, SymbolTableBuilder &symbols)
+{
+    if (!variable.isEmpty()) { // find object literal in `const|let|var variable = {`
+        auto found = false;
+
+        for (auto position = json.indexOf(variable); position >= 0; position = json.indexOf(variable, position + 1)) {
+            if (position > 0 && isIdentifier(json[position - 1]))
+                continue;
+
+            const auto definition = json.sliced(position + variable.size()).trimmed();
+
+            if (!definition.startsWith('=') || !definition.sliced(1).trimmed().startsWith('{'))
+                continue;
+
+            json = definition.sliced(definition.indexOf('{'));
+            found = true;
+            break;
+        }
+
+        if (Q_UNLIKELY(!found)) {
+            qCWarning(lcIconFonts, "Cannot find definition of \"%.*s\"",
+                      static_cast<int>(variable.size()), variable.data());
+            return false;
+        }
+    }
+
+    auto reader = JsonReader{json};
+
+    if (reader.beginObject()) {
+        for (auto key = QByteArrayView{}; reader.nextMember(key); ) {
+            const auto name = key.toByteArray(); // reading the value might reuse the key's storage
+            auto unicode = std::optional<char32_t>{};
+
+            if (const auto ch = reader.peek(); ch == '"' || ch == '\'') {
+                if (const auto value = reader.readString()) // either the symbol itself, or its hex code
+                    unicode = decodeSingleUtf8(*value)
+                            .or_else([value] { return parseHex(*value); })
+                            .and_then(toCodepoint);
+            } else if (const auto value = reader.readInteger()) {
+                unicode = toCodepoint(*value);
+            }
+
+            if (Q_UNLIKELY(!unicode)) {
+                qCWarning(lcIconFonts, "Unexpected mapping for \"%s\"", name.constData());
+                return false;
+            }
+
+            symbols.add(name, *unicode);
+        }
+    }
+
+    if (Q_UNLIKELY(reader.hasError())) {
+        qCWarning(lcIconFonts, "Invalid mapping near offset %lld", static_cast<qlonglong>(reader.position()));
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace IconFonts::Private
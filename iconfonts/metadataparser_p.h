@@ -0,0 +1,65 @@
+#ifndef ICONFONTS_METADATAPARSER_P_H
+#define ICONFONTS_METADATAPARSER_P_H
+
+#include <QByteArray>
+
+#include <optional>
+
+namespace IconFonts::Private {
+
+class SymbolTableBuilder;
+
+// JsonReader class // =================================================================================================
+
+// A minimal pull parser for JSON and JavaScript object literals. It doesn't build a document,
+// and therefore can walk the huge metadata files of icon fonts without allocating per node.
+class JsonReader final
+{
+public:
+    explicit JsonReader(QByteArrayView json) noexcept : m_json{json} {}
+
+    [[nodiscard]] char peek();
+    [[nodiscard]] bool beginObject();
+    [[nodiscard]] bool nextMember(QByteArrayView &key);
+    [[nodiscard]] bool beginArray();
+    [[nodiscard]] bool nextElement();
+
+    [[nodiscard]] std::optional<QByteArrayView> readString();
+    [[nodiscard]] std::optional<qint64> readInteger();
+    [[nodiscard]] bool skipValue();
+
+    [[nodiscard]] bool hasError() const noexcept { return m_error; }
+    [[nodiscard]] qsizetype position() const noexcept { return m_position; }
+
+private:
+    [[nodiscard]] bool expect(char ch);
+    [[nodiscard]] bool fail();
+    [[nodiscard]] std::optional<QByteArrayView> readIdentifier();
+
+    void skipWhitespace();
+
+    QByteArrayView m_json;
+    qsizetype      m_position = 0;
+    QByteArray     m_scratch;
+    bool           m_error = false;
+};
+
+// Metadata parsers // =================================================================================================
+
+// Lines of "name hexcode", as used by Material Symbols.
+[[nodiscard]] bool parseCodepoints(QByteArrayView text, SymbolTableBuilder &symbols);
+
+// Style sheets with rules like `.prefix-name-suffix:before { content: "\f101"; }`.
+[[nodiscard]] bool parseCss(QByteArrayView css, QByteArrayView prefix, QByteArrayView suffix,
+                            SymbolTableBuilder &symbols);
+
+// The selection.json files exported by IcoMoon.
+[[nodiscard]] bool parseIcoMoonSelection(QByteArrayView json, SymbolTableBuilder &symbols);
+
+// JSON objects mapping symbol names to codepoints. If `variable` is not empty, the object
+// literal assigned to this variable in a JavaScript file gets parsed instead.
+[[nodiscard]] bool parseMapping(QByteArrayView json, QByteArrayView variable, SymbolTableBuilder &symbols);
+
+} // namespace IconFonts::Private
+
+#endif // ICONFONTS_METADATAPARSER_P_H
@@ -0,0 +1,525 @@
+#include "opentypereader_p.h"
+#include "iconfonts_p.h"
+#include "symboltable_p.h"
+
+#include <QtEndian>
+
+#include <algorithm>
+
+namespace IconFonts::Private {
+
+namespace {
+
+[[nodiscard]] constexpr quint32 makeTag(const char (&tag)[5]) noexcept
+{
+    return (static_cast<quint32>(static_cast<uchar>(tag[0])) << 24)
+            | (static_cast<quint32>(static_cast<uchar>(tag[1])) << 16)
+            | (static_cast<quint32>(static_cast<uchar>(tag[2])) << 8)
+            | (static_cast<quint32>(static_cast<uchar>(tag[3])));
+}
+
+[[nodiscard]] constexpr bool contains(QByteArrayView data, qint64 offset, qint64 size) noexcept
+{
+    return offset >= 0 && size >= 0 && offset <= data.size() - size;
+}
+
+[[nodiscard]] quint8 readUInt8(QByteArrayView data, qint64 offset) noexcept
+{
+    return static_cast<quint8>(data[static_cast<qsizetype>(offset)]);
+}
+
+[[nodiscard]] quint16 readUInt16(QByteArrayView data, qint64 offset) noexcept
+{
+    return qFromBigEndian<quint16>(data.data() + offset);
+}
+
+[[nodiscard]] quint32 readUInt32(QByteArrayView data, qint64 offset) noexcept
+{
+    return qFromBigEndian<quint32>(data.data() + offset);
+}
+
+// CFF INDEX structures // =============================================================================================
+
+class CffIndex
+{
+public:
+    CffIndex() noexcept = default;
+
+    CffIndex(QByteArrayView cff, qint64 offset) noexcept
+    {
+        if (!contains(cff, offset, 2))
+            return;
+
+        m_count = readUInt16(cff, offset);
+
+        if (m_count == 0) {
+            m_cff = cff;
+            m_end = offset + 2;
+            return;
+        }
+
+        if (!contains(cff, offset, 3))
+            return;
+
+        m_offsetSize = readUInt8(cff, offset + 2);
+        m_offsets = offset + 3;
+
+        if (m_offsetSize < 1 || m_offsetSize > 4 || !contains(cff, m_offsets, (m_count + 1) * m_offsetSize))
+            return;
+
+        m_cff = cff;
+        m_data = m_offsets + (m_count + 1) * m_offsetSize - 1; // offsets start at 1
+        m_end = m_data + readOffset(m_count);
+
+        if (m_end > cff.size())
+            m_cff = {};
+    }
+
+    [[nodiscard]] bool isValid() const noexcept { return !m_cff.isNull(); }
+    [[nodiscard]] quint32 count() const noexcept { return m_count; }
+    [[nodiscard]] qint64 end() const noexcept { return m_end; }
+
+    [[nodiscard]] QByteArrayView at(quint32 index) const noexcept
+    {
+        if (!isValid() || index >= m_count)
+            return {};
+
+        const auto first = m_data + readOffset(index);
+        const auto last = m_data + readOffset(index + 1);
+
+        if (first > last || !contains(m_cff, first, last - first))
+            return {};
+
+        return m_cff.sliced(static_cast<qsizetype>(first), static_cast<qsizetype>(last - first));
+    }
+
+private:
+    [[nodiscard]] qint64 readOffset(quint32 index) const noexcept
+    {
+        auto offset = qint64{0};
+
+        for (auto i = 0; i < m_offsetSize; ++i)
+            offset = (offset << 8) | readUInt8(m_cff, m_offsets + index * m_offsetSize + i);
+
+        return offset;
+    }
+
+    QByteArrayView m_cff;
+    quint32        m_count = 0;
+    int            m_offsetSize = 0;
+    qint64         m_offsets = 0;
+    qint64         m_data = 0;
+    qint64         m_end = 0;
+};
+
+struct CffTopDict
+{
+    qint64 charset = 0;
+    qint64 charStrings = -1;
+};
+
+[[nodiscard]] CffTopDict readTopDict(QByteArrayView dict) noexcept
+{
+    constexpr auto Charset = 15;
+    constexpr auto CharStrings = 17;
+
+    auto result = CffTopDict{};
+    auto operand = qint64{0};
+
+    for (auto position = qsizetype{0}; position < dict.size(); ) {
+        const auto b0 = readUInt8(dict, position);
+        const auto remaining = dict.size() - position;
+
+        if (b0 <= 21) { // operator
+            if (b0 == Charset)
+                result.charset = operand;
+            else if (b0 == CharStrings)
+                result.charStrings = operand;
+
+            position += (b0 == 12 ? 2 : 1);
+        } else if (b0 == 28 && remaining >= 3) {
+            operand = static_cast<qint16>(readUInt16(dict, position + 1));
+            position += 3;
+        } else if (b0 == 29 && remaining >= 5) {
+            operand = static_cast<qint32>(readUInt32(dict, position + 1));
+            position += 5;
+        } else if (b0 == 30) { // real numbers are not needed, just skip their nibbles
+            for (++position; position < dict.size(); ++position) {
+                const auto nibbles = readUInt8(dict, position);
+
+                if ((nibbles & 0x0f) == 0x0f || (nibbles & 0xf0) == 0xf0) {
+                    ++position;
+                    break;
+                }
+            }
+
+            operand = 0;
+        } else if (b0 >= 32 && b0 <= 246) {
+            operand = b0 - 139;
+            position += 1;
+        } else if (b0 >= 247 && b0 <= 250 && remaining >= 2) {
+            operand = (b0 - 247) * 256 + readUInt8(dict, position + 1) + 108;
+            position += 2;
+        } else if (b0 >= 251 && b0 <= 254 && remaining >= 2) {
+            operand = -(b0 - 251) * 256 - readUInt8(dict, position + 1) - 108;
+            position += 2;
+        } else {
+            break; // reserved or truncated
+        }
+    }
+
+    return result;
+}
+
+// Character maps // ===================================================================================================
+
+void readCharacterMap4(QByteArrayView subtable, std::vector<OpenTypeReader::Mapping> &mappings)
+{
+    if (!contains(subtable, 0, 14))
+        return;
+
+    const auto segmentCount = readUInt16(subtable, 6) / 2;
+    const auto endCodes = qint64{14};
+    const auto startCodes = endCodes + 2 * segmentCount + 2;
+    const auto idDeltas = startCodes + 2 * segmentCount;
+    const auto idRangeOffsets = idDeltas + 2 * segmentCount;
+
+    if (!contains(subtable, idRangeOffsets, 2 * segmentCount))
+        return;
+
+    for (auto segment = 0; segment < segmentCount; ++segment) {
+        const auto endCode = readUInt16(subtable, endCodes + 2 * segment);
+        const auto startCode = readUInt16(subtable, startCodes + 2 * segment);
+        const auto idDelta = readUInt16(subtable, idDeltas + 2 * segment);
+        const auto idRangeOffsetPosition = idRangeOffsets + 2 * segment;
+        const auto idRangeOffset = readUInt16(subtable, idRangeOffsetPosition);
+
+        for (auto unicode = quint32{startCode}; unicode <= endCode && unicode < 0xffff; ++unicode) {
+            auto glyph = quint16{0};
+
+            if (idRangeOffset == 0) {
+                glyph = static_cast<quint16>(unicode + idDelta);
+            } else {
+                const auto position = idRangeOffsetPosition + idRangeOffset + 2 * (unicode - startCode);
+
+                if (!contains(subtable, position, 2))
+                    break;
+
+                glyph = readUInt16(subtable, position);
+
+                if (glyph != 0)
+                    glyph = static_cast<quint16>(glyph + idDelta);
+            }
+
+            if (glyph != 0)
+                mappings.emplace_back(static_cast<char32_t>(unicode), glyph);
+        }
+    }
+}
+
+void readCharacterMap12(QByteArrayView subtable, std::vector<OpenTypeReader::Mapping> &mappings)
+{
+    if (!contains(subtable, 0, 16))
+        return;
+
+    const auto groupCount = readUInt32(subtable, 12);
+
+    if (!contains(subtable, 16, qint64{groupCount} * 12))
+        return;
+
+    // groups must be sorted and disjoint, which also bounds the number of mappings by the Unicode range
+    auto nextCode = quint32{0};
+
+    for (auto group = quint32{0}; group < groupCount; ++group) {
+        const auto position = 16 + qint64{group} * 12;
+        const auto startCode = readUInt32(subtable, position);
+        const auto endCode = readUInt32(subtable, position + 4);
+        const auto startGlyph = readUInt32(subtable, position + 8);
+
+        if (startCode < nextCode || endCode < startCode || endCode > 0x10ffff)
+            continue;
+
+        nextCode = endCode + 1;
+
+        for (auto unicode = startCode; unicode <= endCode; ++unicode) {
+            const auto glyph = startGlyph + (unicode - startCode);
+
+            if (glyph > 0xffff)
+                break;
+            if (glyph != 0)
+                mappings.emplace_back(static_cast<char32_t>(unicode), static_cast<quint16>(glyph));
+        }
+    }
+}
+
+} // namespace
+
+// OpenTypeReader class // =============================================================================================
+
+OpenTypeReader::OpenTypeReader(QByteArrayView font, quint32 fontIndex) noexcept
+    : m_font{font}
+{
+    auto offset = qint64{0};
+
+    if (!contains(font, 0, 12))
+        return;
+
+    if (readUInt32(font, 0) == makeTag("ttcf")) { // font collection
+        const auto fontCount = readUInt32(font, 8);
+
+        if (fontIndex >= fontCount || !contains(font, 12 + 4 * qint64{fontIndex}, 4))
+            return;
+
+        offset = readUInt32(font, 12 + 4 * qint64{fontIndex});
+    } else if (fontIndex > 0) {
+        return;
+    }
+
+    if (!contains(font, offset, 12))
+        return;
+
+    if (const auto version = readUInt32(font, offset);
+            version != 0x00010000 && version != makeTag("OTTO") && version != makeTag("true"))
+        return;
+
+    const auto tableCount = readUInt16(font, offset + 4);
+
+    if (contains(font, offset + 12, 16 * qint64{tableCount}))
+        m_tableRecords = font.sliced(static_cast<qsizetype>(offset + 12), 16 * qsizetype{tableCount});
+}
+
+QByteArrayView OpenTypeReader::table(const char (&tag)[5]) const noexcept
+{
+    const auto expectedTag = makeTag(tag);
+
+    for (auto record = qint64{0}; record < m_tableRecords.size(); record += 16) {
+        if (readUInt32(m_tableRecords, record) == expectedTag) {
+            const auto offset = readUInt32(m_tableRecords, record + 8);
+            const auto length = readUInt32(m_tableRecords, record + 12);
+
+            if (contains(m_font, offset, length))
+                return m_font.sliced(offset, length);
+
+            break;
+        }
+    }
+
+    return {};
+}
+
+int OpenTypeReader::glyphCount() const noexcept
+{
+    if (const auto maxp = table("maxp"); contains(maxp, 4, 2))
+        return readUInt16(maxp, 4);
+
+    return 0;
+}
+
+std::vector<OpenTypeReader::Mapping> OpenTypeReader::characterMap() const
+{
+    return readCharacterMap(table("cmap"));
+}
+
+std::vector<OpenTypeReader::Mapping> OpenTypeReader::readCharacterMap(QByteArrayView cmap)
+{
+    if (!contains(cmap, 0, 4))
+        return {};
+
+    const auto subtableCount = readUInt16(cmap, 2);
+
+    auto bestScore = 0;
+    auto bestSubtable = QByteArrayView{};
+
+    for (auto i = 0; i < subtableCount && contains(cmap, 4 + 8 * i, 8); ++i) {
+        const auto platform = readUInt16(cmap, 4 + 8 * i);
+        const auto encoding = readUInt16(cmap, 4 + 8 * i + 2);
+        const auto offset = readUInt32(cmap, 4 + 8 * i + 4);
+
+        if (!contains(cmap, offset, 2))
+            continue;
+
+        const auto format = readUInt16(cmap, offset);
+
+        if (format != 4 && format != 12)
+            continue;
+
+        const auto score = [platform, encoding, format] {
+            if (platform == 3 && encoding == 10)    // Windows, full Unicode
+                return 6;
+            if (platform == 0 && format == 12)      // Unicode, full repertoire
+                return 5;
+            if (platform == 3 && encoding == 1)     // Windows, BMP
+                return 4;
+            if (platform == 0)                      // Unicode, BMP
+                return 3;
+            if (platform == 3 && encoding == 0)     // Windows, symbol fonts
+                return 2;
+
+            return 0;
+        }();
+
+        if (score > bestScore) {
+            bestScore = score;
+            bestSubtable = cmap.sliced(offset);
+        }
+    }
+
+    auto mappings = std::vector<Mapping>{};
+
+    if (bestScore > 0) {
+        if (readUInt16(bestSubtable, 0) == 4)
+            readCharacterMap4(bestSubtable, mappings);
+        else
+            readCharacterMap12(bestSubtable, mappings);
+
+        std::ranges::sort(mappings, {}, &Mapping::unicode);
+    }
+
+    return mappings;
+}
+
+std::vector<QByteArrayView> OpenTypeReader::glyphNames() const
+{
+    if (auto names = postGlyphNames(table("post")); !names.empty())
+        return names;
+
+    return cffGlyphNames(table("CFF "));
+}
+
+std::vector<QByteArrayView> OpenTypeReader::postGlyphNames(QByteArrayView post) const
+{
+    constexpr auto StandardNameCount = 258;
+
+    if (!contains(post, 0, 34) || readUInt32(post, 0) != 0x00020000)
+        return {};
+
+    const auto glyphCount = readUInt16(post, 32);
+    const auto nameIndexes = qint64{34};
+    const auto namesOffset = nameIndexes + 2 * qint64{glyphCount};
+
+    if (!contains(post, nameIndexes, 2 * qint64{glyphCount}))
+        return {};
+
+    auto customNames = std::vector<QByteArrayView>{};
+    customNames.reserve(glyphCount);
+
+    for (auto position = namesOffset; position < post.size(); ) { // Pascal strings
+        const auto length = readUInt8(post, position);
+
+        if (!contains(post, position + 1, length))
+            break;
+
+        customNames.emplace_back(post.sliced(static_cast<qsizetype>(position + 1), length));
+        position += 1 + length;
+    }
+
+    auto names = std::vector<QByteArrayView>(glyphCount);
+
+    for (auto glyph = 0; glyph < glyphCount; ++glyph) {
+        const auto index = readUInt16(post, nameIndexes + 2 * glyph);
+
+        if (index >= StandardNameCount && static_cast<std::size_t>(index - StandardNameCount) < customNames.size())
+            names[glyph] = customNames[index - StandardNameCount];
+    }
+
+    return names;
+}
+
+std::vector<QByteArrayView> OpenTypeReader::cffGlyphNames(QByteArrayView cff) const
+{
+    constexpr auto StandardStringCount = 391;
+
+    if (!contains(cff, 0, 4) || readUInt8(cff, 0) != 1)
+        return {};
+
+    const auto nameIndex = CffIndex{cff, readUInt8(cff, 2)};
+    const auto topDictIndex = CffIndex{cff, nameIndex.end()};
+    const auto stringIndex = CffIndex{cff, topDictIndex.end()};
+
+    if (!nameIndex.isValid() || !topDictIndex.isValid() || !stringIndex.isValid())
+        return {};
+
+    const auto topDict = readTopDict(topDictIndex.at(0));
+    const auto charStrings = CffIndex{cff, topDict.charStrings};
+
+    if (!charStrings.isValid() || topDict.charset <= 2) // the predefined charsets only use standard strings
+        return {};
+
+    const auto glyphCount = charStrings.count();
+    auto names = std::vector<QByteArrayView>(glyphCount);
+
+    const auto assignName = [&](quint32 glyph, quint32 sid) {
+        if (sid >= StandardStringCount)
+            names[glyph] = stringIndex.at(sid - StandardStringCount);
+    };
+
+    if (!contains(cff, topDict.charset, 1))
+        return {};
+
+    const auto format = readUInt8(cff, topDict.charset);
+    auto position = topDict.charset + 1;
+
+    if (format == 0) {
+        for (auto glyph = quint32{1}; glyph < glyphCount && contains(cff, position, 2); ++glyph, position += 2)
+            assignName(glyph, readUInt16(cff, position));
+    } else if (format == 1 || format == 2) {
+        const auto rangeSize = (format == 1 ? 3 : 4);
+
+        for (auto glyph = quint32{1}; glyph < glyphCount && contains(cff, position, rangeSize); position += rangeSize) {
+            const auto first = readUInt16(cff, position);
+            const auto left = static_cast<quint32>(format == 1 ? readUInt8(cff, position + 2)
+                                                              : readUInt16(cff, position + 2));
+
+            for (auto i = quint32{0}; i <= left && glyph < glyphCount; ++i, ++glyph)
+                assignName(glyph, first + i);
+        }
+    }
+
+    return names;
+}
+
+// Metadata parsers // =================================================================================================
+
+bool parseOpenType(QByteArrayView font, SymbolTableBuilder &symbols)
+{
+    const auto reader = OpenTypeReader{font};
+
+    if (Q_UNLIKELY(!reader.isValid())) {
+        qCWarning(lcIconFonts, "Unsupported font format, only OpenType and TrueType fonts can be read");
+        return false;
+    }
+
+    const auto characterMap = reader.characterMap();
+
+    if (Q_UNLIKELY(characterMap.empty())) {
+        qCWarning(lcIconFonts, "No usable character map found in font");
+        return false;
+    }
+
+    const auto glyphNames = reader.glyphNames();
+    auto fallbackName = QByteArray{};
+
+    symbols.reserve(symbols.size() + static_cast<qsizetype>(characterMap.size()));
+
+    for (const auto &[unicode, glyph] : characterMap) {
+        if (unicode <= 0x20) // whitespace and control characters
+            continue;
+
+        auto name = (glyph < glyphNames.size() ? glyphNames[glyph] : QByteArrayView{});
+
+        if (name.startsWith('.')) // .notdef, .null and similar
+            continue;
+
+        if (name.isEmpty()) { // glyph names of the Adobe Glyph List specification
+            fallbackName = (unicode <= 0xffff ? "uni" : "u")
+                    + QByteArray::number(static_cast<quint32>(unicode), 16).toUpper().rightJustified(4, '0');
+            name = fallbackName;
+        }
+
+        symbols.add(name, unicode);
+    }
+
+    return true;
+}
+
+} // namespace IconFonts::Private
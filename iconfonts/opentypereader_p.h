@@ -0,0 +1,54 @@
+#ifndef ICONFONTS_OPENTYPEREADER_P_H
+#define ICONFONTS_OPENTYPEREADER_P_H
+
+#include <QByteArrayView>
+
+#include <vector>
+
+namespace IconFonts::Private {
+
+class SymbolTableBuilder;
+
+// OpenTypeReader class // =============================================================================================
+
+// Reads character maps and glyph names directly from the bytes of an OpenType font, usually memory mapped.
+// Nothing gets copied: all results refer to the font data, which therefore must outlive the results.
+class ICONFONTS_EXPORT OpenTypeReader final
+{
+public:
+    struct Mapping
+    {
+        char32_t unicode;
+        quint16  glyph;
+    };
+
+    explicit OpenTypeReader(QByteArrayView font, quint32 fontIndex = 0) noexcept;
+
+    [[nodiscard]] bool isValid() const noexcept { return !m_tableRecords.isEmpty(); }
+    [[nodiscard]] QByteArrayView table(const char (&tag)[5]) const noexcept;
+    [[nodiscard]] int glyphCount() const noexcept;
+
+    // sorted by codepoint, read from the best Unicode subtable (format 4 or 12)
+    [[nodiscard]] std::vector<Mapping> characterMap() const;
+
+    // like characterMap(), but for a `cmap` table that got loaded separately, e.g. by QRawFont
+    [[nodiscard]] static std::vector<Mapping> readCharacterMap(QByteArrayView cmap);
+
+    // indexed by glyph, read from version 2.0 `post` tables, or from the charset of `CFF ` tables;
+    // standard names of Macintosh and CFF encodings are not resolved, icons hardly ever use them
+    [[nodiscard]] std::vector<QByteArrayView> glyphNames() const;
+
+private:
+    [[nodiscard]] std::vector<QByteArrayView> postGlyphNames(QByteArrayView post) const;
+    [[nodiscard]] std::vector<QByteArrayView> cffGlyphNames(QByteArrayView cff) const;
+
+    QByteArrayView m_font;
+    QByteArrayView m_tableRecords;
+};
+
+// Collects the symbols of `font` from its character map and glyph names.
+[[nodiscard]] ICONFONTS_EXPORT bool parseOpenType(QByteArrayView font, SymbolTableBuilder &symbols);
+
+} // namespace IconFonts::Private
+
+#endif // ICONFONTS_OPENTYPEREADER_P_H
@@ -0,0 +1,395 @@
+#include "quickiconatlas_p.h"
+#include "iconfonts_p.h"
+
+#include <QPainter>
+#include <QQuickWindow>
+#include <QSGImageNode>
+#include <QSGTexture>
+#include <QVarLengthArray>
+
+#include <QtGui/private/qrhi_p.h>
+#include <QtQuick/private/qquickwindow_p.h>
+#include <QtQuick/private/qsgcontext_p.h>
+
+#include <algorithm>
+#include <bit>
+
+namespace QuickIconFonts::Private {
+namespace {
+
+constexpr auto MinimumBucket = 16;
+
+// The texture of an atlas page for renderers based on QRhi, which only uploads the cells added since the last frame.
+class PageTexture final : public QSGTexture
+{
+public:
+    void upload(const QPoint &position, QImage image) { m_uploads.emplace_back(position, std::move(image)); }
+
+    qint64 comparisonKey() const override { return static_cast<qint64>(reinterpret_cast<quintptr>(this)); }
+    QRhiTexture *rhiTexture() const override { return m_texture.get(); }
+    QSize textureSize() const override { return {IconAtlas::PageSize, IconAtlas::PageSize}; }
+    bool hasAlphaChannel() const override { return true; }
+    bool hasMipmaps() const override { return false; }
+
+    void commitTextureOperations(QRhi *rhi, QRhiResourceUpdateBatch *resourceUpdates) override
+    {
+        if (!m_texture) {
+            m_texture.reset(rhi->newTexture(QRhiTexture::RGBA8, textureSize()));
+
+            if (Q_UNLIKELY(!m_texture->create())) {
+                qWarning("Cannot create a texture for the icon atlas");
+                m_texture.reset();
+                return;
+            }
+        }
+
+        if (m_uploads.empty())
+            return;
+
+        auto entries = QVarLengthArray<QRhiTextureUploadEntry, 16>{};
+
+        for (const auto &[position, image] : std::exchange(m_uploads, {})) {
+            auto subresource = QRhiTextureSubresourceUploadDescription{image};
+            subresource.setDestinationTopLeft(position);
+            entries.append(QRhiTextureUploadEntry{0, 0, subresource});
+        }
+
+        auto description = QRhiTextureUploadDescription{};
+        description.setEntries(entries.cbegin(), entries.cend());
+        resourceUpdates->uploadTexture(m_texture.get(), description);
+    }
+
+private:
+    std::unique_ptr<QRhiTexture>           m_texture;
+    std::vector<std::pair<QPoint, QImage>> m_uploads;
+};
+
+struct AtlasRegistry
+{
+    QMutex mutex;
+    QHash<const QSGRenderContext *, std::shared_ptr<IconAtlas>> atlases;
+};
+
+[[nodiscard]] qint64 trimAtlases();
+
+[[nodiscard]] AtlasRegistry &atlasRegistry()
+{
+    static auto s_instance = [] {
+        IconFonts::Private::addRasterTrimmer(&trimAtlases);
+        return AtlasRegistry{};
+    }();
+
+    return s_instance;
+}
+
+qint64 trimAtlases()
+{
+    auto &registry = atlasRegistry();
+    const auto lock = QMutexLocker{&registry.mutex};
+    auto bytes = qint64{0};
+
+    for (const auto &atlas : std::as_const(registry.atlases))
+        bytes += atlas->trim();
+
+    return bytes;
+}
+
+} // namespace
+
+// IconAtlas class // ==================================================================================================
+
+std::shared_ptr<IconAtlas> IconAtlas::forWindow(QQuickWindow *window)
+{
+    const auto context = QQuickWindowPrivate::get(window)->context;
+
+    if (Q_UNLIKELY(!context))
+        return {};
+
+    auto &registry = atlasRegistry();
+    const auto lock = QMutexLocker{&registry.mutex};
+
+    if (const auto atlas = registry.atlases.value(context))
+        return atlas;
+
+    const auto atlas = std::make_shared<IconAtlas>();
+    registry.atlases.insert(context, atlas);
+
+    // textures belong to the render context, its cells can be uploaded again once the context got initialized again
+    connect(context, &QSGRenderContext::invalidated, atlas.get(), [atlas = atlas.get()] {
+        atlas->releaseTextures();
+    }, Qt::DirectConnection);
+
+    // the context always gets invalidated before, therefore items may release the atlas on any thread afterwards
+    connect(context, &QObject::destroyed, atlas.get(), [context] {
+        auto &registry = atlasRegistry();
+        auto lock = QMutexLocker{&registry.mutex};
+        const auto lastReference = registry.atlases.take(context);
+        lock.unlock(); // the atlas might get destroyed now
+    }, Qt::DirectConnection);
+
+    return atlas;
+}
+
+IconAtlas::Cell IconAtlas::insert(const Key &key)
+{
+    if (key.size.width() > MaximumCellSize || key.size.height() > MaximumCellSize)
+        return {};
+
+    {
+        const auto lock = QMutexLocker{&m_mutex};
+
+        if (const auto cell = reference(key))
+            return *cell;
+    }
+
+    // rasterizing happens without holding the lock, so that render threads are not blocked meanwhile
+    const auto image = FontIconItem::render(key);
+    const auto pageKey = PageKey{key.icon.symbol().fontInfo().tag().value(), bucket(key.size)};
+
+    const auto lock = QMutexLocker{&m_mutex};
+
+    if (const auto cell = reference(key))
+        return *cell;
+
+    const auto cell = allocate(pageKey, key.size);
+
+    if (Q_UNLIKELY(!cell))
+        return {};
+
+    auto &page = m_pages[static_cast<std::size_t>(cell->page)];
+
+    {
+        auto painter = QPainter{&page.image};
+        painter.setCompositionMode(QPainter::CompositionMode_Source);
+        painter.drawImage(cell->rect.topLeft(), image);
+    }
+
+    page.dirtyRects.append(cell->rect);
+    ++page.references;
+
+    m_cells.insert(key, Entry{*cell, 1});
+    return *cell;
+}
+
+void IconAtlas::release(const Key &key)
+{
+    const auto lock = QMutexLocker{&m_mutex};
+
+    if (const auto it = m_cells.find(key); it != m_cells.end() && it->references > 0) {
+        --it->references;
+        --m_pages[static_cast<std::size_t>(it->cell.page)].references;
+    }
+}
+
+std::shared_ptr<QSGTexture> IconAtlas::texture(int page, QQuickWindow *window)
+{
+    auto lock = QMutexLocker{&m_mutex};
+    auto &currentPage = m_pages.at(static_cast<std::size_t>(page));
+
+    // nodes still showing textures of released pages keep references of their own
+    m_retiredTextures.clear();
+
+    if (currentPage.dirtyRects.isEmpty() && currentPage.texture)
+        return currentPage.texture;
+
+    if (QSGRendererInterface::isApiRhiBased(window->rendererInterface()->graphicsApi())) {
+        if (!currentPage.texture) {
+            currentPage.texture = std::make_shared<PageTexture>();
+            currentPage.dirtyRects = {currentPage.image.rect()};
+        }
+
+        const auto texture = static_cast<PageTexture *>(currentPage.texture.get());
+
+        for (const auto &rect : std::exchange(currentPage.dirtyRects, {}))
+            texture->upload(rect.topLeft(), currentPage.image.copy(rect));
+
+        return currentPage.texture;
+    }
+
+    // software textures cannot be updated, therefore the page gets replaced as a whole
+    const auto texture = window->createTextureFromImage(currentPage.image, QQuickWindow::TextureHasAlphaChannel);
+
+    currentPage.texture.reset(texture);
+    currentPage.dirtyRects.clear();
+
+    auto result = currentPage.texture;
+    lock.unlock();
+
+    emit textureChanged();
+    return result;
+}
+
+qint64 IconAtlas::trim()
+{
+    const auto lock = QMutexLocker{&m_mutex};
+    auto bytes = qint64{0};
+
+    // referenced cells are still shown by some item, all others get rasterized again when needed
+    m_cells.removeIf([](const auto &it) { return it.value().references == 0; });
+
+    for (auto it = m_pagesByKey.begin(); it != m_pagesByKey.end(); ) {
+        it->removeIf([this, &bytes](int index) {
+            if (m_pages[static_cast<std::size_t>(index)].references > 0)
+                return false;
+
+            bytes += releasePage(index);
+            return true;
+        });
+
+        it = it->isEmpty() ? m_pagesByKey.erase(it) : std::next(it);
+    }
+
+    return bytes;
+}
+
+qsizetype IconAtlas::pageCount() const
+{
+    const auto lock = QMutexLocker{&m_mutex};
+    return static_cast<qsizetype>(m_pages.size()) - m_unusedPages.size();
+}
+
+qsizetype IconAtlas::cellCount() const
+{
+    const auto lock = QMutexLocker{&m_mutex};
+    return m_cells.size();
+}
+
+int IconAtlas::bucket(const QSize &size) noexcept
+{
+    const auto extent = static_cast<unsigned>(std::max({size.width(), size.height(), MinimumBucket}));
+    return static_cast<int>(std::bit_ceil(extent));
+}
+
+std::optional<IconAtlas::Cell> IconAtlas::reference(const Key &key)
+{
+    const auto it = m_cells.find(key);
+
+    if (it == m_cells.end())
+        return {};
+
+    ++it->references;
+    ++m_pages[static_cast<std::size_t>(it->cell.page)].references;
+
+    return it->cell;
+}
+
+std::optional<IconAtlas::Cell> IconAtlas::allocate(const PageKey &pageKey, const QSize &size)
+{
+    auto &pageIndexes = m_pagesByKey[pageKey];
+
+    // cells are packed into shelves, which works well since the icons of one bucket are of similar size
+    const auto fits = [&size](const Page &page) {
+        if (page.cursor.x() + size.width() <= PageSize)
+            return page.cursor.y() + std::max(page.rowHeight, size.height()) <= PageSize;
+
+        return page.cursor.y() + page.rowHeight + size.height() <= PageSize;
+    };
+
+    if (pageIndexes.isEmpty() || !fits(m_pages[static_cast<std::size_t>(pageIndexes.constLast())])) {
+        // cells cannot be released one by one, but pages whose cells are not shown anymore get cleared for reuse
+        const auto isUnused = [this](int index) { return m_pages[static_cast<std::size_t>(index)].references == 0; };
+
+        if (const auto it = std::ranges::find_if(pageIndexes, isUnused); it != pageIndexes.end()) {
+            const auto index = *it;
+
+            pageIndexes.erase(it);
+            pageIndexes.append(index);
+            clearPage(index);
+        } else {
+            pageIndexes.append(createPage());
+        }
+    }
+
+    const auto index = pageIndexes.constLast();
+    auto &page = m_pages[static_cast<std::size_t>(index)];
+
+    if (page.cursor.x() + size.width() > PageSize) {
+        page.cursor = {0, page.cursor.y() + page.rowHeight};
+        page.rowHeight = 0;
+    }
+
+    // a pixel of padding keeps linear filtering from bleeding neighbors into cells
+    const auto rect = QRect{page.cursor, size};
+    page.cursor.rx() += size.width() + 1;
+    page.rowHeight = std::max(page.rowHeight, size.height() + 1);
+
+    return Cell{index, rect};
+}
+
+int IconAtlas::createPage()
+{
+    // the pixel layout of RGBA8 textures, so that cells can be uploaded without converting them
+    auto image = QImage{PageSize, PageSize, QImage::Format_RGBA8888_Premultiplied};
+    image.fill(Qt::transparent);
+
+    if (!m_unusedPages.isEmpty()) {
+        const auto index = m_unusedPages.takeLast();
+        m_pages[static_cast<std::size_t>(index)].image = std::move(image);
+        return index;
+    }
+
+    m_pages.push_back(Page{std::move(image)});
+    return static_cast<int>(m_pages.size()) - 1;
+}
+
+void IconAtlas::clearPage(int index)
+{
+    m_cells.removeIf([index](const auto &it) { return it.value().cell.page == index; });
+
+    auto &page = m_pages[static_cast<std::size_t>(index)];
+    page.image.fill(Qt::transparent);
+    page.cursor = {};
+    page.rowHeight = 0;
+    page.dirtyRects = {page.image.rect()};
+}
+
+// the cells of `index` must have been removed before
+qint64 IconAtlas::releasePage(int index)
+{
+    auto &page = m_pages[static_cast<std::size_t>(index)];
+    const auto bytes = page.image.sizeInBytes();
+
+    // trimming happens on the GUI thread, textures must only be deleted by the render thread
+    if (page.texture)
+        m_retiredTextures.push_back(std::move(page.texture));
+
+    page = Page{};
+    m_unusedPages.append(index);
+
+    return bytes;
+}
+
+void IconAtlas::releaseTextures()
+{
+    const auto lock = QMutexLocker{&m_mutex};
+
+    m_retiredTextures.clear();
+
+    for (auto &page : m_pages)
+        page.texture.reset();
+}
+
+// IconNode class // ===================================================================================================
+
+IconNode::IconNode(QSGImageNode *imageNode)
+    : m_imageNode{imageNode}
+{
+    m_imageNode->setOwnsTexture(false);
+    m_imageNode->setFiltering(QSGTexture::Linear);
+    appendChildNode(m_imageNode);
+}
+
+void IconNode::setTexture(std::shared_ptr<QSGTexture> texture, const QRectF &sourceRect, const QRectF &rect)
+{
+    if (m_texture != texture) {
+        m_imageNode->setTexture(texture.get());
+        m_texture = std::move(texture); // releases the previous texture only after the node stopped using it
+    }
+
+    if (m_imageNode->sourceRect() != sourceRect)
+        m_imageNode->setSourceRect(sourceRect);
+    if (m_imageNode->rect() != rect)
+        m_imageNode->setRect(rect);
+}
+
+} // namespace QuickIconFonts::Private
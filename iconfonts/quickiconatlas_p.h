@@ -0,0 +1,139 @@
+#ifndef QUICKICONFONTS_QUICKICONATLAS_P_H
+#define QUICKICONFONTS_QUICKICONATLAS_P_H
+
+#include "quickiconfonts.h"
+
+#include <QHash>
+#include <QImage>
+#include <QMutex>
+#include <QSGNode>
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+class QSGImageNode;
+class QSGTexture;
+
+namespace QuickIconFonts::Private {
+
+// IconAtlas class // ==================================================================================================
+
+// Packs the icons of all windows that share a render context into few textures, one per font and size bucket,
+// so that the scene graph renderer merges icons into few draw calls. Colors and predefined transforms are baked
+// into the cells, which keeps icons of any color or orientation in the same batch. Cells get added from the GUI
+// thread, the textures get created and updated from the render thread while synchronizing.
+//
+// Items reference the cells they show. Pages without referenced cells get reused for new cells of the same bucket,
+// and trimCaches() releases them, so that animated colors or sizes do not grow the atlas without bound.
+// The atlas lives as long as its render context, so that its textures always get released on the render thread.
+class QUICKICONFONTS_EXPORT IconAtlas final : public QObject
+{
+    Q_OBJECT
+
+public:
+    using Key = FontIconItem::RenderKey;
+
+    static constexpr auto PageSize = 512;
+    static constexpr auto MaximumCellSize = 128;    // larger icons get textures of their own
+
+    struct Cell
+    {
+        int   page = -1;
+        QRect rect;
+
+        [[nodiscard]] bool isValid() const noexcept { return page >= 0; }
+    };
+
+    // The atlas of the render context used by `window`.
+    [[nodiscard]] static std::shared_ptr<IconAtlas> forWindow(QQuickWindow *window);
+
+    // Returns the cell holding the icon of `key`, which gets rasterized if needed, and references it until release()
+    // gets called for `key`. Returns an invalid cell for icons that are too large for the atlas.
+    [[nodiscard]] Cell insert(const Key &key);
+    void release(const Key &key);
+
+    // Returns the texture of `page`, which gets created, or receives the cells added meanwhile.
+    // Must be called from the render thread while synchronizing.
+    [[nodiscard]] std::shared_ptr<QSGTexture> texture(int page, QQuickWindow *window);
+
+    // Drops the cells no item references, and releases the pages left without referenced cells.
+    // Returns the number of bytes released.
+    qint64 trim();
+
+    [[nodiscard]] qsizetype pageCount() const;
+    [[nodiscard]] qsizetype cellCount() const;
+
+signals:
+    // Items showing icons of an outdated texture should switch to the current one. Only the software renderer
+    // replaces textures, all other renderers upload new cells into the existing texture.
+    void textureChanged();
+
+private:
+    struct Page
+    {
+        QImage       image;             // null while the page is unused
+        QPoint       cursor;
+        int          rowHeight = 0;
+        int          references = 0;    // of all cells on this page
+        QList<QRect> dirtyRects;        // not uploaded yet
+
+        std::shared_ptr<QSGTexture> texture;
+    };
+
+    struct Entry
+    {
+        Cell cell;
+        int  references = 0;
+    };
+
+    struct PageKey
+    {
+        quint32 font;
+        int     bucket;
+
+        friend bool operator==(const PageKey &, const PageKey &) noexcept = default;
+        friend size_t qHash(const PageKey &key, size_t seed = 0) noexcept
+        { return qHashMulti(seed, key.font, key.bucket); }
+    };
+
+    [[nodiscard]] static int bucket(const QSize &size) noexcept;
+    [[nodiscard]] std::optional<Cell> reference(const Key &key);
+    [[nodiscard]] std::optional<Cell> allocate(const PageKey &pageKey, const QSize &size);
+    [[nodiscard]] int createPage();
+    void clearPage(int index);
+    qint64 releasePage(int index);
+    void releaseTextures();
+
+    mutable QMutex                           m_mutex;
+    std::vector<Page>                        m_pages;
+    QList<int>                               m_unusedPages;     // of `m_pages`, for createPage() to reuse
+    QHash<PageKey, QList<int>>               m_pagesByKey;
+    QHash<Key, Entry>                        m_cells;
+    std::vector<std::shared_ptr<QSGTexture>> m_retiredTextures; // of released pages, deleted by the render thread
+};
+
+// IconNode class // ===================================================================================================
+
+// Keeps the texture of an icon alive while the node shows it. With the software renderer textures of the atlas get
+// replaced when new cells get added, but nodes still showing the previous texture keep using it until their item
+// got synchronized again.
+class IconNode final : public QSGNode
+{
+public:
+    explicit IconNode(QSGImageNode *imageNode);
+
+    [[nodiscard]] std::shared_ptr<QSGTexture> texture() const noexcept { return m_texture; }
+    void setTexture(std::shared_ptr<QSGTexture> texture, const QRectF &sourceRect, const QRectF &rect);
+    [[nodiscard]] bool isAtlased() const noexcept { return m_atlased; }
+    void setAtlased(bool atlased) noexcept { m_atlased = atlased; }
+
+private:
+    QSGImageNode               *m_imageNode;
+    std::shared_ptr<QSGTexture> m_texture;
+    bool                        m_atlased = false;
+};
+
+} // namespace QuickIconFonts::Private
+
+#endif // QUICKICONFONTS_QUICKICONATLAS_P_H
@@ -1,6 +1,11 @@
 #include "quickiconfonts.h"
+#include "quickiconatlas_p.h"
 
+#include <QPainter>
+#include <QQmlInfo>
 #include <QQuickWindow>
+#include <QSGImageNode>
+#include <QtMath>
 
 #include <QtQuick/private/qquickitem_p.h>
 #include <QtQuick/private/qquickpalette_p.h>
@@ -132,4 +137,295 @@ QColor DrawIconOptions::effectiveColor(const QQuickItem *item, const QColor &ico
     return m_options.effectiveColor(iconColor, makeColorResolver(item), iconMode(item, active));
 }
 
+// FontIconItem class // ===============================================================================================
+
+FontIconItem::FontIconItem(QQuickItem *parent)
+    : QQuickItem{parent}
+{
+    setFlag(ItemHasContents);
+    updateEffectiveColor();
+}
+
+FontIconItem::~FontIconItem()
+{
+    releaseCell();
+}
+
+void FontIconItem::setIcon(const FontIcon &newIcon)
+{
+    if (IconFonts::FontIcon{newIcon} == IconFonts::FontIcon{m_icon})
+        return;
+
+    m_icon = newIcon;
+    updateEffectiveColor();
+    scheduleUpdate();
+
+    emit iconChanged();
+}
+
+void FontIconItem::setOptions(const DrawIconOptions &newOptions)
+{
+    if (IconFonts::DrawIconOptions{newOptions} == IconFonts::DrawIconOptions{m_options})
+        return;
+
+    m_options = newOptions;
+    updateEffectiveColor();
+    scheduleUpdate();
+
+    emit optionsChanged();
+}
+
+bool FontIconItem::isActive() const
+{
+    return m_active.value_or(QuickIconFonts::isActive(this));
+}
+
+void FontIconItem::setActive(bool newActive)
+{
+    if (std::exchange(m_active, newActive) == newActive)
+        return;
+
+    updateEffectiveColor();
+    emit activeChanged();
+}
+
+void FontIconItem::resetActive()
+{
+    const auto oldActive = isActive();
+    m_active.reset();
+
+    if (isActive() != oldActive) {
+        updateEffectiveColor();
+        emit activeChanged();
+    }
+}
+
+bool FontIconItem::event(QEvent *event)
+{
+    switch (event->type()) {
+    case QEvent::ApplicationPaletteChange:
+    case QEvent::PaletteChange:
+        updateEffectiveColor();
+        break;
+
+    default:
+        break;
+    }
+
+    return QQuickItem::event(event);
+}
+
+void FontIconItem::geometryChange(const QRectF &newGeometry, const QRectF &oldGeometry)
+{
+    QQuickItem::geometryChange(newGeometry, oldGeometry);
+
+    if (newGeometry.size() != oldGeometry.size())
+        scheduleUpdate();
+}
+
+void FontIconItem::itemChange(ItemChange change, const ItemChangeData &value)
+{
+    QQuickItem::itemChange(change, value);
+
+    switch (change) {
+    case ItemSceneChange:
+        disconnect(std::exchange(m_windowConnection, {}));
+
+        // the atlas of the new window gets picked when polishing
+        releaseCell();
+
+        if (m_atlas)
+            disconnect(std::exchange(m_atlas, {}).get(), nullptr, this, nullptr);
+
+        if (value.window) {
+            scheduleUpdate();
+
+            m_windowConnection = connect(value.window, &QQuickWindow::activeChanged, this, [this] {
+                if (!m_active.has_value()) {
+                    updateEffectiveColor();
+                    emit activeChanged();
+                }
+            });
+        }
+
+        // the new window might be active, or might provide a different palette
+        updateEffectiveColor();
+
+        if (!m_active.has_value())
+            emit activeChanged();
+
+        break;
+
+    case ItemEnabledHasChanged:
+        updateEffectiveColor();
+        break;
+
+    case ItemDevicePixelRatioHasChanged:
+        scheduleUpdate();
+        break;
+
+    default:
+        break;
+    }
+}
+
+FontIconItem::RenderKey FontIconItem::renderKey() const
+{
+    const auto devicePixelRatio = window() ? window()->effectiveDevicePixelRatio() : qreal{1};
+
+    // the effective color already reflects mode and palette, so the icon just gets painted in that color
+    auto options = IconFonts::DrawIconOptions{m_options};
+    options.applyColor = true;
+    options.mode = IconFonts::DrawIconOptions::Normal;
+
+    // like the Text item previously used, icons fill the item unless the options ask for a specific size
+    if (!options.pixelSize && !options.pointSize)
+        options.fillBox = true;
+
+    return {
+        .icon               = IconFonts::FontIcon{m_icon, m_effectiveColor},
+        .options            = std::move(options),
+        .size               = QSize{qCeil(width() * devicePixelRatio), qCeil(height() * devicePixelRatio)},
+        .devicePixelRatio   = devicePixelRatio,
+    };
+}
+
+QImage FontIconItem::render(const RenderKey &key)
+{
+    auto image = QImage{key.size, QImage::Format_ARGB32_Premultiplied};
+    image.setDevicePixelRatio(key.devicePixelRatio);
+    image.fill(Qt::transparent);
+
+    {
+        auto painter = QPainter{&image};
+        key.icon.draw(&painter, image.deviceIndependentSize(), {}, key.options);
+    }
+
+    return image;
+}
+
+void FontIconItem::scheduleUpdate()
+{
+    // the icon gets rasterized while polishing, so that the render thread only uploads textures
+    polish();
+    update();
+}
+
+void FontIconItem::updateEffectiveColor()
+{
+    // resolving the color walks the palette and the item's state, which is too much work for each frame or binding
+    const auto newColor = m_options.effectiveColor(this, m_icon.color(), isActive());
+
+    if (std::exchange(m_effectiveColor, newColor) == newColor)
+        return;
+
+    scheduleUpdate();
+    emit effectiveColorChanged();
+}
+
+void FontIconItem::releaseCell()
+{
+    if (m_atlas && m_cell.page >= 0)
+        m_atlas->release(m_key);
+
+    m_cell = {};
+}
+
+void FontIconItem::updatePolish()
+{
+    auto key = renderKey();
+    auto cell = AtlasCell{};
+
+    if (!key.icon.isNull() && !key.size.isEmpty()) {
+        if (!m_atlas && window()) {
+            if ((m_atlas = Private::IconAtlas::forWindow(window())))
+                connect(m_atlas.get(), &Private::IconAtlas::textureChanged, this, &FontIconItem::update);
+        }
+
+        if (m_atlas) {
+            if (const auto atlasCell = m_atlas->insert(key); atlasCell.isValid())
+                cell = {atlasCell.page, atlasCell.rect};
+        }
+    }
+
+    // the previous cell only gets released now, so that it is not dropped when the key did not change
+    releaseCell();
+
+    m_key = std::move(key);
+    m_cell = std::move(cell);
+}
+
+QSGNode *FontIconItem::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *)
+{
+    auto node = static_cast<Private::IconNode *>(oldNode);
+
+    if (m_key.icon.isNull() || m_key.size.isEmpty()) {
+        m_renderedKey = {};
+        delete node;
+        return nullptr;
+    }
+
+    if (!node)
+        node = new Private::IconNode{window()->createImageNode()};
+
+    if (m_atlas && m_cell.page >= 0) {
+        // all icons of an atlas page share one texture and material, which allows the renderer to batch them
+        node->setTexture(m_atlas->texture(m_cell.page, window()), m_cell.rect, boundingRect());
+        node->setAtlased(true);
+        m_renderedKey = {};
+    } else if (m_key != m_renderedKey || node->isAtlased()) {
+        // icons too large for the atlas get textures of their own, which are reused until the key changes
+        const auto texture = window()->createTextureFromImage(render(m_key), QQuickWindow::TextureHasAlphaChannel);
+        node->setTexture(std::shared_ptr<QSGTexture>{texture}, QRectF{QPointF{}, m_key.size}, boundingRect());
+        node->setAtlased(false);
+        m_renderedKey = m_key;
+    } else {
+        node->setTexture(node->texture(), QRectF{QPointF{}, m_key.size}, boundingRect());
+    }
+
+    return node;
+}
+
+// SymbolModel class // ================================================================================================
+
+QStringList SymbolModel::fontNames() const
+{
+    auto names = QStringList{};
+
+    for (const auto &font : fonts())
+        names.append(font.fontName());
+
+    return names;
+}
+
+void SymbolModel::setFontNames(const QStringList &newFontNames)
+{
+    auto newFonts = QList<IconFonts::FontInfo>{};
+    newFonts.reserve(newFontNames.size());
+
+    for (const auto &name : newFontNames) {
+        if (const auto font = IconFonts::FontInfo::fromName(name); font.isValid())
+            newFonts.append(font);
+        else
+            qmlWarning(this) << "Unknown font: " << name;
+    }
+
+    setFonts(newFonts);
+}
+
+QVariant SymbolModel::data(const IconFonts::Symbol &symbol, int role) const
+{
+    // QML works with the value types of this module
+    switch (role) {
+    case FontIconRole:
+        return QVariant::fromValue(FontIcon{IconFonts::FontIcon{symbol}});
+
+    case SymbolRole:
+        return QVariant::fromValue(Symbol{symbol});
+
+    default:
+        return IconFonts::SymbolModel::data(symbol, role);
+    }
+}
+
 } // namespace QuickIconFonts
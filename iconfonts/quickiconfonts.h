@@ -2,12 +2,19 @@
 #define QUICKICONFONTS_H
 
 #include <iconfonts/iconfonts.h>
+#include <iconfonts/symbolmodel.h>
 
 #include <QMatrix4x4>
 #include <QQuickItem>
 
+#include <memory>
+
 namespace QuickIconFonts {
 
+namespace Private {
+class IconAtlas;
+} // namespace Private
+
 class QUICKICONFONTS_EXPORT Symbol
 {
     Q_GADGET
@@ -143,6 +150,7 @@ class QUICKICONFONTS_EXPORT DrawIconOptions
     Q_PROPERTY(bool                    hasPixelSize READ hasPixelSize CONSTANT FINAL)
     Q_PROPERTY(int                        pixelSize READ pixelSize    CONSTANT FINAL)
     Q_PROPERTY(bool                      applyColor READ applyColor   CONSTANT FINAL)
+    Q_PROPERTY(bool                   distanceField READ distanceField CONSTANT FINAL)
     Q_PROPERTY(bool                         hasMode READ hasMode      CONSTANT FINAL)
     Q_PROPERTY(QuickIconFonts::IconMode::Value mode READ mode         CONSTANT FINAL)
 
@@ -157,6 +165,7 @@ public:
     [[nodiscard]] bool           hasPixelSize() const { return m_options.pixelSize.has_value(); }
     [[nodiscard]] int               pixelSize() const { return m_options.pixelSize.value_or(0); }
     [[nodiscard]] bool             applyColor() const { return m_options.applyColor;            }
+    [[nodiscard]] bool          distanceField() const { return m_options.distanceField;         }
     [[nodiscard]] bool                hasMode() const { return m_options.mode.has_value();      }
     [[nodiscard]] inline IconMode::Value mode() const;
 
@@ -174,6 +183,136 @@ inline IconMode::Value DrawIconOptions::mode() const
     return IconMode::fromQIcon(m_options.mode.value_or(QIcon::Normal));
 }
 
+// FontIconItem class // ===============================================================================================
+
+// Displays a font icon. Unlike a composition of QML items this item produces a single scene graph node, which only
+// gets rasterized again when the icon, its effective color, or the item's size actually change. The effective color is
+// cached, and only resolved again when the palette, or the enabled or active state of the item change.
+class QUICKICONFONTS_EXPORT FontIconItem : public QQuickItem
+{
+    Q_OBJECT
+    Q_PROPERTY(QuickIconFonts::FontIcon           icon READ icon     WRITE setIcon    NOTIFY iconChanged    FINAL)
+    Q_PROPERTY(QuickIconFonts::DrawIconOptions options READ options  WRITE setOptions NOTIFY optionsChanged FINAL)
+    Q_PROPERTY(bool active READ isActive WRITE setActive RESET resetActive NOTIFY activeChanged FINAL)
+    Q_PROPERTY(QColor effectiveColor READ effectiveColor NOTIFY effectiveColorChanged FINAL)
+
+    QML_NAMED_ELEMENT(FontIcon)
+
+public:
+    explicit FontIconItem(QQuickItem *parent = nullptr);
+    ~FontIconItem() override;
+
+    [[nodiscard]] FontIcon icon() const { return m_icon; }
+    void setIcon(const FontIcon &newIcon);
+
+    [[nodiscard]] DrawIconOptions options() const { return m_options; }
+    void setOptions(const DrawIconOptions &newOptions);
+
+    // Items embedded in QQuickWidget do not have a native window attached. Therefore their palette is inactive
+    // all the time. This property allows overriding the active state, so that a proper palette is picked.
+    [[nodiscard]] bool isActive() const;
+    void setActive(bool newActive);
+    void resetActive();
+
+    // The color in which the icon is painted, considering its options, the palette, and the item's state. Unlike
+    // DrawIconOptions::effectiveColor() this is only resolved again when one of them changed.
+    [[nodiscard]] QColor effectiveColor() const { return m_effectiveColor; }
+
+signals:
+    void iconChanged();
+    void optionsChanged();
+    void activeChanged();
+    void effectiveColorChanged();
+
+protected:
+    bool event(QEvent *event) override;
+    void geometryChange(const QRectF &newGeometry, const QRectF &oldGeometry) override;
+    void itemChange(ItemChange change, const ItemChangeData &value) override;
+    void updatePolish() override;
+    QSGNode *updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *) override;
+
+private:
+    friend class Private::IconAtlas;
+
+    struct RenderKey
+    {
+        IconFonts::FontIcon        icon;    // carries the effective color
+        IconFonts::DrawIconOptions options;
+        QSize                      size;    // in device pixels
+        qreal                      devicePixelRatio = 1;
+
+        friend bool operator==(const RenderKey &, const RenderKey &) = default;
+
+        friend size_t qHash(const RenderKey &key, size_t seed = 0) noexcept
+        { return qHashMulti(seed, key.icon, key.size.width(), key.size.height()); }
+    };
+
+    struct AtlasCell
+    {
+        int   page = -1;
+        QRect rect;
+    };
+
+    void scheduleUpdate();
+    void updateEffectiveColor();
+    void releaseCell();
+
+    [[nodiscard]] RenderKey renderKey() const;
+    [[nodiscard]] static QImage render(const RenderKey &key);
+
+    FontIcon                m_icon;
+    DrawIconOptions         m_options;
+    std::optional<bool>     m_active;
+    QColor                  m_effectiveColor;
+    QMetaObject::Connection m_windowConnection;
+
+    RenderKey                           m_key;          // updated while polishing
+    AtlasCell                           m_cell;         // where the atlas holds `m_key`, referenced until released
+    std::shared_ptr<Private::IconAtlas> m_atlas;
+    RenderKey                           m_renderedKey;  // of the texture this item created on its own
+};
+
+// SymbolModel class // ================================================================================================
+
+// Exposes IconFonts::SymbolModel to QML, where fonts are given by their name or family.
+class QUICKICONFONTS_EXPORT SymbolModel : public IconFonts::SymbolModel
+{
+    Q_OBJECT
+    Q_PROPERTY(QStringList fontNames READ fontNames WRITE setFontNames NOTIFY fontsChanged FINAL)
+    Q_PROPERTY(int       symbolCount READ symbolCount                  NOTIFY fontsChanged FINAL)
+
+    QML_ELEMENT
+
+public:
+    using IconFonts::SymbolModel::SymbolModel;
+
+    [[nodiscard]] QStringList fontNames() const;
+    void setFontNames(const QStringList &newFontNames);
+
+    using IconFonts::SymbolModel::data;
+    [[nodiscard]] QVariant data(const IconFonts::Symbol &symbol, int role) const override;
+};
+
+// SymbolFilterModel class // ==========================================================================================
+
+class QUICKICONFONTS_EXPORT SymbolFilterModel : public IconFonts::SymbolFilterModel
+{
+    Q_OBJECT
+    Q_PROPERTY(QuickIconFonts::SymbolModel *sourceModel READ sourceModel WRITE setSourceModel
+               NOTIFY sourceModelChanged FINAL)
+
+    QML_ELEMENT
+
+public:
+    using IconFonts::SymbolFilterModel::SymbolFilterModel;
+
+    [[nodiscard]] SymbolModel *sourceModel() const
+    { return qobject_cast<SymbolModel *>(IconFonts::SymbolFilterModel::sourceModel()); }
+
+    void setSourceModel(SymbolModel *newSourceModel)
+    { IconFonts::SymbolFilterModel::setSourceModel(newSourceModel); }
+};
+
 } // namespace QuickIconFonts
 
 #endif // QUICKICONFONTS_H
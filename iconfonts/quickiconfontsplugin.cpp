@@ -0,0 +1,36 @@
+#include "quickimageprovider.h"
+
+#include <QQmlEngine>
+#include <QQmlEngineExtensionPlugin>
+
+void qml_register_types_IconFonts();
+
+// IconFontsPlugin class // ============================================================================================
+
+// Not put into a namespace, so that static builds can import the plugin by its plain class name.
+class IconFontsPlugin final : public QQmlEngineExtensionPlugin
+{
+    Q_OBJECT
+    Q_PLUGIN_METADATA(IID QQmlEngineExtensionInterface_iid)
+
+public:
+    explicit IconFontsPlugin(QObject *parent = nullptr)
+        : QQmlEngineExtensionPlugin{parent}
+    {
+        // keeps the linker from dropping the type registrations of the backing library
+        volatile auto registration = &qml_register_types_IconFonts;
+        Q_UNUSED(registration);
+    }
+
+    void initializeEngine(QQmlEngine *engine, const char *uri) override
+    {
+        using QuickIconFonts::FontIconImageProvider;
+
+        Q_UNUSED(uri);
+
+        if (const auto id = QString::fromLatin1(FontIconImageProvider::ProviderId); !engine->imageProvider(id))
+            engine->addImageProvider(id, new FontIconImageProvider);
+    }
+};
+
+#include "quickiconfontsplugin.moc"
@@ -0,0 +1,180 @@
+#include "quickimageprovider.h"
+
+#include <iconfonts/symbolindex.h>
+
+#include <QMetaEnum>
+#include <QUrlQuery>
+
+#include <atomic>
+
+namespace QuickIconFonts {
+
+using namespace Qt::StringLiterals;
+
+namespace {
+
+using IconFonts::FontInfo;
+using IconFonts::FontTag;
+using IconFonts::Symbol;
+
+[[nodiscard]] FontInfo fontForName(QStringView name)
+{
+    auto ok = false;
+
+    // numeric tags also identify fonts registered at runtime, which are not among the known fonts
+    if (const auto index = name.toUInt(&ok); ok) {
+        if (index < FontTag::minimum() || index > FontTag::maximum())
+            return {};
+
+        return FontInfo::fromTag(FontTag::fromValue(index << FontTag::shift()));
+    }
+
+    return FontInfo::fromName(name);
+}
+
+[[nodiscard]] Symbol symbolForName(const FontInfo &font, QStringView name)
+{
+    if (name.startsWith("U+"_L1, Qt::CaseInsensitive) || name.startsWith("0x"_L1, Qt::CaseInsensitive)) {
+        auto ok = false;
+
+        if (const auto unicode = name.sliced(2).toUInt(&ok, 16); ok && font.hasGlyph(unicode))
+            return Symbol{font, static_cast<char32_t>(unicode)};
+
+        return {};
+    }
+
+    const auto key = name.toUtf8();
+
+    for (const auto &symbol : IconFonts::SymbolIndex::instance().find(key)) {
+        if (symbol.fontInfo() == font)
+            return symbol;
+    }
+
+    // fonts registered at runtime are not covered by the index
+    if (font.isDynamic()) {
+        for (auto i = 0; i < font.symbolCount(); ++i) {
+            if (key == font.key(i))
+                return font.symbol(i);
+        }
+    }
+
+    return {};
+}
+
+// FontIconImageResponse class // ======================================================================================
+
+class FontIconImageResponse final : public QQuickImageResponse
+{
+public:
+    explicit FontIconImageResponse(QString errorString = {})
+        : m_errorString{std::move(errorString)}
+    {}
+
+    QQuickTextureFactory *textureFactory() const override
+    { return QQuickTextureFactory::textureFactoryForImage(m_image); }
+
+    QString errorString() const override { return m_errorString; }
+
+    void cancel() override { m_cancelled = true; }
+
+    void rasterize(const IconFonts::FontIcon &icon, const QSize &size)
+    {
+        // responses that got cancelled while queued are not rasterized anymore
+        if (!m_cancelled)
+            m_image = icon.toImage(size);
+
+        emit finished();
+    }
+
+private:
+    QImage            m_image;
+    QString           m_errorString;
+    std::atomic<bool> m_cancelled = false;
+};
+
+} // namespace
+
+// FontIconImageProvider class // ======================================================================================
+
+FontIconImageProvider::FontIconImageProvider()
+{
+    m_threadPool.setObjectName(u"IconFonts"_s);
+}
+
+QQuickImageResponse *FontIconImageProvider::requestImageResponse(const QString &id, const QSize &requestedSize)
+{
+    const auto icon = iconForId(id);
+
+    if (icon.isNull()) {
+        const auto response = new FontIconImageResponse{uR"(Unknown font icon: "%1")"_s.arg(id)};
+        QMetaObject::invokeMethod(response, &QQuickImageResponse::finished, Qt::QueuedConnection);
+        return response;
+    }
+
+    // like QIcon, only the missing extent gets derived from the other
+    auto size = requestedSize;
+
+    if (size.width() <= 0 && size.height() <= 0)
+        size = DefaultSize;
+    else if (size.width() <= 0)
+        size.setWidth(size.height());
+    else if (size.height() <= 0)
+        size.setHeight(size.width());
+
+    const auto response = new FontIconImageResponse{};
+
+    // the engine deletes the response only once it has finished, which is the last thing the task does
+    m_threadPool.start([response, icon, size] {
+        response->rasterize(icon, size);
+    });
+
+    return response;
+}
+
+IconFonts::FontIcon FontIconImageProvider::iconForId(const QString &id)
+{
+    const auto url = QUrl{id};
+    const auto path = url.path(QUrl::FullyDecoded).split(u'/');
+
+    if (path.size() != 2)
+        return {};
+
+    const auto font = fontForName(path[0]);
+
+    if (!font.isValid())
+        return {};
+
+    const auto symbol = symbolForName(font, path[1]);
+
+    if (symbol.isNull())
+        return {};
+
+    const auto query = QUrlQuery{url};
+    auto icon = IconFonts::FontIcon{symbol};
+
+    if (query.hasQueryItem(u"color"_s)) {
+        const auto color = QColor::fromString(query.queryItemValue(u"color"_s, QUrl::FullyDecoded));
+
+        if (!color.isValid())
+            return {};
+
+        icon = IconFonts::FontIcon{icon, color};
+    }
+
+    if (query.hasQueryItem(u"transform"_s)) {
+        const auto transformName = query.queryItemValue(u"transform"_s, QUrl::FullyDecoded).toLatin1();
+        const auto transformEnum = QMetaEnum::fromType<IconFonts::FontIcon::Transform>();
+
+        auto ok = false;
+        const auto transform = transformEnum.keyToValue(transformName.constData(), &ok);
+
+        if (!ok || transform == qToUnderlying(IconFonts::FontIcon::Transform::Matrix))
+            return {};
+
+        icon = IconFonts::FontIcon{icon, static_cast<IconFonts::FontIcon::Transform>(transform)};
+    }
+
+    return icon;
+}
+
+} // namespace QuickIconFonts
@@ -0,0 +1,36 @@
+#ifndef QUICKICONFONTS_QUICKIMAGEPROVIDER_H
+#define QUICKICONFONTS_QUICKIMAGEPROVIDER_H
+
+#include <iconfonts/iconfonts.h>
+
+#include <QQuickAsyncImageProvider>
+#include <QThreadPool>
+
+namespace QuickIconFonts {
+
+// FontIconImageProvider class // ======================================================================================
+
+// Provides font icons to QML elements that only accept image URLs, like "image://iconfonts/<font>/<symbol>". The font
+// is given by its tag, name or family, the symbol by its name or codepoint, like "U+E87C". The query can give a
+// "color", and a "transform" like "HorizontalFlip". Images get rasterized on a thread pool, at the requested size,
+// which the Image element already scaled by the device pixel ratio. The IconFonts QML module registers this provider.
+class QUICKICONFONTS_EXPORT FontIconImageProvider : public QQuickAsyncImageProvider
+{
+public:
+    static constexpr auto ProviderId = "iconfonts";
+    static constexpr auto DefaultSize = QSize{32, 32};
+
+    FontIconImageProvider();
+
+    QQuickImageResponse *requestImageResponse(const QString &id, const QSize &requestedSize) override;
+
+    // Parses the `id` of an image URL, which is everything after "image://iconfonts/".
+    [[nodiscard]] static IconFonts::FontIcon iconForId(const QString &id);
+
+private:
+    QThreadPool m_threadPool;
+};
+
+} // namespace QuickIconFonts
+
+#endif // QUICKICONFONTS_QUICKIMAGEPROVIDER_H
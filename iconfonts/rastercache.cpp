@@ -0,0 +1,352 @@
+#include "rastercache_p.h"
+#include "iconfonts_p.h"
+
+#include <QDir>
+#include <QLockFile>
+#include <QRawFont>
+#include <QStandardPaths>
+
+#include <array>
+#include <cstring>
+
+namespace IconFonts {
+
+using namespace Private;
+using namespace Qt::StringLiterals;
+
+namespace Private {
+namespace {
+
+constexpr auto Magic = std::array{'I', 'F', 'R', 'C'};
+constexpr auto FormatVersion = quint32{1};
+constexpr auto Alignment = qint64{16};                         // keeps pixel data aligned within the mapping
+constexpr auto MaximumFileSize = qint64{64} * 1024 * 1024;    // larger files get started from scratch
+constexpr auto LockTimeout = 100;                               // milliseconds
+
+struct FileHeader
+{
+    std::array<char, 4> magic = Magic;
+    quint32 version = FormatVersion;
+    quint32 reserved[2] = {};
+};
+
+// followed by the pixel data, padded to `Alignment`
+struct RecordHeader
+{
+    RasterCache::Key key;
+    quint32 format;
+    quint32 bytesPerLine;
+};
+
+static_assert(sizeof(FileHeader) == Alignment);
+static_assert(sizeof(RecordHeader) % Alignment == 0);
+
+[[nodiscard]] constexpr qint64 aligned(qint64 offset) noexcept
+{
+    return (offset + Alignment - 1) & ~(Alignment - 1);
+}
+
+[[nodiscard]] QString lockFileName(const QFile &file)
+{
+    return file.fileName() + ".lock"_L1;
+}
+
+struct SharedCache
+{
+    QMutex mutex;
+    std::shared_ptr<RasterCache> cache;
+};
+
+[[nodiscard]] SharedCache &sharedCache()
+{
+    static auto s_instance = SharedCache{};
+    return s_instance;
+}
+
+} // namespace
+
+// RasterCache class // ================================================================================================
+
+RasterCache::RasterCache(const QString &fileName)
+    : m_file{fileName}
+{
+    // keeps the order of records, and never competes with painting for more than one core
+    m_writer.setMaxThreadCount(1);
+
+    if (!open() && m_file.isOpen())
+        m_file.close();
+}
+
+RasterCache::~RasterCache()
+{
+    waitForPendingWrites();
+}
+
+std::shared_ptr<RasterCache> RasterCache::instance()
+{
+    auto &shared = sharedCache();
+    const auto lock = QMutexLocker{&shared.mutex};
+    return shared.cache;
+}
+
+bool RasterCache::enable(const QString &directory)
+{
+    const auto path = directory.isEmpty()
+            ? QStandardPaths::writableLocation(QStandardPaths::CacheLocation)
+            : directory;
+
+    if (path.isEmpty() || !QDir{}.mkpath(path)) {
+        qCWarning(lcIconFonts, R"(Cannot create raster cache in "%ls")", qUtf16Printable(path));
+        return false;
+    }
+
+    // rasters depend on both, this library and Qt, therefore each version gets its own file
+    const auto fileName = u"iconfonts-%1-qt%2.rasters"_s.arg(QLatin1StringView{ICONFONTS_VERSION},
+                                                            QLatin1StringView{QT_VERSION_STR});
+
+    auto cache = std::make_shared<RasterCache>(QDir{path}.filePath(fileName));
+
+    if (!cache->isValid())
+        return false;
+
+    auto &shared = sharedCache();
+    const auto lock = QMutexLocker{&shared.mutex};
+    shared.cache = std::move(cache);
+
+    return true;
+}
+
+void RasterCache::disable()
+{
+    auto &shared = sharedCache();
+    const auto lock = QMutexLocker{&shared.mutex};
+    shared.cache.reset();
+}
+
+quint64 RasterCache::fingerprint(const FontInfo &font)
+{
+    static auto s_fingerprints = FontTagCache<quint64>{};
+
+    return s_fingerprints.find(font.tag(), [&font] {
+        const auto rawFont = QRawFont::fromFont(font.font());
+
+        // the head table holds the font's revision, checksum and modification time
+        return stableHash(rawFont.fontTable("head"), stableHash(rawFont.familyName().toUtf8()));
+    });
+}
+
+QImage RasterCache::wrapPixels(const Key &key, quint32 format, quint32 bytesPerLine,
+                               const uchar *pixels, qint64 available)
+{
+    const auto imageFormat = static_cast<QImage::Format>(format);
+
+    if (key.width == 0 || key.height == 0
+            || imageFormat <= QImage::Format_Invalid || imageFormat >= QImage::NImageFormats)
+        return {};
+
+    const auto bitsPerLine = qint64{key.width} * QImage::toPixelFormat(imageFormat).bitsPerPixel();
+
+    if (qint64{bytesPerLine} * 8 < bitsPerLine || bytesPerLine % 4 != 0
+            || qint64{bytesPerLine} * key.height > available)
+        return {};
+
+    return QImage{pixels, key.width, key.height, static_cast<qsizetype>(bytesPerLine), imageFormat};
+}
+
+QImage RasterCache::find(const Key &key) const
+{
+    const auto lock = QMutexLocker{&m_mutex};
+
+    if (const auto it = m_images.constFind(key); it != m_images.cend())
+        return *it;
+
+    return m_addedImages.value(key);
+}
+
+void RasterCache::insert(const Key &key, const QImage &image)
+{
+    if (Q_UNLIKELY(!isValid() || image.isNull()))
+        return;
+
+    const auto size = aligned(qint64{sizeof(RecordHeader)} + image.sizeInBytes());
+
+    {
+        const auto lock = QMutexLocker{&m_mutex};
+
+        if (m_images.contains(key) || m_addedKeys.contains(key))
+            return;
+
+        // a raster that cannot be written would never get mapped, keeping it would only grow memory
+        if (m_fileSize + size > MaximumFileSize) {
+            if (size <= MaximumFileSize - qint64{sizeof(FileHeader)} && !std::exchange(m_limitReached, true)) {
+                qCWarning(lcIconFonts, R"(Raster cache "%ls" is full, new rasters are not kept)",
+                          qUtf16Printable(m_file.fileName()));
+            }
+
+            return;
+        }
+
+        m_fileSize += size;
+        m_addedKeys.insert(key);
+        m_addedImages.insert(key, image);
+    }
+
+    m_writer.start([this, key, image] { write(key, image); });
+}
+
+void RasterCache::waitForPendingWrites()
+{
+    m_writer.waitForDone();
+}
+
+qint64 RasterCache::trim()
+{
+    const auto lock = QMutexLocker{&m_mutex};
+    auto bytes = qint64{0};
+
+    // the rasters of the mapping are backed by the pack file, only rasters added meanwhile occupy memory
+    for (const auto &image : std::as_const(m_addedImages))
+        bytes += image.sizeInBytes();
+
+    m_addedImages.clear();
+    return bytes;
+}
+
+bool RasterCache::open()
+{
+    // other processes might be appending to the same file right now
+    auto lockFile = QLockFile{lockFileName(m_file)};
+
+    if (!lockFile.tryLock(LockTimeout)) {
+        qCWarning(lcIconFonts, R"(Cannot lock raster cache "%ls")", qUtf16Printable(m_file.fileName()));
+        return false;
+    }
+
+    if (!m_file.open(QFile::ReadWrite)) {
+        qCWarning(lcIconFonts, R"(Cannot open raster cache "%ls": %ls)",
+                  qUtf16Printable(m_file.fileName()), qUtf16Printable(m_file.errorString()));
+        return false;
+    }
+
+    auto fileSize = m_file.size();
+    auto header = FileHeader{};
+
+    if (m_file.read(reinterpret_cast<char *>(&header), sizeof(header)) != sizeof(header)
+            || header.magic != Magic || header.version != FormatVersion
+            || fileSize > MaximumFileSize) {
+        header = FileHeader{};
+
+        if (!m_file.resize(0) || !m_file.seek(0)
+                || m_file.write(reinterpret_cast<const char *>(&header), sizeof(header)) != sizeof(header)
+                || !m_file.flush()) {
+            qCWarning(lcIconFonts, R"(Cannot initialize raster cache "%ls": %ls)",
+                      qUtf16Printable(m_file.fileName()), qUtf16Printable(m_file.errorString()));
+            return false;
+        }
+
+        fileSize = sizeof(header);
+    }
+
+    m_data = m_file.map(0, fileSize);
+
+    // a previous launch might have been killed while writing: cut off its incomplete record
+    if (const auto end = readRecords(fileSize); m_data && end < fileSize) {
+        m_images.clear();
+        m_file.unmap(std::exchange(m_data, nullptr));
+
+        if (m_file.resize(end) && (m_data = m_file.map(0, end)))
+            std::ignore = readRecords(end);
+    }
+
+    if (Q_UNLIKELY(!m_data)) {
+        qCWarning(lcIconFonts, R"(Cannot map raster cache "%ls": %ls)",
+                  qUtf16Printable(m_file.fileName()), qUtf16Printable(m_file.errorString()));
+        return false;
+    }
+
+    m_fileSize = m_file.size();
+    return true;
+}
+
+qint64 RasterCache::readRecords(qint64 fileSize)
+{
+    if (Q_UNLIKELY(!m_data))
+        return 0;
+
+    auto offset = qint64{sizeof(FileHeader)};
+
+    while (offset + qint64{sizeof(RecordHeader)} <= fileSize) {
+        auto record = RecordHeader{};
+        std::memcpy(&record, m_data + offset, sizeof(record));
+
+        const auto dataOffset = offset + qint64{sizeof(RecordHeader)};
+        const auto dataSize = qint64{record.bytesPerLine} * record.key.height;
+
+        // the image refers to the mapped data read-only, nothing gets copied or decoded
+        auto image = wrapPixels(record.key, record.format, record.bytesPerLine,
+                                static_cast<const uchar *>(m_data) + dataOffset, fileSize - dataOffset);
+
+        if (image.isNull())
+            break;
+
+        m_images.insert(record.key, std::move(image));
+
+        offset = aligned(dataOffset + dataSize);
+    }
+
+    return std::min(offset, fileSize);
+}
+
+void RasterCache::write(const Key &key, const QImage &image)
+{
+    auto lockFile = QLockFile{lockFileName(m_file)};
+
+    if (!lockFile.tryLock(LockTimeout))
+        return; // losing a raster is cheaper than piling up writes
+
+    const auto record = RecordHeader{key, static_cast<quint32>(image.format()),
+                                     static_cast<quint32>(image.bytesPerLine())};
+
+    const auto offset = m_file.size(); // other processes might have appended meanwhile
+    const auto dataSize = qint64{image.sizeInBytes()};
+    const auto recordSize = qint64{sizeof(record)} + dataSize;
+    const auto padding = QByteArray(aligned(recordSize) - recordSize, '\0');
+
+    if (offset + recordSize + padding.size() > MaximumFileSize)
+        return;
+
+    if (!m_file.seek(offset)
+            || m_file.write(reinterpret_cast<const char *>(&record), sizeof(record)) != sizeof(record)
+            || m_file.write(reinterpret_cast<const char *>(image.constBits()), dataSize) != dataSize
+            || m_file.write(padding) != padding.size()
+            || !m_file.flush()) {
+        qCWarning(lcIconFonts, R"(Cannot write to raster cache "%ls": %ls)",
+                  qUtf16Printable(m_file.fileName()), qUtf16Printable(m_file.errorString()));
+
+        std::ignore = m_file.resize(offset);
+    }
+}
+
+qint64 trimRasterCache()
+{
+    if (const auto cache = RasterCache::instance())
+        return cache->trim();
+
+    return 0;
+}
+
+} // namespace Private
+
+// utility functions // ================================================================================================
+
+bool enableRasterCache(const QString &directory)
+{
+    return RasterCache::enable(directory);
+}
+
+void disableRasterCache()
+{
+    RasterCache::disable();
+}
+
+} // namespace IconFonts
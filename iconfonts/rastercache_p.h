@@ -0,0 +1,96 @@
+#ifndef ICONFONTS_RASTERCACHE_P_H
+#define ICONFONTS_RASTERCACHE_P_H
+
+#include "iconfonts.h"
+
+#include <QFile>
+#include <QHash>
+#include <QImage>
+#include <QMutex>
+#include <QSet>
+#include <QThreadPool>
+
+#include <memory>
+
+namespace IconFonts::Private {
+
+// RasterCache class // ================================================================================================
+
+// A persistent cache of rasterized icons, which survives application launches. Rasters get appended to a pack file,
+// which is memory-mapped when opening the cache, so that rasters of previous launches are served without any decoding.
+// New rasters are written in the background, and are served from memory until the next launch maps them, or until
+// trimCaches() releases them. The pack file is limited to 64 MiB and never evicts rasters: once full, the cache only
+// serves the rasters it holds, and new rasters are neither written nor kept. Deleting the file starts from scratch.
+class ICONFONTS_EXPORT RasterCache final
+{
+public:
+    struct Key
+    {
+        quint64 font      = 0;  // a fingerprint of the font's data, see `fingerprint()`
+        quint32 unicode   = 0;
+        QRgb    color     = 0;  // the effective color, as resolved from icon, mode and palette
+        quint16 width     = 0;  // the size in device pixels, which also covers the device pixel ratio
+        quint16 height    = 0;
+        quint8  transform = 0;
+        quint8  mode      = 0;
+        quint16 reserved  = 0;
+
+        friend bool operator==(const Key &, const Key &) noexcept = default;
+
+        friend size_t qHash(const Key &key, size_t seed = 0) noexcept
+        { return qHashBits(&key, sizeof(key), seed); }
+    };
+
+    explicit RasterCache(const QString &fileName);
+    ~RasterCache();
+
+    // The cache used for icons, or `nullptr` until enabled via `enableRasterCache()`.
+    [[nodiscard]] static std::shared_ptr<RasterCache> instance();
+    static bool enable(const QString &directory);
+    static void disable();
+
+    // Identifies the data of `font` across application launches.
+    [[nodiscard]] static quint64 fingerprint(const FontInfo &font);
+
+    // Wraps the pixel data of a record read-only, or returns a null image if the record is invalid, or if its pixels
+    // would exceed the `available` bytes.
+    [[nodiscard]] static QImage wrapPixels(const Key &key, quint32 format, quint32 bytesPerLine,
+                                           const uchar *pixels, qint64 available);
+
+    [[nodiscard]] bool isValid() const noexcept { return m_data != nullptr; }
+    [[nodiscard]] QString fileName() const { return m_file.fileName(); }
+
+    // Images found in the pack file point into its mapping: they must not outlive this cache.
+    [[nodiscard]] QImage find(const Key &key) const;
+    void insert(const Key &key, const QImage &image);
+    void waitForPendingWrites();
+
+    // Releases the rasters kept in memory, returns the number of bytes released.
+    qint64 trim();
+
+private:
+    [[nodiscard]] bool open();
+    [[nodiscard]] qint64 readRecords(qint64 fileSize);
+    void write(const Key &key, const QImage &image);
+
+    QFile        m_file;
+    uchar       *m_data = nullptr;
+
+    mutable QMutex     m_mutex;
+    QHash<Key, QImage> m_images;        // wrapping the records of the mapped pack file
+    QHash<Key, QImage> m_addedImages;   // rasterized since opening the cache, until trimmed
+    QSet<Key>          m_addedKeys;     // of all rasters appended since opening, to never append them twice
+    qint64             m_fileSize = 0;  // including the records still to be appended
+    bool               m_limitReached = false;
+    QThreadPool        m_writer;
+};
+
+// Releases the rasters that the raster cache keeps in memory.
+qint64 trimRasterCache();
+
+static_assert(sizeof(RasterCache::Key) == 24);
+static_assert(std::has_unique_object_representations_v<RasterCache::Key>);
+
+} // namespace IconFonts::Private
+
+#endif // ICONFONTS_RASTERCACHE_P_H
@@ -0,0 +1,393 @@
+#include "sharedrastercache_p.h"
+#include "iconfonts_p.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDeadlineTimer>
+#include <QScopeGuard>
+#include <QThread>
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstring>
+#include <optional>
+
+namespace IconFonts {
+
+using namespace Private;
+using namespace Qt::StringLiterals;
+
+namespace Private {
+namespace {
+
+constexpr auto Magic = std::array{'I', 'F', 'S', 'C'};
+constexpr auto FormatVersion = quint32{2};
+constexpr auto Alignment = quint64{16};                 // keeps pixel data aligned within the segment
+constexpr auto BytesPerSlot = quint64{4096};            // the slab's expected share of each slot
+constexpr auto MinimumSlotCount = quint64{64};
+constexpr auto MaximumProbeCount = quint64{32};         // a full neighborhood is treated like a full cache
+constexpr auto StaleResetTimeout = qint64{1000};        // milliseconds after which resets count as abandoned
+constexpr auto WriterTimeout = qint64{100};             // milliseconds a reset waits for inserting processes
+
+enum class State : quint32 {
+    Uninitialized = 0,                                  // fresh segments are zero-filled
+    Ready = 1,
+};
+
+// followed by the pixel data, padded to `Alignment`
+struct RecordHeader
+{
+    RasterCache::Key key;
+    quint32 format;
+    quint32 bytesPerLine;
+};
+
+static_assert(sizeof(RecordHeader) % Alignment == 0);
+static_assert(std::atomic_ref<quint32>::is_always_lock_free);
+static_assert(std::atomic_ref<quint64>::is_always_lock_free);
+
+[[nodiscard]] constexpr quint64 aligned(quint64 offset) noexcept
+{
+    return (offset + Alignment - 1) & ~(Alignment - 1);
+}
+
+// zero marks free slots, therefore it never is a valid hash
+[[nodiscard]] quint64 slotHash(const RasterCache::Key &key) noexcept
+{
+    const auto hash = stableHash({reinterpret_cast<const char *>(&key), sizeof(key)});
+    return std::max(hash, quint64{1});
+}
+
+struct SharedCache
+{
+    QMutex mutex;
+    std::shared_ptr<SharedRasterCache> cache;
+};
+
+[[nodiscard]] SharedCache &sharedCache()
+{
+    static auto s_instance = SharedCache{};
+    return s_instance;
+}
+
+} // namespace
+
+// The header is followed by `slotCount` slots, which are followed by the slab. Only `state`, `activeWriters`,
+// `slabUsed`, `generation`, `resetStarted`, and the slots are written after initialization, and they only get
+// accessed atomically.
+struct SharedRasterCache::Header
+{
+    std::array<char, 4> magic;
+    quint32 version;
+    State   state;
+    qint32  activeWriters;                              // processes inserting right now, resets wait for them
+    quint64 slotCount;                                  // always a power of two
+    quint64 slabOffset;
+    quint64 slabSize;
+    quint64 slabUsed;
+    quint64 generation;                                 // odd while the slots get reset
+    qint64  resetStarted;                               // milliseconds since epoch
+};
+
+struct SharedRasterCache::Slot
+{
+    quint64 hash;                                       // claimed by the first inserting process
+    quint64 offset;                                     // one past the record's offset, zero until published
+};
+
+// SharedRasterCache class // ==========================================================================================
+
+SharedRasterCache::SharedRasterCache(const QString &name, qsizetype size)
+    // shared memory cannot be migrated: each version of this library and Qt gets its own segment
+    : m_memory{u"iconfonts-%1-qt%2-%3"_s.arg(QLatin1StringView{ICONFONTS_VERSION},
+                                             QLatin1StringView{QT_VERSION_STR}, name)}
+{
+    if (!attach(size) && m_memory.isAttached())
+        m_memory.detach();
+}
+
+std::shared_ptr<SharedRasterCache> SharedRasterCache::instance()
+{
+    auto &shared = sharedCache();
+    const auto lock = QMutexLocker{&shared.mutex};
+    return shared.cache;
+}
+
+bool SharedRasterCache::enable(const QString &name, qsizetype size)
+{
+    auto cache = std::make_shared<SharedRasterCache>(name.isEmpty() ? QCoreApplication::applicationName() : name,
+                                                     size);
+
+    if (!cache->isValid())
+        return false;
+
+    auto &shared = sharedCache();
+    const auto lock = QMutexLocker{&shared.mutex};
+    shared.cache = std::move(cache);
+
+    return true;
+}
+
+void SharedRasterCache::disable()
+{
+    auto &shared = sharedCache();
+    const auto lock = QMutexLocker{&shared.mutex};
+    shared.cache.reset();
+}
+
+QImage SharedRasterCache::find(const Key &key) const
+{
+    if (Q_UNLIKELY(!isValid()))
+        return {};
+
+    const auto generation = std::atomic_ref{m_header->generation}.load(std::memory_order_acquire);
+
+    if (generation % 2 != 0)
+        return {};
+
+    const auto hash = slotHash(key);
+    const auto mask = m_header->slotCount - 1;
+
+    for (auto i = quint64{0}; i < MaximumProbeCount; ++i) {
+        auto &slot = slots()[(hash + i) & mask];
+        const auto claimedHash = std::atomic_ref{slot.hash}.load(std::memory_order_acquire);
+
+        if (claimedHash == 0)
+            return {};
+        if (claimedHash != hash)
+            continue;
+
+        // unpublished slots are still being written, or got abandoned by a crashed process
+        const auto offset = std::atomic_ref{slot.offset}.load(std::memory_order_acquire);
+
+        if (offset == 0 || offset - 1 + sizeof(RecordHeader) > m_header->slabSize)
+            continue;
+
+        auto record = RecordHeader{};
+        std::memcpy(&record, slab() + offset - 1, sizeof(record));
+
+        if (record.key != key)
+            continue;
+
+        const auto dataOffset = offset - 1 + sizeof(RecordHeader);
+        const auto available = static_cast<qint64>(m_header->slabSize - dataOffset);
+        const auto image = RasterCache::wrapPixels(key, record.format, record.bytesPerLine,
+                                                   slab() + dataOffset, available).copy();
+
+        // the copy is garbage if another process reset the cache while it got taken
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (std::atomic_ref{m_header->generation}.load(std::memory_order_relaxed) != generation)
+            return {};
+
+        return image;
+    }
+
+    return {};
+}
+
+void SharedRasterCache::insert(const Key &key, const QImage &image)
+{
+    if (Q_UNLIKELY(!isValid() || image.isNull()))
+        return;
+
+    // rasters that would not even fit into an empty slab must not reset the cache
+    if (aligned(sizeof(RecordHeader) + static_cast<quint64>(image.sizeInBytes())) > m_header->slabSize)
+        return;
+
+    if (const auto generation = tryInsert(key, image); generation && reset(*generation))
+        std::ignore = tryInsert(key, image);
+}
+
+std::optional<quint64> SharedRasterCache::tryInsert(const Key &key, const QImage &image)
+{
+    const auto activeWriters = std::atomic_ref{m_header->activeWriters};
+    activeWriters.fetch_add(1);
+
+    const auto leave = qScopeGuard([activeWriters] { activeWriters.fetch_sub(1, std::memory_order_release); });
+    const auto generation = std::atomic_ref{m_header->generation}.load();
+
+    if (generation % 2 != 0)
+        return generation; // another process is resetting the cache, or crashed while doing so
+
+    const auto hash = slotHash(key);
+    const auto mask = m_header->slotCount - 1;
+
+    for (auto i = quint64{0}; i < MaximumProbeCount; ++i) {
+        auto &slot = slots()[(hash + i) & mask];
+        auto claimedHash = quint64{0};
+
+        if (!std::atomic_ref{slot.hash}.compare_exchange_strong(claimedHash, hash, std::memory_order_acq_rel)) {
+            if (claimedHash == hash)
+                return {}; // another process already inserted this raster, or a raster of equal hash
+
+            continue;
+        }
+
+        const auto record = RecordHeader{key, static_cast<quint32>(image.format()),
+                                         static_cast<quint32>(image.bytesPerLine())};
+
+        const auto dataSize = static_cast<quint64>(image.sizeInBytes());
+        const auto recordSize = aligned(sizeof(record) + dataSize);
+        const auto offset = std::atomic_ref{m_header->slabUsed}.fetch_add(recordSize, std::memory_order_relaxed);
+
+        // the claimed slot stays unpublished until the reset clears it
+        if (offset + recordSize > m_header->slabSize)
+            return generation;
+
+        std::memcpy(slab() + offset, &record, sizeof(record));
+        std::memcpy(slab() + offset + sizeof(record), image.constBits(), dataSize);
+
+        // a reset that stopped waiting for this process might have cleared the slot meanwhile
+        if (std::atomic_ref{m_header->generation}.load(std::memory_order_acquire) == generation) {
+            auto unpublished = quint64{0};
+            std::atomic_ref{slot.offset}.compare_exchange_strong(unpublished, offset + 1, std::memory_order_release);
+        }
+
+        return {};
+    }
+
+    // the neighborhood is full, probably of slots claimed by processes that crashed before publishing them
+    return generation;
+}
+
+std::optional<quint64> SharedRasterCache::beginReset(quint64 generation)
+{
+    const auto now = QDateTime::currentMSecsSinceEpoch();
+    const auto resetStarted = std::atomic_ref{m_header->resetStarted};
+
+    // another process is resetting, unless it crashed while doing so
+    if (generation % 2 != 0 && now - resetStarted.load(std::memory_order_relaxed) < StaleResetTimeout)
+        return {};
+
+    const auto ownGeneration = generation + (generation % 2 != 0 ? 2 : 1);
+
+    resetStarted.store(now, std::memory_order_relaxed);
+
+    if (!std::atomic_ref{m_header->generation}.compare_exchange_strong(generation, ownGeneration))
+        return {};
+
+    return ownGeneration;
+}
+
+void SharedRasterCache::finishReset(quint64 ownGeneration)
+{
+    // lets inserting processes finish writing to the slab, but doesn't wait for the ones that crashed
+    const auto activeWriters = std::atomic_ref{m_header->activeWriters};
+
+    for (auto deadline = QDeadlineTimer{WriterTimeout}; activeWriters.load() > 0 && !deadline.hasExpired(); )
+        QThread::yieldCurrentThread();
+
+    for (auto i = quint64{0}; i < m_header->slotCount; ++i) {
+        std::atomic_ref{slots()[i].hash}.store(0, std::memory_order_relaxed);
+        std::atomic_ref{slots()[i].offset}.store(0, std::memory_order_relaxed);
+    }
+
+    std::atomic_ref{m_header->slabUsed}.store(0, std::memory_order_relaxed);
+
+    // only completes the reset if no other process took it over
+    std::atomic_ref{m_header->generation}.compare_exchange_strong(ownGeneration, ownGeneration + 1,
+                                                                  std::memory_order_release);
+}
+
+bool SharedRasterCache::reset(quint64 generation)
+{
+    const auto ownGeneration = beginReset(generation);
+
+    if (!ownGeneration)
+        return false;
+
+    finishReset(*ownGeneration);
+
+    qCDebug(lcIconFonts, R"(Shared raster cache "%ls" got reset)", qUtf16Printable(m_memory.key()));
+    return true;
+}
+
+bool SharedRasterCache::attach(qsizetype size)
+{
+    static_assert(sizeof(Header) % Alignment == 0);
+    static_assert(sizeof(Slot) == Alignment);
+
+    if (!m_memory.create(size)
+            && (m_memory.error() != QSharedMemory::AlreadyExists || !m_memory.attach())) {
+        qCWarning(lcIconFonts, R"(Cannot attach to shared raster cache "%ls": %ls)",
+                  qUtf16Printable(m_memory.key()), qUtf16Printable(m_memory.errorString()));
+        return false;
+    }
+
+    // the segment's actual size wins over the requested one when attaching to an existing segment
+    const auto segmentSize = static_cast<quint64>(m_memory.size());
+    const auto header = static_cast<Header *>(m_memory.data());
+
+    if (segmentSize < sizeof(Header) + MinimumSlotCount * (sizeof(Slot) + BytesPerSlot)) {
+        qCWarning(lcIconFonts, R"(Shared raster cache "%ls" is too small)", qUtf16Printable(m_memory.key()));
+        return false;
+    }
+
+    m_header = header;
+
+    // Processes racing for initializing the segment are serialized like resets. Unlike QSharedMemory::lock(),
+    // this does not block forever if the process that initializes the segment crashes while doing so.
+    for (auto deadline = QDeadlineTimer{2 * StaleResetTimeout};
+         std::atomic_ref{header->state}.load(std::memory_order_acquire) != State::Ready; QThread::msleep(1)) {
+        if (deadline.hasExpired()) {
+            qCWarning(lcIconFonts, R"(Cannot initialize shared raster cache "%ls")", qUtf16Printable(m_memory.key()));
+            m_header = nullptr;
+            return false;
+        }
+
+        const auto generation = std::atomic_ref{header->generation}.load();
+
+        if (const auto ownGeneration = beginReset(generation)) {
+            const auto slotCount = std::max(std::bit_floor(segmentSize / BytesPerSlot), MinimumSlotCount);
+            const auto slabOffset = sizeof(Header) + slotCount * sizeof(Slot);
+
+            header->magic = Magic;
+            header->version = FormatVersion;
+            header->slotCount = slotCount;
+            header->slabOffset = slabOffset;
+            header->slabSize = segmentSize - slabOffset;
+
+            std::atomic_ref{header->state}.store(State::Ready, std::memory_order_release);
+            finishReset(*ownGeneration);
+        }
+    }
+
+    if (header->magic != Magic || header->version != FormatVersion
+            || !std::has_single_bit(header->slotCount)
+            || header->slabOffset != sizeof(Header) + header->slotCount * sizeof(Slot)
+            || header->slabOffset + header->slabSize > segmentSize) {
+        qCWarning(lcIconFonts, R"(Shared raster cache "%ls" is incompatible)", qUtf16Printable(m_memory.key()));
+        m_header = nullptr;
+        return false;
+    }
+
+    return true;
+}
+
+SharedRasterCache::Slot *SharedRasterCache::slots() const noexcept
+{
+    return reinterpret_cast<Slot *>(m_header + 1);
+}
+
+uchar *SharedRasterCache::slab() const noexcept
+{
+    return reinterpret_cast<uchar *>(m_header) + m_header->slabOffset;
+}
+
+} // namespace Private
+
+// utility functions // ================================================================================================
+
+bool enableSharedRasterCache(const QString &name, qsizetype size)
+{
+    return SharedRasterCache::enable(name, size);
+}
+
+void disableSharedRasterCache()
+{
+    SharedRasterCache::disable();
+}
+
+} // namespace IconFonts
@@ -0,0 +1,61 @@
+#ifndef ICONFONTS_SHAREDRASTERCACHE_P_H
+#define ICONFONTS_SHAREDRASTERCACHE_P_H
+
+#include "rastercache_p.h"
+
+#include <QSharedMemory>
+
+#include <optional>
+
+namespace IconFonts::Private {
+
+// SharedRasterCache class // ==========================================================================================
+
+// A cache of rasterized icons in shared memory, which lets all processes that use the same name share their rasters.
+// The segment holds an open-addressing table of slots, followed by a slab from which records get bump-allocated.
+// Slots get claimed and published with atomic operations only, so lookups never block: a process that crashes while
+// inserting leaves behind an unpublished slot, which other processes simply skip. Once the slab is exhausted, or
+// the slots for a raster are taken, the process that notices bumps the segment's generation and resets all slots.
+// Lookups that overlap with a reset get discarded, and resets abandoned by crashed processes get taken over.
+class ICONFONTS_EXPORT SharedRasterCache final
+{
+public:
+    using Key = RasterCache::Key;
+
+    static constexpr qsizetype DefaultSize = 32 * 1024 * 1024;
+
+    explicit SharedRasterCache(const QString &name, qsizetype size = DefaultSize);
+
+    // The cache used for icons, or `nullptr` until enabled via `enableSharedRasterCache()`.
+    [[nodiscard]] static std::shared_ptr<SharedRasterCache> instance();
+    static bool enable(const QString &name, qsizetype size);
+    static void disable();
+
+    [[nodiscard]] bool isValid() const noexcept { return m_header != nullptr; }
+
+    // Returns a copy, the shared memory might get reset by other processes at any time.
+    [[nodiscard]] QImage find(const Key &key) const;
+    void insert(const Key &key, const QImage &image);
+
+private:
+    struct Header;
+    struct Slot;
+
+    [[nodiscard]] bool attach(qsizetype size);
+
+    // Returns the generation to reset, if the cache is exhausted.
+    [[nodiscard]] std::optional<quint64> tryInsert(const Key &key, const QImage &image);
+    [[nodiscard]] std::optional<quint64> beginReset(quint64 generation);
+    void finishReset(quint64 ownGeneration);
+    bool reset(quint64 generation);
+
+    [[nodiscard]] Slot *slots() const noexcept;
+    [[nodiscard]] uchar *slab() const noexcept;
+
+    QSharedMemory m_memory;
+    Header       *m_header = nullptr;
+};
+
+} // namespace IconFonts::Private
+
+#endif // ICONFONTS_SHAREDRASTERCACHE_P_H
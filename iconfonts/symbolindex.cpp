@@ -0,0 +1,151 @@
+#include "symbolindex.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace IconFonts {
+
+namespace {
+
+[[nodiscard]] constexpr bool isAlphaNumeric(char ch) noexcept
+{
+    return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9');
+}
+
+[[nodiscard]] constexpr char toLower(char ch) noexcept
+{
+    return (ch >= 'A' && ch <= 'Z') ? static_cast<char>(ch - 'A' + 'a') : ch;
+}
+
+void appendNormalized(QByteArray &pool, QByteArrayView name)
+{
+    for (const auto ch : name) {
+        if (isAlphaNumeric(ch))
+            pool.append(toLower(ch));
+    }
+}
+
+// compares `query`, normalized on the fly, with the already normalized `name`
+[[nodiscard]] int compareNormalized(QByteArrayView query, QByteArrayView name) noexcept
+{
+    auto it = name.begin();
+
+    for (const auto ch : query) {
+        if (!isAlphaNumeric(ch))
+            continue;
+        if (it == name.end())
+            return 1;
+        if (const auto lower = toLower(ch); lower != *it)
+            return lower < *it ? -1 : 1;
+
+        ++it;
+    }
+
+    return it == name.end() ? 0 : -1;
+}
+
+[[nodiscard]] auto symbolOrder(const Symbol &symbol) noexcept
+{
+    return std::pair{symbol.unicode(), symbol.fontInfo().tag().index()};
+}
+
+} // namespace
+
+SymbolIndex::SymbolIndex(const QList<FontInfo> &fonts)
+{
+    const auto totalCount = std::accumulate(fonts.cbegin(), fonts.cend(), qsizetype{0},
+                                            [](qsizetype count, const FontInfo &font) {
+        return count + font.symbolCount();
+    });
+
+    auto names = std::vector<Name>{};
+    auto symbols = std::vector<Symbol>{};
+
+    names.reserve(static_cast<std::size_t>(totalCount));
+    symbols.reserve(static_cast<std::size_t>(totalCount));
+
+    for (const auto &font : fonts) {
+        for (auto count = font.symbolCount(), i = 0; i < count; ++i) {
+            const auto offset = static_cast<quint32>(m_namePool.size());
+            appendNormalized(m_namePool, font.key(i));
+            const auto length = static_cast<quint32>(m_namePool.size()) - offset;
+
+            names.emplace_back(offset, length);
+            symbols.emplace_back(font, font.unicode(i));
+        }
+    }
+
+    m_namePool.squeeze();
+
+    // codepoints: aliases share their codepoint, therefore each symbol must be reported only once
+
+    m_symbolsByUnicode = symbols;
+    std::ranges::sort(m_symbolsByUnicode, {}, symbolOrder);
+    const auto duplicates = std::ranges::unique(m_symbolsByUnicode);
+    m_symbolsByUnicode.erase(duplicates.begin(), duplicates.end());
+    m_symbolsByUnicode.shrink_to_fit();
+
+    // names: sort by normalized name, and then like codepoints to report fonts in a stable order
+
+    auto order = std::vector<std::size_t>(symbols.size());
+    std::iota(order.begin(), order.end(), std::size_t{0});
+
+    std::ranges::sort(order, [&](std::size_t lhs, std::size_t rhs) {
+        if (const auto result = name(names[lhs]).compare(name(names[rhs])); result != 0)
+            return result < 0;
+
+        return symbolOrder(symbols[lhs]) < symbolOrder(symbols[rhs]);
+    });
+
+    m_names.reserve(order.size());
+    m_symbolsByName.reserve(order.size());
+
+    for (const auto index : order) {
+        if (!m_names.empty()
+                && m_symbolsByName.back() == symbols[index]
+                && name(m_names.back()) == name(names[index]))
+            continue; // names that only differ in case or punctuation
+
+        m_names.emplace_back(names[index]);
+        m_symbolsByName.emplace_back(symbols[index]);
+    }
+
+    m_names.shrink_to_fit();
+    m_symbolsByName.shrink_to_fit();
+}
+
+std::span<const Symbol> SymbolIndex::find(char32_t unicode) const noexcept
+{
+    const auto range = std::ranges::equal_range(m_symbolsByUnicode, unicode, {}, &Symbol::unicode);
+    return {range.begin(), range.end()};
+}
+
+std::span<const Symbol> SymbolIndex::find(QByteArrayView query) const noexcept
+{
+    const auto first = std::ranges::partition_point(m_names, [this, query](const Name &entry) {
+        return compareNormalized(query, name(entry)) > 0;
+    });
+
+    const auto last = std::ranges::partition_point(first, m_names.end(), [this, query](const Name &entry) {
+        return compareNormalized(query, name(entry)) == 0;
+    });
+
+    if (first == last)
+        return {};
+
+    const auto symbols = m_symbolsByName.data();
+    return {symbols + (first - m_names.begin()), symbols + (last - m_names.begin())};
+}
+
+QByteArrayView SymbolIndex::name(const Name &name) const noexcept
+{
+    return QByteArrayView{m_namePool}.sliced(name.offset, name.length);
+}
+
+const SymbolIndex &SymbolIndex::instance()
+{
+    static const auto s_instance = SymbolIndex{FontInfo::knownFonts()};
+    return s_instance;
+}
+
+} // namespace IconFonts
@@ -0,0 +1,53 @@
+#ifndef ICONFONTS_SYMBOLINDEX_H
+#define ICONFONTS_SYMBOLINDEX_H
+
+#include "iconfonts.h"
+
+#include <span>
+#include <vector>
+
+namespace IconFonts {
+
+// SymbolIndex class // ================================================================================================
+
+// Maps codepoints and symbol names to the symbols of all fonts providing them,
+// e.g. to find out which fonts contain "arrow-left", or U+F060.
+//
+// Names are normalized by ignoring case and anything but letters and digits,
+// so that "arrow-left", "arrow_left" and "ArrowLeft" all find the same symbols.
+// Queries neither allocate, nor do they build the per-font lookup tables of FontInfo.
+class ICONFONTS_EXPORT SymbolIndex final
+{
+public:
+    SymbolIndex() noexcept = default;
+    explicit SymbolIndex(const QList<FontInfo> &fonts);
+
+    [[nodiscard]] std::span<const Symbol> find(char32_t unicode) const noexcept;
+    [[nodiscard]] std::span<const Symbol> find(QByteArrayView name) const noexcept;
+
+    [[nodiscard]] bool isEmpty() const noexcept { return m_symbolsByUnicode.empty(); }
+    [[nodiscard]] qsizetype nameCount() const noexcept { return static_cast<qsizetype>(m_names.size()); }
+    [[nodiscard]] qsizetype symbolCount() const noexcept { return static_cast<qsizetype>(m_symbolsByUnicode.size()); }
+
+    // built once on first use, covers all the fonts of FontInfo::knownFonts();
+    // construct a separate index for fonts registered at runtime
+    [[nodiscard]] static const SymbolIndex &instance();
+
+private:
+    struct Name
+    {
+        quint32 offset;
+        quint32 length;
+    };
+
+    [[nodiscard]] QByteArrayView name(const Name &name) const noexcept;
+
+    std::vector<Symbol> m_symbolsByUnicode;
+    std::vector<Symbol> m_symbolsByName;
+    std::vector<Name>   m_names;        // normalized names of `m_symbolsByName`
+    QByteArray          m_namePool;
+};
+
+} // namespace IconFonts
+
+#endif // ICONFONTS_SYMBOLINDEX_H
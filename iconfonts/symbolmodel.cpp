@@ -0,0 +1,479 @@
+#include "symbolmodel.h"
+
+#include <QFuture>
+#include <QHash>
+#include <QMutex>
+#include <QPromise>
+#include <QThreadPool>
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <optional>
+
+namespace IconFonts {
+
+using namespace Qt::StringLiterals;
+
+namespace {
+
+// Maps the trigrams of a font's symbol names to the symbols containing them. Filters of three or more characters
+// then only compare the names of those symbols that contain each of the filter's trigrams.
+class TrigramIndex
+{
+public:
+    explicit TrigramIndex(const FontInfo &font)
+    {
+        for (auto count = font.symbolCount(), i = 0; i < count; ++i) {
+            const auto key = QByteArrayView{font.key(i)};
+
+            for (auto j = qsizetype{2}; j < key.size(); ++j) {
+                auto &symbols = m_symbols[trigram(key.data() + j - 2)];
+
+                // names repeating a trigram list their symbol only once
+                if (symbols.isEmpty() || symbols.constLast() != i)
+                    symbols.append(i);
+            }
+        }
+    }
+
+    // The symbols whose name might contain `filter`, sorted by their index. Nothing if the index cannot tell,
+    // because the filter is too short.
+    [[nodiscard]] std::optional<QList<int>> candidates(QByteArrayView filter) const
+    {
+        if (filter.size() < 3)
+            return {};
+
+        auto postings = QList<const QList<int> *>{};
+        postings.reserve(filter.size() - 2);
+
+        for (auto j = qsizetype{2}; j < filter.size(); ++j) {
+            const auto it = m_symbols.constFind(trigram(filter.data() + j - 2));
+
+            if (it == m_symbols.cend())
+                return QList<int>{};
+
+            postings.append(&*it);
+        }
+
+        // intersecting the shortest lists first keeps the intermediate results small
+        std::ranges::sort(postings, {}, &QList<int>::size);
+
+        auto symbols = *postings.constFirst();
+
+        for (const auto list : std::as_const(postings).sliced(1)) {
+            auto intersection = QList<int>{};
+            std::ranges::set_intersection(symbols, *list, std::back_inserter(intersection));
+            symbols = std::move(intersection);
+
+            if (symbols.isEmpty())
+                break;
+        }
+
+        return symbols;
+    }
+
+    // Built once per font, on first use, from whichever thread needs it first.
+    [[nodiscard]] static std::shared_ptr<const TrigramIndex> forFont(const FontInfo &font)
+    {
+        static auto s_mutex = QMutex{};
+        static auto s_indexes = QList<std::pair<FontInfo, std::shared_ptr<const TrigramIndex>>>{};
+
+        const auto lock = QMutexLocker{&s_mutex};
+
+        for (const auto &[indexedFont, index] : std::as_const(s_indexes)) {
+            if (indexedFont == font)
+                return index;
+        }
+
+        return s_indexes.emplaceBack(font, std::make_shared<const TrigramIndex>(font)).second;
+    }
+
+private:
+    [[nodiscard]] static constexpr quint32 toLower(char ch)
+    {
+        return static_cast<uchar>(ch >= 'A' && ch <= 'Z' ? ch - 'A' + 'a' : ch);
+    }
+
+    [[nodiscard]] static constexpr quint32 trigram(const char *text)
+    {
+        return toLower(text[0]) << 16 | toLower(text[1]) << 8 | toLower(text[2]);
+    }
+
+    QHash<quint32, QList<int>> m_symbols;
+};
+
+[[nodiscard]] bool matches(const FontInfo &font, int index, const QString &filter)
+{
+    const auto key = font.key(index);
+    return key && QLatin1StringView{key}.contains(filter, Qt::CaseInsensitive);
+}
+
+// Runs on the thread pool, therefore only reads the fonts' immutable symbol tables.
+[[nodiscard]] QList<int> matchingRows(const QList<FontInfo> &fonts, const QString &filter)
+{
+    // the trigram index only folds the case of ASCII letters, other filters are compared with each name
+    const auto isAscii = std::ranges::all_of(filter, [](QChar ch) { return ch.unicode() < 0x80; });
+    const auto asciiFilter = isAscii ? filter.toLatin1() : QByteArray{};
+
+    auto rows = QList<int>{};
+    auto offset = 0;
+
+    for (const auto &font : fonts) {
+        const auto count = font.symbolCount();
+
+        if (const auto candidates = isAscii ? TrigramIndex::forFont(font)->candidates(asciiFilter) : std::nullopt) {
+            for (const auto i : *candidates) {
+                if (matches(font, i, filter))
+                    rows.append(offset + i);
+            }
+        } else {
+            for (auto i = 0; i < count; ++i) {
+                if (matches(font, i, filter))
+                    rows.append(offset + i);
+            }
+        }
+
+        offset += count;
+    }
+
+    return rows;
+}
+
+// Symbols matching a refined filter also matched the previous filter, so only the previous matches are compared.
+[[nodiscard]] QList<int> refinedRows(const QList<FontInfo> &fonts, const QList<int> &previousRows,
+                                     const QString &filter)
+{
+    auto rows = QList<int>{};
+    auto font = fonts.cbegin();
+    auto offset = 0;
+
+    for (const auto row : previousRows) {
+        while (font != fonts.cend() && row >= offset + font->symbolCount())
+            offset += (font++)->symbolCount();
+
+        if (font == fonts.cend())
+            break;
+
+        if (matches(*font, row - offset, filter))
+            rows.append(row);
+    }
+
+    return rows;
+}
+
+} // namespace
+
+// SymbolModel class // ================================================================================================
+
+SymbolModel::SymbolModel(QObject *parent)
+    : QAbstractListModel{parent}
+{}
+
+void SymbolModel::setFonts(const QList<FontInfo> &newFonts)
+{
+    if (newFonts == m_fonts)
+        return;
+
+    beginResetModel();
+
+    m_fonts = newFonts;
+    m_offsets.clear();
+    m_offsets.reserve(m_fonts.size());
+
+    auto offset = 0;
+
+    for (const auto &font : std::as_const(m_fonts))
+        m_offsets.append(offset += font.symbolCount());
+
+    m_fetchedCount = std::min(symbolCount(), FetchSize);
+
+    endResetModel();
+
+    emit fontsChanged();
+}
+
+Symbol SymbolModel::symbol(int row) const
+{
+    if (row < 0 || row >= symbolCount())
+        return {};
+
+    // the offsets are sorted, the first one past `row` belongs to the font of that row
+    const auto it = std::upper_bound(m_offsets.cbegin(), m_offsets.cend(), row);
+    const auto fontIndex = static_cast<qsizetype>(it - m_offsets.cbegin());
+    const auto firstRow = (fontIndex > 0 ? m_offsets[fontIndex - 1] : 0);
+
+    return m_fonts[fontIndex].symbol(row - firstRow);
+}
+
+QVariant SymbolModel::data(const Symbol &symbol, int role) const
+{
+    if (symbol.isNull())
+        return {};
+
+    switch (role) {
+    case Qt::DisplayRole:
+    case Qt::ToolTipRole:
+    case NameRole:
+        return symbol.name();
+
+    case Qt::DecorationRole:
+        return FontIcon{symbol}.toIcon();
+
+    case CodepointRole:
+        return static_cast<uint>(symbol.unicode());
+
+    case TextRole:
+        return symbol.toString();
+
+    case TagRole:
+        return symbol.tag().value();
+
+    case FontIconRole:
+        return QVariant::fromValue(FontIcon{symbol});
+
+    case SymbolRole:
+        return QVariant::fromValue(symbol);
+    }
+
+    return {};
+}
+
+int SymbolModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+
+    return m_fetchedCount;
+}
+
+QVariant SymbolModel::data(const QModelIndex &index, int role) const
+{
+    if (!checkIndex(index, CheckIndexOption::IndexIsValid | CheckIndexOption::ParentIsInvalid))
+        return {};
+
+    return data(symbol(index.row()), role);
+}
+
+QHash<int, QByteArray> SymbolModel::roleNames() const
+{
+    auto roleNames = QAbstractListModel::roleNames();
+
+    roleNames.insert(NameRole,      "name"_ba);
+    roleNames.insert(CodepointRole, "codepoint"_ba);
+    roleNames.insert(TextRole,      "text"_ba);
+    roleNames.insert(TagRole,       "tag"_ba);
+    roleNames.insert(FontIconRole,  "fonticon"_ba);
+    roleNames.insert(SymbolRole,    "symbol"_ba);
+
+    return roleNames;
+}
+
+bool SymbolModel::canFetchMore(const QModelIndex &parent) const
+{
+    return !parent.isValid() && m_fetchedCount < symbolCount();
+}
+
+void SymbolModel::fetchMore(const QModelIndex &parent)
+{
+    if (!canFetchMore(parent))
+        return;
+
+    const auto count = std::min(symbolCount() - m_fetchedCount, FetchSize);
+
+    beginInsertRows({}, m_fetchedCount, m_fetchedCount + count - 1);
+    m_fetchedCount += count;
+    endInsertRows();
+}
+
+// SymbolFilterModel class // ==========================================================================================
+
+SymbolFilterModel::SymbolFilterModel(QObject *parent)
+    : QAbstractListModel{parent}
+{
+    m_timer.setSingleShot(true);
+    connect(&m_timer, &QTimer::timeout, this, &SymbolFilterModel::startMatching);
+}
+
+void SymbolFilterModel::setSourceModel(SymbolModel *newSourceModel)
+{
+    if (newSourceModel == m_sourceModel)
+        return;
+
+    if (m_sourceModel)
+        disconnect(m_sourceModel, nullptr, this, nullptr);
+
+    m_sourceModel = newSourceModel;
+    clearMatches();
+
+    if (m_sourceModel) {
+        connect(m_sourceModel, &SymbolModel::fontsChanged, this, [this] {
+            clearMatches();
+            refilter();
+        });
+
+        connect(m_sourceModel, &QObject::destroyed, this, [this] { setMatches({}, {}); });
+    }
+
+    refilter();
+    emit sourceModelChanged();
+}
+
+void SymbolFilterModel::setFilter(const QString &newFilter)
+{
+    if (std::exchange(m_filter, newFilter) == newFilter)
+        return;
+
+    refilter();
+    emit filterChanged(m_filter);
+}
+
+void SymbolFilterModel::setDelay(std::chrono::milliseconds newDelay)
+{
+    m_timer.setInterval(newDelay);
+}
+
+std::chrono::milliseconds SymbolFilterModel::delay() const
+{
+    return m_timer.intervalAsDuration();
+}
+
+int SymbolFilterModel::row(int sourceRow) const
+{
+    // the matches are sorted by their source row
+    const auto it = std::lower_bound(m_sourceRows.cbegin(), m_sourceRows.cend(), sourceRow);
+
+    if (it == m_sourceRows.cend() || *it != sourceRow)
+        return -1;
+
+    return static_cast<int>(it - m_sourceRows.cbegin());
+}
+
+int SymbolFilterModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+
+    return m_fetchedCount;
+}
+
+QVariant SymbolFilterModel::data(const QModelIndex &index, int role) const
+{
+    if (!checkIndex(index, CheckIndexOption::IndexIsValid | CheckIndexOption::ParentIsInvalid) || !m_sourceModel)
+        return {};
+
+    return m_sourceModel->data(m_sourceModel->symbol(sourceRow(index.row())), role);
+}
+
+QHash<int, QByteArray> SymbolFilterModel::roleNames() const
+{
+    if (m_sourceModel)
+        return m_sourceModel->roleNames();
+
+    return QAbstractListModel::roleNames();
+}
+
+bool SymbolFilterModel::canFetchMore(const QModelIndex &parent) const
+{
+    return !parent.isValid() && m_fetchedCount < matchCount();
+}
+
+void SymbolFilterModel::fetchMore(const QModelIndex &parent)
+{
+    if (!canFetchMore(parent))
+        return;
+
+    const auto count = std::min(matchCount() - m_fetchedCount, SymbolModel::FetchSize);
+
+    beginInsertRows({}, m_fetchedCount, m_fetchedCount + count - 1);
+    m_fetchedCount += count;
+    endInsertRows();
+}
+
+void SymbolFilterModel::refilter()
+{
+    ++m_generation;
+    m_timer.stop();
+
+    if (!m_sourceModel) {
+        setMatches({}, {});
+        return;
+    }
+
+    // without filter there is nothing to match, which keeps showing all symbols cheap
+    if (m_filter.isEmpty()) {
+        auto sourceRows = QList<int>(m_sourceModel->symbolCount());
+        std::iota(sourceRows.begin(), sourceRows.end(), 0);
+        setMatches(sourceRows, {});
+        return;
+    }
+
+    setFiltering(true);
+
+    // typing quickly only matches the last filter
+    if (m_timer.interval() > 0)
+        m_timer.start();
+    else
+        startMatching();
+}
+
+void SymbolFilterModel::startMatching()
+{
+    if (!m_sourceModel) {
+        setMatches({}, {});
+        return;
+    }
+
+    const auto generation = m_generation;
+    const auto refine = !m_matchedFilter.isEmpty() && m_filter.contains(m_matchedFilter, Qt::CaseInsensitive);
+
+    auto promise = std::make_shared<QPromise<QList<int>>>();
+    auto future = promise->future();
+
+    promise->start();
+
+    QThreadPool::globalInstance()->start([promise, fonts = m_sourceModel->fonts(), filter = m_filter,
+                                          previousRows = refine ? m_sourceRows : QList<int>{}, refine] {
+        promise->addResult(refine ? refinedRows(fonts, previousRows, filter) : matchingRows(fonts, filter));
+        promise->finish();
+    });
+
+    future.then(this, [this, generation, filter = m_filter](const QList<int> &sourceRows) {
+        if (generation == m_generation)
+            setMatches(sourceRows, filter);
+    });
+}
+
+void SymbolFilterModel::setMatches(const QList<int> &sourceRows, const QString &matchedFilter)
+{
+    beginResetModel();
+
+    m_sourceRows = sourceRows;
+    m_matchedFilter = matchedFilter;
+    m_fetchedCount = std::min(matchCount(), SymbolModel::FetchSize);
+
+    endResetModel();
+
+    setFiltering(false);
+}
+
+void SymbolFilterModel::clearMatches()
+{
+    // the previous matches are rows of other symbols now, they must not be shown until matching finished
+    beginResetModel();
+
+    m_sourceRows.clear();
+    m_matchedFilter.clear();
+    m_fetchedCount = 0;
+
+    endResetModel();
+}
+
+void SymbolFilterModel::setFiltering(bool newFiltering)
+{
+    if (std::exchange(m_filtering, newFiltering) != newFiltering)
+        emit filteringChanged(m_filtering);
+}
+
+} // namespace IconFonts
@@ -0,0 +1,131 @@
+#ifndef ICONFONTS_SYMBOLMODEL_H
+#define ICONFONTS_SYMBOLMODEL_H
+
+#include "iconfonts.h"
+
+#include <QAbstractListModel>
+#include <QPointer>
+#include <QTimer>
+
+#include <chrono>
+
+namespace IconFonts {
+
+// SymbolModel class // ================================================================================================
+
+// Lists the symbols of one or more fonts, one after the other. Nothing but the row count gets computed in advance,
+// all roles are read from the font's symbol tables when views ask for them. Rows get added in batches via fetchMore(),
+// so that views populate as they scroll.
+class ICONFONTS_EXPORT SymbolModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum Role {
+        NameRole = Qt::UserRole,
+        CodepointRole,
+        TextRole,
+        TagRole,
+        FontIconRole,
+        SymbolRole,
+    };
+
+    Q_ENUM(Role)
+
+    static constexpr auto FetchSize = 256;
+
+    explicit SymbolModel(QObject *parent = nullptr);
+
+    void setFonts(const QList<FontInfo> &newFonts);
+    [[nodiscard]] QList<FontInfo> fonts() const { return m_fonts; }
+
+    // Counts all the symbols of the fonts, including rows that were not fetched yet.
+    [[nodiscard]] int symbolCount() const noexcept { return m_offsets.isEmpty() ? 0 : m_offsets.constLast(); }
+    [[nodiscard]] Symbol symbol(int row) const;
+
+    // Data of a symbol for `role`, also for rows that were not fetched yet.
+    [[nodiscard]] virtual QVariant data(const Symbol &symbol, int role) const;
+
+    int rowCount(const QModelIndex &parent = {}) const override;
+    QVariant data(const QModelIndex &index, int role) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+
+signals:
+    void fontsChanged();
+
+private:
+    QList<FontInfo> m_fonts;
+    QList<int>      m_offsets;  // rows after the symbols of each font
+    int             m_fetchedCount = 0;
+};
+
+// SymbolFilterModel class // ==========================================================================================
+
+// Lists the symbols of a SymbolModel whose name contains the filter text. The symbols get matched on a thread pool,
+// the model keeps listing the previous matches until that finished, unless the fonts of the source model changed.
+// Just like SymbolModel, rows get fetched in batches.
+//
+// Filters of three or more characters are looked up in an index of the trigrams in each font's symbol names, which is
+// built on first use. Filters that refine the previous filter, like when typing, only check the previous matches.
+class ICONFONTS_EXPORT SymbolFilterModel : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(QString filter READ filter WRITE setFilter NOTIFY filterChanged FINAL)
+    Q_PROPERTY(bool filtering READ isFiltering NOTIFY filteringChanged FINAL)
+
+public:
+    explicit SymbolFilterModel(QObject *parent = nullptr);
+
+    void setSourceModel(SymbolModel *newSourceModel);
+    [[nodiscard]] SymbolModel *sourceModel() const { return m_sourceModel; }
+
+    void setFilter(const QString &newFilter);
+    [[nodiscard]] QString filter() const { return m_filter; }
+
+    [[nodiscard]] bool isFiltering() const { return m_filtering; }
+
+    // Waits this long after the last change of the filter before matching, so that typing doesn't start a match for
+    // each keystroke. Without delay, which is the default, matching starts immediately.
+    void setDelay(std::chrono::milliseconds newDelay);
+    [[nodiscard]] std::chrono::milliseconds delay() const;
+
+    // Counts all matching symbols, including rows that were not fetched yet.
+    [[nodiscard]] int matchCount() const noexcept { return static_cast<int>(m_sourceRows.size()); }
+    [[nodiscard]] int sourceRow(int row) const { return m_sourceRows.value(row, -1); }
+    [[nodiscard]] int row(int sourceRow) const;   // -1 if that symbol doesn't match
+
+    int rowCount(const QModelIndex &parent = {}) const override;
+    QVariant data(const QModelIndex &index, int role) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+
+signals:
+    void sourceModelChanged();
+    void filterChanged(const QString &filter);
+    void filteringChanged(bool filtering);
+
+private:
+    void refilter();
+    void startMatching();
+    void setMatches(const QList<int> &sourceRows, const QString &matchedFilter);
+    void clearMatches();
+    void setFiltering(bool newFiltering);
+
+    QPointer<SymbolModel> m_sourceModel;
+    QString               m_filter;
+    QString               m_matchedFilter;      // the filter that `m_sourceRows` matched, if any
+    QList<int>            m_sourceRows;
+    QTimer                m_timer;
+    int                   m_fetchedCount = 0;
+    int                   m_generation = 0;    // drops results of outdated filters
+    bool                  m_filtering = false;
+};
+
+} // namespace IconFonts
+
+#endif // ICONFONTS_SYMBOLMODEL_H
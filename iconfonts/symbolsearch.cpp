@@ -0,0 +1,475 @@
+#include "symbolsearch.h"
+
+#include <QHash>
+#include <QVarLengthArray>
+
+#include <algorithm>
+
+namespace IconFonts {
+
+namespace {
+
+constexpr auto MaxQueryWords    = 8;
+constexpr auto MinPrefixLength  = 2;    // single characters would visit much of the index
+constexpr auto MinTypoLength    = 4;    // shorter words are too similar to each other for typos to make sense
+constexpr auto MaxWordLength    = 64;
+
+constexpr auto TagFlag          = 1u;   // marks postings of tags, names are ranked higher
+
+enum Score : int
+{
+    ExactName   = 100,
+    ExactTag    = 60,
+    PrefixName  = 70,
+    PrefixTag   = 40,
+    TypoName    = 50,
+    TypoTag     = 30,
+    MaxPenalty  = 20,                   // for each character a prefix misses, capped to keep prefixes over typos
+};
+
+using WordBuffer = QVarLengthArray<char, MaxWordLength>;
+
+[[nodiscard]] constexpr bool isAlphaNumeric(char ch) noexcept
+{
+    return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9');
+}
+
+[[nodiscard]] constexpr bool isUpper(char ch) noexcept
+{
+    return ch >= 'A' && ch <= 'Z';
+}
+
+[[nodiscard]] constexpr bool isDigit(char ch) noexcept
+{
+    return ch >= '0' && ch <= '9';
+}
+
+[[nodiscard]] constexpr char toLower(char ch) noexcept
+{
+    return isUpper(ch) ? static_cast<char>(ch - 'A' + 'a') : ch;
+}
+
+[[nodiscard]] constexpr char toAscii(char ch) noexcept
+{
+    return ch;
+}
+
+[[nodiscard]] constexpr char toAscii(QChar ch) noexcept
+{
+    return ch.unicode() < 0x80 ? static_cast<char>(ch.unicode()) : '\0';
+}
+
+[[nodiscard]] quint32 hashTerm(QByteArrayView term) noexcept
+{
+    return static_cast<quint32>(qHash(term, 0));
+}
+
+// reports `term` with each of its characters deleted once
+template<typename Function>
+void forEachDeletion(QByteArrayView term, Function &&function)
+{
+    auto buffer = WordBuffer{};
+
+    for (auto i = qsizetype{0}; i < term.size(); ++i) {
+        if (i > 0 && term[i] == term[i - 1])
+            continue; // deleting either of two equal characters gives the same variant
+
+        buffer.clear();
+        buffer.append(term.data(), i);
+        buffer.append(term.data() + i + 1, term.size() - i - 1);
+        function(QByteArrayView{buffer.data(), buffer.size()});
+    }
+}
+
+// checks if a single insertion, deletion, substitution, or transposition of adjacent characters turns `lhs` into `rhs`
+[[nodiscard]] bool isOneEditApart(QByteArrayView lhs, QByteArrayView rhs) noexcept
+{
+    if (lhs.size() > rhs.size())
+        std::swap(lhs, rhs);
+    if (rhs.size() - lhs.size() > 1)
+        return false;
+
+    auto i = qsizetype{0};
+
+    while (i < lhs.size() && lhs[i] == rhs[i])
+        ++i;
+
+    if (lhs.size() < rhs.size())
+        return lhs.sliced(i) == rhs.sliced(i + 1);
+    if (i == lhs.size())
+        return false; // equal terms
+    if (lhs.sliced(i + 1) == rhs.sliced(i + 1))
+        return true;
+
+    return i + 1 < lhs.size()
+            && lhs[i] == rhs[i + 1] && lhs[i + 1] == rhs[i]
+            && lhs.sliced(i + 2) == rhs.sliced(i + 2);
+}
+
+// splits `name` into lowercase words, at punctuation, and at CamelCase or digit boundaries like in "Html5FileUpload"
+template<typename Function>
+void forEachNameWord(QByteArrayView name, Function &&function)
+{
+    auto word = WordBuffer{};
+
+    const auto flush = [&] {
+        if (!word.isEmpty()) {
+            function(QByteArrayView{word.data(), word.size()});
+            word.clear();
+        }
+    };
+
+    for (auto i = qsizetype{0}; i < name.size(); ++i) {
+        const auto ch = name[i];
+
+        if (!isAlphaNumeric(ch)) {
+            flush();
+            continue;
+        }
+
+        if (i > 0 && isAlphaNumeric(name[i - 1])) {
+            const auto previous = name[i - 1];
+            const auto next = i + 1 < name.size() ? name[i + 1] : '\0';
+
+            if (isDigit(ch) != isDigit(previous)
+                    || (isUpper(ch) && !isUpper(previous))
+                    || (isUpper(ch) && isUpper(previous) && next >= 'a' && next <= 'z'))
+                flush();
+        }
+
+        word.append(toLower(ch));
+    }
+
+    flush();
+}
+
+// splits `text` into lowercase words at anything but letters and digits
+template<typename Text, typename Function>
+void forEachWord(Text text, Function &&function)
+{
+    auto word = WordBuffer{};
+
+    const auto flush = [&] {
+        if (!word.isEmpty()) {
+            function(QByteArrayView{word.data(), word.size()});
+            word.clear();
+        }
+    };
+
+    for (const auto ch : text) {
+        if (const auto ascii = toAscii(ch); isAlphaNumeric(ascii))
+            word.append(toLower(ascii));
+        else
+            flush();
+    }
+
+    flush();
+}
+
+[[nodiscard]] auto symbolOrder(const Symbol &symbol) noexcept
+{
+    return std::pair{symbol.unicode(), symbol.fontInfo().tag().index()};
+}
+
+// the scores of the symbols matching the current query; reused by each thread to avoid allocations
+struct Scores
+{
+    std::vector<quint32> stamps;        // marks the symbols touched by the current query
+    std::vector<quint16> matchedWords;
+    std::vector<int>     wordScores;    // best score for the current word
+    std::vector<int>     totalScores;
+    std::vector<quint32> touched;
+    quint32              stamp = 0;
+
+    void reset(std::size_t symbolCount)
+    {
+        if (stamps.size() < symbolCount) {
+            stamps.resize(symbolCount);
+            matchedWords.resize(symbolCount);
+            wordScores.resize(symbolCount);
+            totalScores.resize(symbolCount);
+        }
+
+        if (++stamp == 0) {
+            std::ranges::fill(stamps, 0);
+            stamp = 1;
+        }
+
+        touched.clear();
+    }
+
+    void add(quint32 symbol, int word, int score)
+    {
+        if (stamps[symbol] != stamp) {
+            if (word > 0)
+                return; // missed a previous word already
+
+            stamps[symbol] = stamp;
+            matchedWords[symbol] = 0;
+            totalScores[symbol] = 0;
+            touched.push_back(symbol);
+        }
+
+        if (matchedWords[symbol] == word) {
+            matchedWords[symbol] = static_cast<quint16>(word + 1);
+            wordScores[symbol] = score;
+            totalScores[symbol] += score;
+        } else if (matchedWords[symbol] == word + 1 && score > wordScores[symbol]) {
+            totalScores[symbol] += score - wordScores[symbol];
+            wordScores[symbol] = score;
+        }
+    }
+};
+
+} // namespace
+
+SymbolSearch::SymbolSearch(const QList<FontInfo> &fonts)
+{
+    struct Occurrence
+    {
+        quint32 offset;
+        quint32 length;
+        quint32 posting;
+    };
+
+    auto pool = QByteArray{};
+    auto occurrences = std::vector<Occurrence>{};
+
+    const auto addTerm = [&](QByteArrayView term, quint32 symbol, quint32 flags) {
+        occurrences.emplace_back(static_cast<quint32>(pool.size()), static_cast<quint32>(term.size()),
+                                 (symbol << 1) | flags);
+        pool.append(term);
+    };
+
+    for (const auto &font : fonts) {
+        auto symbolsByUnicode = QHash<char32_t, quint32>{};
+        auto symbolsByKey = QHash<QByteArrayView, quint32>{};
+
+        for (auto count = font.symbolCount(), i = 0; i < count; ++i) {
+            const auto key = QByteArrayView{font.key(i)};
+            const auto unicode = font.unicode(i);
+            const auto symbol = symbolsByUnicode.value(unicode, static_cast<quint32>(m_symbols.size()));
+
+            if (symbol == m_symbols.size()) { // aliases share the symbol of their codepoint
+                symbolsByUnicode.insert(unicode, symbol);
+                m_symbols.emplace_back(font, unicode);
+                m_nameLengths.emplace_back(static_cast<quint8>(std::min<qsizetype>(key.size(), 255)));
+            }
+
+            symbolsByKey.insert(key, symbol);
+
+            auto joined = WordBuffer{};
+            auto wordCount = 0;
+
+            forEachNameWord(key, [&](QByteArrayView word) {
+                addTerm(word, symbol, 0);
+                joined.append(word.data(), word.size());
+                ++wordCount;
+            });
+
+            if (wordCount > 1)
+                addTerm({joined.data(), joined.size()}, symbol, 0);
+        }
+
+        for (auto tags = font.searchTags(); !tags.isEmpty(); ) {
+            const auto end = tags.indexOf('\n');
+            const auto line = end < 0 ? tags : tags.first(end);
+            tags = end < 0 ? QByteArrayView{} : tags.sliced(end + 1);
+
+            const auto separator = line.indexOf('=');
+
+            if (separator < 0)
+                continue;
+
+            const auto symbol = symbolsByKey.constFind(line.first(separator));
+
+            if (symbol == symbolsByKey.cend())
+                continue;
+
+            forEachWord(line.sliced(separator + 1), [&](QByteArrayView word) {
+                addTerm(word, *symbol, TagFlag);
+            });
+        }
+    }
+
+    m_symbols.shrink_to_fit();
+    m_nameLengths.shrink_to_fit();
+
+    // terms: sort occurrences by term, and then by posting to report names before tags for the same symbol
+
+    const auto occurrenceTerm = [&pool](const Occurrence &occurrence) {
+        return QByteArrayView{pool}.sliced(occurrence.offset, occurrence.length);
+    };
+
+    std::ranges::sort(occurrences, [&](const Occurrence &lhs, const Occurrence &rhs) {
+        if (const auto result = occurrenceTerm(lhs).compare(occurrenceTerm(rhs)); result != 0)
+            return result < 0;
+
+        return lhs.posting < rhs.posting;
+    });
+
+    m_postings.reserve(occurrences.size());
+
+    for (const auto &occurrence : occurrences) {
+        const auto newTerm = m_terms.empty() || term(std::ssize(m_terms) - 1) != occurrenceTerm(occurrence);
+
+        if (newTerm) {
+            m_terms.emplace_back(static_cast<quint32>(m_termPool.size()), occurrence.length);
+            m_postingOffsets.emplace_back(static_cast<quint32>(m_postings.size()));
+            m_termPool.append(occurrenceTerm(occurrence));
+        } else if ((m_postings.back() >> 1) == (occurrence.posting >> 1)) {
+            continue; // the same word found repeatedly for the same symbol
+        }
+
+        m_postings.emplace_back(occurrence.posting);
+    }
+
+    m_postingOffsets.emplace_back(static_cast<quint32>(m_postings.size()));
+
+    m_terms.shrink_to_fit();
+    m_postingOffsets.shrink_to_fit();
+    m_postings.shrink_to_fit();
+    m_termPool.squeeze();
+
+    // variants: long enough terms, and these terms with one character deleted, so that queries
+    // with one typo find the intended term by also deleting at most one of their own characters
+
+    for (auto i = qsizetype{0}; i < std::ssize(m_terms); ++i) {
+        const auto text = term(i);
+
+        if (text.size() < MinTypoLength || text.size() > MaxWordLength)
+            continue;
+
+        const auto index = static_cast<quint32>(i);
+
+        m_variants.emplace_back(hashTerm(text), index);
+        forEachDeletion(text, [this, index](QByteArrayView variant) {
+            m_variants.emplace_back(hashTerm(variant), index);
+        });
+    }
+
+    std::ranges::sort(m_variants, {}, [](const Variant &variant) {
+        return std::pair{variant.hash, variant.term};
+    });
+
+    m_variants.shrink_to_fit();
+}
+
+QList<SymbolSearch::Match> SymbolSearch::find(QStringView query, qsizetype limit) const
+{
+    thread_local auto t_scores = Scores{};
+
+    if (limit <= 0 || isEmpty())
+        return {};
+
+    auto &scores = t_scores;
+    scores.reset(m_symbols.size());
+
+    const auto addPostings = [this, &scores](qsizetype termIndex, int word, int nameScore, int tagScore) {
+        const auto first = m_postings.begin() + m_postingOffsets[static_cast<std::size_t>(termIndex)];
+        const auto last = m_postings.begin() + m_postingOffsets[static_cast<std::size_t>(termIndex) + 1];
+
+        for (auto it = first; it != last; ++it)
+            scores.add(*it >> 1, word, (*it & TagFlag) ? tagScore : nameScore);
+    };
+
+    auto wordCount = 0;
+
+    forEachWord(query, [&](QByteArrayView word) {
+        if (wordCount == MaxQueryWords || (wordCount > 0 && scores.touched.empty()))
+            return; // too many words, or one of the previous words already matched nothing
+
+        const auto wordIndex = wordCount++;
+
+        // exact terms and prefixes: all of them are next to each other, starting with the exact term
+
+        const auto first = std::ranges::partition_point(m_terms, [this, word](const Term &entry) {
+            return QByteArrayView{m_termPool}.sliced(entry.offset, entry.length).compare(word) < 0;
+        });
+
+        auto termIndex = std::distance(m_terms.begin(), first);
+
+        for (; termIndex < std::ssize(m_terms); ++termIndex) {
+            const auto text = term(termIndex);
+
+            if (!text.startsWith(word))
+                break;
+
+            if (text.size() == word.size()) {
+                addPostings(termIndex, wordIndex, ExactName, ExactTag);
+            } else if (word.size() >= MinPrefixLength) {
+                const auto penalty = static_cast<int>(std::min<qsizetype>(text.size() - word.size(), MaxPenalty));
+                addPostings(termIndex, wordIndex, PrefixName - penalty, PrefixTag - penalty);
+            } else {
+                break;
+            }
+        }
+
+        // typos: terms sharing a variant with this word, which still must be verified because
+        // variants are only compared by hash, and because two deletions might have produced them
+
+        if (word.size() < MinTypoLength || word.size() > MaxWordLength)
+            return;
+
+        const auto addTypos = [&](QByteArrayView variant) {
+            const auto range = std::ranges::equal_range(m_variants, hashTerm(variant), {}, &Variant::hash);
+
+            for (const auto &candidate : range) {
+                if (isOneEditApart(word, term(candidate.term)))
+                    addPostings(candidate.term, wordIndex, TypoName, TypoTag);
+            }
+        };
+
+        addTypos(word);
+        forEachDeletion(word, addTypos);
+    });
+
+    if (wordCount == 0)
+        return {};
+
+    // ranking: best score first, then short names, then like SymbolIndex to report fonts in a stable order
+
+    auto &candidates = scores.touched;
+
+    const auto [removed, end] = std::ranges::remove_if(candidates, [&scores, wordCount](quint32 symbol) {
+        return scores.matchedWords[symbol] != wordCount;
+    });
+
+    candidates.erase(removed, end);
+
+    const auto isBetter = [this, &scores](quint32 lhs, quint32 rhs) {
+        if (scores.totalScores[lhs] != scores.totalScores[rhs])
+            return scores.totalScores[lhs] > scores.totalScores[rhs];
+        if (m_nameLengths[lhs] != m_nameLengths[rhs])
+            return m_nameLengths[lhs] < m_nameLengths[rhs];
+
+        return symbolOrder(m_symbols[lhs]) < symbolOrder(m_symbols[rhs]);
+    };
+
+    const auto count = std::min(std::ssize(candidates), limit);
+    std::ranges::partial_sort(candidates, candidates.begin() + count, isBetter);
+
+    auto matches = QList<Match>{};
+    matches.reserve(count);
+
+    for (auto i = qsizetype{0}; i < count; ++i) {
+        const auto symbol = candidates[static_cast<std::size_t>(i)];
+        matches.append({m_symbols[symbol], scores.totalScores[symbol]});
+    }
+
+    return matches;
+}
+
+QByteArrayView SymbolSearch::term(qsizetype index) const noexcept
+{
+    const auto &entry = m_terms[static_cast<std::size_t>(index)];
+    return QByteArrayView{m_termPool}.sliced(entry.offset, entry.length);
+}
+
+const SymbolSearch &SymbolSearch::instance()
+{
+    static const auto s_instance = SymbolSearch{FontInfo::knownFonts()};
+    return s_instance;
+}
+
+} // namespace IconFonts
@@ -0,0 +1,69 @@
+#ifndef ICONFONTS_SYMBOLSEARCH_H
+#define ICONFONTS_SYMBOLSEARCH_H
+
+#include "iconfonts.h"
+
+#include <vector>
+
+namespace IconFonts {
+
+// SymbolSearch class // ===============================================================================================
+
+// Finds symbols across fonts by the words of their names, and by the search tags of their metadata,
+// e.g. "arrow left", "trash" or the misspelled "calender". Results are ranked, best matches first:
+// exact words before prefixes before words with one typo, names before tags, short names before long ones.
+//
+// Each word of the query must match. Words are compared ignoring case and anything but letters and digits,
+// CamelCase names like "ArrowLeft" are split into words, but also found as "arrowleft".
+// Symbols sharing a codepoint within a font, like aliases, are reported only once.
+class ICONFONTS_EXPORT SymbolSearch final
+{
+public:
+    static constexpr qsizetype DefaultLimit = 50;
+
+    struct Match
+    {
+        Symbol symbol;
+        int    score;
+    };
+
+    SymbolSearch() noexcept = default;
+    explicit SymbolSearch(const QList<FontInfo> &fonts);
+
+    [[nodiscard]] QList<Match> find(QStringView query, qsizetype limit = DefaultLimit) const;
+
+    [[nodiscard]] bool isEmpty() const noexcept { return m_symbols.empty(); }
+    [[nodiscard]] qsizetype termCount() const noexcept { return static_cast<qsizetype>(m_terms.size()); }
+    [[nodiscard]] qsizetype symbolCount() const noexcept { return static_cast<qsizetype>(m_symbols.size()); }
+
+    // built once on first use, covers all the fonts of FontInfo::knownFonts();
+    // construct a separate instance for fonts registered at runtime
+    [[nodiscard]] static const SymbolSearch &instance();
+
+private:
+    struct Term
+    {
+        quint32 offset;
+        quint32 length;
+    };
+
+    struct Variant                      // a term, or the term with one of its characters deleted
+    {
+        quint32 hash;
+        quint32 term;
+    };
+
+    [[nodiscard]] QByteArrayView term(qsizetype index) const noexcept;
+
+    std::vector<Symbol>  m_symbols;
+    std::vector<quint8>  m_nameLengths;     // of `m_symbols`, to rank short names first
+    std::vector<Term>    m_terms;           // sorted, to also find them by prefix
+    std::vector<quint32> m_postingOffsets;  // where the postings of each term begin within `m_postings`
+    std::vector<quint32> m_postings;        // symbol index, shifted by one bit to mark tags
+    std::vector<Variant> m_variants;        // sorted by hash, to find terms with one typo
+    QByteArray           m_termPool;
+};
+
+} // namespace IconFonts
+
+#endif // ICONFONTS_SYMBOLSEARCH_H
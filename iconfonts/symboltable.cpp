@@ -0,0 +1,249 @@
+#include "symboltable_p.h"
+#include "iconfonts_p.h"
+
+#include <QHash>
+#include <QtEndian>
+
+#include <algorithm>
+
+namespace IconFonts::Private {
+
+namespace {
+
+constexpr auto HeaderSize = 4 * sizeof(quint32);
+
+[[nodiscard]] constexpr bool isSeparator(char ch) noexcept
+{
+    return ch == '-' || ch == '_' || ch == ' ' || ch == '\t' || ch == '.';
+}
+
+[[nodiscard]] constexpr bool isAlphaNumeric(char ch) noexcept
+{
+    return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9');
+}
+
+[[nodiscard]] constexpr char toUpper(char ch) noexcept
+{
+    return (ch >= 'a' && ch <= 'z') ? static_cast<char>(ch - 'a' + 'A') : ch;
+}
+
+[[nodiscard]] constexpr char toLower(char ch) noexcept
+{
+    return (ch >= 'A' && ch <= 'Z') ? static_cast<char>(ch - 'A' + 'a') : ch;
+}
+
+void appendLittleEndian(QByteArray &data, quint32 value)
+{
+    char buffer[sizeof value];
+    qToLittleEndian(value, buffer);
+    data.append(buffer, sizeof buffer);
+}
+
+} // namespace
+
+// SymbolTable class // ================================================================================================
+
+SymbolTable SymbolTable::fromData(const QByteArray &data)
+{
+    if (Q_UNLIKELY(static_cast<std::size_t>(data.size()) < HeaderSize)) {
+        qCWarning(lcIconFonts, "Symbol table is truncated");
+        return {};
+    }
+
+    const auto header = data.constData();
+    const auto magic = qFromLittleEndian<quint32>(header);
+    const auto version = qFromLittleEndian<quint32>(header + 4);
+    const auto count = qFromLittleEndian<quint32>(header + 8);
+    const auto keyPoolSize = qFromLittleEndian<quint32>(header + 12);
+
+    if (Q_UNLIKELY(magic != Magic || version != Version)) {
+        qCWarning(lcIconFonts, "Unsupported symbol table (magic: 0x%08x, version: %u)", magic, version);
+        return {};
+    }
+
+    const auto expectedSize = HeaderSize + 2 * sizeof(quint32) * std::size_t{count} + keyPoolSize;
+
+    if (Q_UNLIKELY(static_cast<std::size_t>(data.size()) != expectedSize
+                   || (keyPoolSize > 0 && header[expectedSize - 1] != '\0'))) {
+        qCWarning(lcIconFonts, "Symbol table is corrupted (expected size: %zu, actual size: %lld)",
+                  expectedSize, static_cast<qlonglong>(data.size()));
+        return {};
+    }
+
+    auto table = SymbolTable{};
+
+    table.m_data = data;
+    table.m_count = count;
+    table.m_unicodes = header + HeaderSize;
+    table.m_keyOffsets = table.m_unicodes + sizeof(quint32) * count;
+    table.m_keyPool = table.m_keyOffsets + sizeof(quint32) * count;
+    table.m_keyPoolSize = keyPoolSize;
+
+    return table;
+}
+
+quint32 SymbolTable::read(const char *table, quint32 index) const noexcept
+{
+    return qFromLittleEndian<quint32>(table + sizeof(quint32) * index);
+}
+
+char32_t SymbolTable::unicode(int index) const noexcept
+{
+    if (Q_UNLIKELY(index < 0 || static_cast<quint32>(index) >= m_count))
+        return 0;
+
+    return static_cast<char32_t>(read(m_unicodes, static_cast<quint32>(index)));
+}
+
+const char *SymbolTable::key(int index) const noexcept
+{
+    if (Q_UNLIKELY(index < 0 || static_cast<quint32>(index) >= m_count))
+        return nullptr;
+
+    if (const auto offset = read(m_keyOffsets, static_cast<quint32>(index));
+            Q_LIKELY(offset < m_keyPoolSize))
+        return m_keyPool + offset;
+
+    return nullptr;
+}
+
+int SymbolTable::indexOf(char32_t unicode) const noexcept
+{
+    auto first = quint32{0};
+    auto count = m_count;
+
+    while (count > 0) { // lower bound, so that aliases resolve to their first entry
+        const auto step = count / 2;
+        const auto middle = first + step;
+
+        if (read(m_unicodes, middle) < unicode) {
+            first = middle + 1;
+            count -= step + 1;
+        } else {
+            count = step;
+        }
+    }
+
+    if (first < m_count && read(m_unicodes, first) == unicode)
+        return static_cast<int>(first);
+
+    return -1;
+}
+
+// SymbolTableBuilder class // =========================================================================================
+
+void SymbolTableBuilder::reserve(qsizetype size)
+{
+    m_symbols.reserve(static_cast<std::size_t>(size));
+}
+
+void SymbolTableBuilder::add(QByteArrayView name, char32_t unicode)
+{
+    makeSymbolKey(name, m_scratch);
+
+    if (Q_LIKELY(!m_scratch.isEmpty()))
+        m_symbols.emplace_back(m_scratch, unicode);
+}
+
+SymbolTable SymbolTableBuilder::build()
+{
+    // exactly like deduplicate_icons() of iconfontstool.py: name by name, in order of first occurrence,
+    // all but the first symbol of a name get the first of "<name>Alt", "<name>Alt1", ... that is still unused
+
+    auto indexesByKey = QHash<QByteArray, QList<qsizetype>>{};
+    auto keysInOrder = QList<QByteArray>{};
+
+    indexesByKey.reserve(size());
+
+    for (auto i = qsizetype{0}; i < size(); ++i) {
+        auto &indexes = indexesByKey[m_symbols[static_cast<std::size_t>(i)].key];
+
+        if (indexes.isEmpty())
+            keysInOrder.append(m_symbols[static_cast<std::size_t>(i)].key);
+
+        indexes.append(i);
+    }
+
+    for (const auto &key : std::as_const(keysInOrder)) {
+        const auto indexes = indexesByKey.value(key); // copied, renaming inserts into the hash
+
+        for (auto i = qsizetype{1}; i < indexes.size(); ++i) {
+            auto alternateKey = key + "Alt";
+
+            for (auto counter = 1; indexesByKey.contains(alternateKey); ++counter)
+                alternateKey = key + "Alt" + QByteArray::number(counter);
+
+            indexesByKey.insert(alternateKey, {indexes[i]});
+            m_symbols[static_cast<std::size_t>(indexes[i])].key = std::move(alternateKey);
+        }
+    }
+
+    auto keyPoolSize = qsizetype{0};
+
+    for (const auto &entry : m_symbols)
+        keyPoolSize += entry.key.size() + 1;
+
+    std::stable_sort(m_symbols.begin(), m_symbols.end(), [](const Entry &lhs, const Entry &rhs) {
+        return lhs.unicode < rhs.unicode;
+    });
+
+    const auto count = static_cast<quint32>(m_symbols.size());
+
+    auto data = QByteArray{};
+    data.reserve(static_cast<qsizetype>(HeaderSize + 2 * sizeof(quint32) * count) + keyPoolSize);
+
+    appendLittleEndian(data, SymbolTable::Magic);
+    appendLittleEndian(data, SymbolTable::Version);
+    appendLittleEndian(data, count);
+    appendLittleEndian(data, static_cast<quint32>(keyPoolSize));
+
+    for (const auto &entry : m_symbols)
+        appendLittleEndian(data, static_cast<quint32>(entry.unicode));
+
+    auto keyOffset = quint32{0};
+
+    for (const auto &entry : m_symbols) {
+        appendLittleEndian(data, keyOffset);
+        keyOffset += static_cast<quint32>(entry.key.size() + 1);
+    }
+
+    for (const auto &entry : m_symbols)
+        data.append(entry.key).append('\0');
+
+    m_symbols.clear();
+
+    return SymbolTable::fromData(data);
+}
+
+// Symbol keys // ======================================================================================================
+
+void makeSymbolKey(QByteArrayView name, QByteArray &key)
+{
+    key.resize(0);
+    key.reserve(name.size() + 1);
+
+    auto startOfWord = true; // like the injected separator of __iconfonts_make_symbol()
+
+    for (const auto ch : name) {
+        if (isSeparator(ch)) {
+            startOfWord = true;
+        } else {
+            if (isAlphaNumeric(ch)) // other characters get dropped, but still end the separator sequence
+                key.append(startOfWord ? toUpper(ch) : toLower(ch));
+
+            startOfWord = false;
+        }
+    }
+
+    if (!key.isEmpty() && key.front() >= '0' && key.front() <= '9')
+        key.prepend('_');
+}
+
+QByteArray makeSymbolKey(QByteArrayView name)
+{
+    auto key = QByteArray{};
+    makeSymbolKey(name, key);
+    return key;
+}
+
+} // namespace IconFonts::Private
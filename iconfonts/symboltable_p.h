@@ -0,0 +1,116 @@
+#ifndef ICONFONTS_SYMBOLTABLE_P_H
+#define ICONFONTS_SYMBOLTABLE_P_H
+
+#include <QByteArray>
+#include <QtEndian>
+
+#include <cstddef>
+#include <vector>
+
+namespace IconFonts::Private {
+
+// SymbolTable class // ================================================================================================
+
+// A compact, read-only list of symbols for fonts that have no symbol enumeration.
+// The table is one contiguous blob, so it can be read in place from memory it doesn't own:
+//
+//   quint32 magic, version, count, keyPoolSize    -- all little endian
+//   quint32 unicodes[count]                       -- sorted ascending, aliases are adjacent
+//   quint32 keyOffsets[count]                     -- offsets into the key pool
+//   char    keyPool[keyPoolSize]                  -- NUL terminated symbol keys
+//
+class ICONFONTS_EXPORT SymbolTable final
+{
+public:
+    static constexpr quint32 Magic   = 0x54434649; // "IFCT"
+    static constexpr quint32 Version = 1;
+
+    SymbolTable() noexcept = default;
+
+    // does not copy raw data, but keeps a reference on implicitly shared data
+    [[nodiscard]] static SymbolTable fromData(const QByteArray &data);
+
+    [[nodiscard]] bool isNull() const noexcept { return m_count == 0; }
+    [[nodiscard]] int count() const noexcept { return static_cast<int>(m_count); }
+    [[nodiscard]] QByteArray data() const noexcept { return m_data; }
+
+    [[nodiscard]] char32_t unicode(int index) const noexcept;
+    [[nodiscard]] const char *key(int index) const noexcept;
+    [[nodiscard]] int indexOf(char32_t unicode) const noexcept;
+
+private:
+    [[nodiscard]] quint32 read(const char *table, quint32 index) const noexcept;
+
+    QByteArray  m_data;
+    quint32     m_count = 0;
+    const char *m_unicodes = nullptr;
+    const char *m_keyOffsets = nullptr;
+    const char *m_keyPool = nullptr;
+    quint32     m_keyPoolSize = 0;
+};
+
+// StaticSymbolTable struct // =========================================================================================
+
+// Converts the fields of a StaticSymbolTable; quint32_le cannot be brace-initialized, its constructor is explicit.
+[[nodiscard]] constexpr quint32 littleEndian(quint32 value) noexcept
+{
+    return qToLittleEndian(value);
+}
+
+// The layout of a SymbolTable with `Count` symbols, so that the code generator can emit symbol tables
+// as constant expressions, which are read in place from the read-only data of the library.
+// All fields are stored in little endian byte order, see littleEndian().
+template<std::size_t Count, std::size_t KeyPoolSize>
+struct StaticSymbolTable
+{
+    quint32 header[4];
+    quint32 unicodes[Count];
+    quint32 keyOffsets[Count];
+    char    keyPool[KeyPoolSize + 1]; // the string literal initializing it adds another NUL
+
+    [[nodiscard]] QByteArray toByteArray() const noexcept
+    {
+        const auto size = offsetof(StaticSymbolTable, keyPool) + KeyPoolSize;
+        return QByteArray::fromRawData(reinterpret_cast<const char *>(this), static_cast<qsizetype>(size));
+    }
+};
+
+// Returns the SymbolTable for font `S`, which got generated at build time.
+template<typename S, std::size_t Count, std::size_t KeyPoolSize>
+[[nodiscard]] const SymbolTable *staticSymbolTable(const StaticSymbolTable<Count, KeyPoolSize> &table)
+{
+    static const auto s_instance = SymbolTable::fromData(table.toByteArray());
+    return &s_instance;
+}
+
+// SymbolTableBuilder class // =========================================================================================
+
+// Collects symbols from font metadata and turns their names into keys
+// exactly like the code generator does when creating symbol enumerations.
+class ICONFONTS_EXPORT SymbolTableBuilder final
+{
+public:
+    void reserve(qsizetype size);
+    void add(QByteArrayView name, char32_t unicode);
+
+    [[nodiscard]] qsizetype size() const noexcept { return static_cast<qsizetype>(m_symbols.size()); }
+    [[nodiscard]] SymbolTable build();
+
+private:
+    struct Entry
+    {
+        QByteArray key;
+        char32_t   unicode;
+    };
+
+    std::vector<Entry> m_symbols;
+    QByteArray         m_scratch;
+};
+
+// Equivalent of __iconfonts_make_symbol() in IconFontsStrings.cmake
+[[nodiscard]] QByteArray makeSymbolKey(QByteArrayView name);
+void makeSymbolKey(QByteArrayView name, QByteArray &key);
+
+} // namespace IconFonts::Private
+
+#endif // ICONFONTS_SYMBOLTABLE_P_H
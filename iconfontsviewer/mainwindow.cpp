@@ -304,7 +304,6 @@ QLayout *MainWindow::createFontListLayout()
 
 QLayout *MainWindow::createSymbolListLayout()
 {
-    m_symbolList->setSortingEnabled(true);
     m_symbolList->setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Expanding);
     m_symbolList->setFrameShape(FontListWidget::NoFrame);
 
@@ -320,7 +319,7 @@ QLayout *MainWindow::createSymbolListLayout()
     connect(symbolFilter, &QLineEdit::textChanged,
             m_symbolList, &SymbolListWidget::setFilter);
 
-    connect(m_symbolList, &QListWidget::itemSelectionChanged, this, [this] {
+    connect(m_symbolList, &SymbolListWidget::currentSymbolChanged, this, [this] {
         setIcon(icon() | m_symbolList->currentSymbol());
     });
 
@@ -532,14 +531,8 @@ void MainWindow::setupPreviewSelector(QGridLayout *layout,PreviewColumn column)
 
 void MainWindow::onSelectedFontChanged()
 {
-    const auto &selectedSymbolName = m_symbolList->currentSymbolName();
+    // the symbol list keeps the previously selected symbol selected, if possible, and reports the new symbol
     m_symbolList->setFont(m_fontList->currentFontInfo());
-
-    // restore previously selected symbol, if possible
-    const auto matchingRow = m_symbolList->findRow(selectedSymbolName);
-    m_symbolList->setCurrentRow(std::max(0, matchingRow));
-
-    setIcon(icon() | m_symbolList->currentSymbol());
 }
 
 void MainWindow::onTransformActionTriggered(QAction *action)
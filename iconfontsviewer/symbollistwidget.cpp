@@ -1,89 +1,190 @@
 #include "symbollistwidget.h"
 
+#include <iconfonts/symbolindex.h>
+
+#include <QApplication>
+#include <QStyledItemDelegate>
+
 namespace IconFonts::Viewer {
 
 using namespace Qt::Literals;
 
-int SymbolListWidget::currentSymbolIndex() const
+namespace {
+
+class SymbolListModel : public SymbolModel
+{
+public:
+    using SymbolModel::SymbolModel;
+    using SymbolModel::data;
+
+    QVariant data(const Symbol &symbol, int role) const override
+    {
+        switch (role) {
+        case Qt::DisplayRole:
+            return u"%1 (U+%2)"_s.arg(symbol.name(), QString::number(symbol.unicode(), 16).toUpper());
+
+        case Qt::DecorationRole:
+            return {}; // painted by SymbolDelegate, without creating an icon for each row
+        }
+
+        return SymbolModel::data(symbol, role);
+    }
+};
+
+class SymbolDelegate : public QStyledItemDelegate
+{
+public:
+    using QStyledItemDelegate::QStyledItemDelegate;
+
+    void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const override
+    {
+        QStyledItemDelegate::paint(painter, option, index);
+
+        auto styleOption = option;
+        initStyleOption(&styleOption, index);
+
+        const auto widget = styleOption.widget;
+        const auto style = widget ? widget->style() : QApplication::style();
+        const auto rect = style->subElementRect(QStyle::SE_ItemViewItemDecoration, &styleOption, widget);
+        const auto symbol = qvariant_cast<Symbol>(index.data(SymbolModel::SymbolRole));
+
+        FontIcon{symbol}.draw(painter, QRectF{rect}, styleOption.palette,
+                              {.fillBox = true, .mode = iconMode(styleOption.state)});
+    }
+
+protected:
+    void initStyleOption(QStyleOptionViewItem *option, const QModelIndex &index) const override
+    {
+        QStyledItemDelegate::initStyleOption(option, index);
+
+        // reserves room for the icon, which paint() draws directly from the font
+        option->features |= QStyleOptionViewItem::HasDecoration;
+    }
+
+private:
+    [[nodiscard]] static QIcon::Mode iconMode(QStyle::State state)
+    {
+        if (!state.testFlag(QStyle::State_Enabled))
+            return QIcon::Disabled;
+        else if (state.testFlag(QStyle::State_Selected))
+            return QIcon::Selected;
+        else
+            return QIcon::Normal;
+    }
+};
+
+// Finds the index of the symbol called `name` within `font`.
+[[nodiscard]] int symbolIndex(const FontInfo &font, const QString &name)
 {
-    return symbolIndex(currentItem());
+    if (name.isEmpty())
+        return -1;
+
+    const auto key = name.toLatin1();
+
+    for (const auto &symbol : SymbolIndex::instance().find(key)) {
+        if (symbol.fontInfo() == font)
+            return font.indexOf(symbol.unicode());
+    }
+
+    // fonts registered at runtime are not covered by the index
+    for (auto count = font.symbolCount(), i = 0; i < count; ++i) {
+        if (key == font.key(i))
+            return i;
+    }
+
+    return -1;
+}
+
+} // namespace
+
+SymbolListWidget::SymbolListWidget(QWidget *parent)
+    : QListView{parent}
+    , m_model{new SymbolListModel{this}}
+    , m_filterModel{new SymbolFilterModel{this}}
+{
+    m_filterModel->setSourceModel(m_model);
+    m_filterModel->setDelay(std::chrono::milliseconds{150}); // only match once typing paused
+
+    setUniformItemSizes(true);
+    setItemDelegate(new SymbolDelegate{this});
+    setModel(m_filterModel);
+
+    connect(m_filterModel, &SymbolFilterModel::modelReset, this, &SymbolListWidget::restoreCurrentRow);
 }
 
 QString SymbolListWidget::currentSymbolName() const
 {
-    return symbolName(currentItem());
+    return currentIndex().data(SymbolModel::NameRole).toString();
 }
 
 Symbol SymbolListWidget::currentSymbol() const
 {
-    return m_font.symbol(currentSymbolIndex());
+    return m_model->symbol(m_filterModel->sourceRow(currentIndex().row()));
 }
 
-int SymbolListWidget::findRow(const QString &iconName) const
+int SymbolListWidget::findRow(const QString &symbolName) const
 {
-    for (auto count = SymbolListWidget::count(), i = 0; i < count; ++i) {
-        if (iconName == SymbolListWidget::symbolName(item(i)))
-            return i;
-    }
+    if (const auto index = symbolIndex(font(), symbolName); index >= 0)
+        return m_filterModel->row(index);
 
     return -1;
 }
 
+void SymbolListWidget::setCurrentRow(int row)
+{
+    // rows are fetched in batches, the requested row might not have been fetched yet
+    while (row >= m_filterModel->rowCount() && m_filterModel->canFetchMore({}))
+        m_filterModel->fetchMore({});
+
+    setCurrentIndex(m_filterModel->index(row));
+}
+
 void SymbolListWidget::setFont(const FontInfo &newFont)
 {
-    if (std::exchange(m_font, newFont) != newFont) {
-        clear();
-
-        for (auto count = m_font.symbolCount(), i = 0; i < count; ++i) {
-            const auto &codepoint = QString::number(m_font.unicode(i), 16).toUpper();
-            const auto &label = u"%1 (U+%2)"_s.arg(m_font.name(i), codepoint);
-            auto item = new QListWidgetItem{label, this};
-            item->setIcon(FontIcon{m_font.symbol(i)}.toIcon());
-            item->setData(SymbolIndexRole, i);
-            applyFilter(item);
-        }
-    }
+    if (newFont == font())
+        return;
+
+    m_fontChanged = true;
+    m_model->setFonts(newFont.isValid() ? QList{newFont} : QList<FontInfo>{});
 }
 
 FontInfo SymbolListWidget::font() const
 {
-    return m_font;
+    return m_model->fonts().value(0);
 }
 
 void SymbolListWidget::setFilter(const QString &newFilter)
 {
-    if (std::exchange(m_filter, newFilter) != newFilter)
-        for (auto count = SymbolListWidget::count(), i = 0; i < count; ++i)
-            applyFilter(SymbolListWidget::item(i));
+    m_filterModel->setFilter(newFilter);
 }
 
 QString SymbolListWidget::filter() const
 {
-    return m_filter;
+    return m_filterModel->filter();
 }
 
-QString SymbolListWidget::symbolName(QListWidgetItem *item) const
+void SymbolListWidget::currentChanged(const QModelIndex &current, const QModelIndex &previous)
 {
-    if (const auto index = symbolIndex(item); index >= 0)
-        return m_font.name(index);
+    QListView::currentChanged(current, previous);
 
-    return {};
+    if (current.isValid()) {
+        m_currentName = current.data(SymbolModel::NameRole).toString();
+        emit currentSymbolChanged();
+    }
 }
 
-int SymbolListWidget::symbolIndex(QListWidgetItem *item)
+void SymbolListWidget::restoreCurrentRow()
 {
-    if (item)
-        return item->data(SymbolIndexRole).toInt();
+    // the filter model gets reset when its matches changed, which loses the current row;
+    // after switching fonts the first symbol gets selected, unless the new font has a symbol of the same name
+    auto row = findRow(m_currentName);
 
-    return -1;
-}
+    if (row < 0 && m_fontChanged)
+        row = 0;
 
-void SymbolListWidget::applyFilter(QListWidgetItem *item) const
-{
-    if (item) {
-        const auto &text = item->text();
-        const auto matched = text.contains(m_filter, Qt::CaseInsensitive);
-        item->setHidden(!matched);
+    if (row >= 0 && row < m_filterModel->matchCount()) {
+        m_fontChanged = false;
+        setCurrentRow(row);
     }
 }
 
@@ -1,28 +1,26 @@
 #ifndef ICONFONTSVIEWER_SYMBOLLISTWIDGET_H
 #define ICONFONTSVIEWER_SYMBOLLISTWIDGET_H
 
-#include <iconfonts/iconfonts.h>
+#include <iconfonts/symbolmodel.h>
 
-#include <QListWidget>
+#include <QListView>
 
 namespace IconFonts::Viewer {
 
-class SymbolListWidget : public QListWidget
+// Lists the symbols of a font. Nothing is created per symbol in advance, labels and icons are only produced for the
+// rows that actually get painted. This keeps switching between fonts instant, even for fonts with thousands of symbols.
+class SymbolListWidget : public QListView
 {
     Q_OBJECT
 
 public:
-    enum Role {
-        SymbolIndexRole = Qt::UserRole,
-    };
+    explicit SymbolListWidget(QWidget *parent = nullptr);
 
-    using QListWidget::QListWidget;
-
-    [[nodiscard]] int currentSymbolIndex() const;
     [[nodiscard]] QString currentSymbolName() const;
     [[nodiscard]] Symbol currentSymbol() const;
 
-    [[nodiscard]] int findRow(const QString &iconName) const;
+    [[nodiscard]] int findRow(const QString &symbolName) const;
+    void setCurrentRow(int row);
 
     void setFont(const FontInfo &newFont);
     [[nodiscard]] FontInfo font() const;
@@ -30,14 +28,19 @@ public:
     void setFilter(const QString &newFilter);
     [[nodiscard]] QString filter() const;
 
-private:
-    [[nodiscard]] QString symbolName(QListWidgetItem *item) const;
-    [[nodiscard]] static int symbolIndex(QListWidgetItem *item);
+signals:
+    void currentSymbolChanged();
 
-    void applyFilter(QListWidgetItem *item) const;
+protected:
+    void currentChanged(const QModelIndex &current, const QModelIndex &previous) override;
+
+private:
+    void restoreCurrentRow();
 
-    FontInfo m_font;
-    QString m_filter;
+    SymbolModel       *const m_model;
+    SymbolFilterModel *const m_filterModel;
+    QString                  m_currentName;         // kept while filtered out, to select that symbol again later
+    bool                     m_fontChanged = false;
 };
 
 } // namespace IconFonts::Viewer
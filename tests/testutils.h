@@ -0,0 +1,57 @@
+#ifndef ICONFONTS_TESTS_TESTUTILS_H
+#define ICONFONTS_TESTS_TESTUTILS_H
+
+#include "iconfonts/rastercache_p.h"
+
+#include <QImage>
+#include <QPainter>
+#include <QPainterPath>
+
+namespace IconFonts::Tests {
+
+// An image whose pixels all differ, so that comparing it detects misplaced rows and columns.
+[[nodiscard]] inline QImage testImage(const QSize &size, QImage::Format format)
+{
+    auto image = QImage{size, format};
+
+    for (auto y = 0; y < image.height(); ++y) {
+        for (auto x = 0; x < image.width(); ++x)
+            image.setPixelColor(x, y, QColor{x * 7 % 256, y * 13 % 256, (x + y) % 256, (x * y) % 256});
+    }
+
+    return image;
+}
+
+[[nodiscard]] inline Private::RasterCache::Key testKey(char32_t unicode, const QSize &size)
+{
+    return {
+        .font       = 0x1234'5678'9abc'def0,
+        .unicode    = unicode,
+        .color      = qRgba(255, 0, 102, 255),
+        .width      = static_cast<quint16>(size.width()),
+        .height     = static_cast<quint16>(size.height()),
+    };
+}
+
+// Rasterizes `path` with QPainter, as reference for the masks of the glyph rasterizer and of distance fields.
+// Glyph outlines are meant to be filled with the non-zero winding rule, whatever QRawFont reports.
+[[nodiscard]] inline QImage referenceMask(QPainterPath path, const QSize &size, const QTransform &transform = {},
+                                          Qt::FillRule fillRule = Qt::WindingFill)
+{
+    auto image = QImage{size, QImage::Format_ARGB32_Premultiplied};
+    image.fill(Qt::transparent);
+
+    path.setFillRule(fillRule);
+
+    auto painter = QPainter{&image};
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setTransform(transform);
+    painter.fillPath(path, Qt::black);
+    painter.end();
+
+    return image.convertToFormat(QImage::Format_Alpha8);
+}
+
+} // namespace IconFonts::Tests
+
+#endif // ICONFONTS_TESTS_TESTUTILS_H
@@ -0,0 +1,216 @@
+#include "iconfonts/distancefield_p.h"
+
+#include "testutils.h"
+
+#include <QPainter>
+#include <QTest>
+
+#include <algorithm>
+#include <thread>
+
+namespace IconFonts::Tests {
+namespace {
+
+using Private::DistanceField;
+
+[[nodiscard]] double meanDifference(const QImage &actual, const QImage &expected)
+{
+    auto sum = 0.0;
+
+    for (auto y = 0; y < actual.height(); ++y) {
+        const auto actualLine = actual.constScanLine(y);
+        const auto expectedLine = expected.constScanLine(y);
+
+        for (auto x = 0; x < actual.width(); ++x)
+            sum += std::abs(actualLine[x] - expectedLine[x]);
+    }
+
+    return sum / (actual.width() * actual.height());
+}
+
+// a ring with its baseline at the bottom, sized like a glyph at the reference size
+[[nodiscard]] QPainterPath ring()
+{
+    auto outer = QPainterPath{};
+    outer.addEllipse(QPointF{32, -32}, 28, 28);
+
+    auto inner = QPainterPath{};
+    inner.addEllipse(QPointF{32, -32}, 14, 14);
+
+    return outer - inner;
+}
+
+[[nodiscard]] FontIcon firstAvailableIcon()
+{
+    for (const auto &font : FontInfo::knownFonts()) {
+        if (font.isAvailable() && font.symbolCount() > 0)
+            return font.symbol(0);
+    }
+
+    return {};
+}
+
+class DistanceFieldTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testFromPath()
+    {
+        QVERIFY(DistanceField{}.isNull());
+        QVERIFY(DistanceField::fromPath({}, 0, 0, 0).isNull());
+
+        const auto field = DistanceField::fromPath(ring(), 64, 56, 8);
+
+        QVERIFY(!field.isNull());
+        QCOMPARE(field.advance(), 64);
+        QCOMPARE(field.ascent(), 56);
+        QCOMPARE(field.descent(), 8);
+
+        // the field extends beyond the outline by its spread
+        constexpr auto spread = DistanceField::Spread;
+        QCOMPARE(field.bounds(), (QRectF{4 - spread, -60 - spread, 56 + 2 * spread, 56 + 2 * spread}));
+
+        const auto image = field.image();
+        const auto center = QPoint{32, -32} - field.bounds().topLeft().toPoint();
+
+        QCOMPARE(image.format(), QImage::Format_Grayscale8);
+        QCOMPARE(qGray(image.pixel(center)), 0);                               // the hole is far from the ring
+        QVERIFY(qGray(image.pixel(center + QPoint{21, 0})) > 224);             // deep inside the ring
+        QVERIFY(qAbs(qGray(image.pixel(center + QPoint{28, 0})) - 128) < 16);  // on the outer edge
+        QCOMPARE(qGray(image.pixel(0, 0)), 0);                                 // outside
+    }
+
+    void testRender_data()
+    {
+        QTest::addColumn<QTransform>("transform");
+
+        for (const auto pixelSize : {12, 24, 48, 96, 200, 400}) {
+            const auto scale = pixelSize / qreal{DistanceField::ReferenceSize};
+            QTest::addRow("%dpx", pixelSize) << QTransform::fromScale(scale, scale).translate(2, 62);
+        }
+
+        QTest::newRow("rotated") << QTransform{}.translate(64, 64).rotate(30).translate(-32, 32);
+        QTest::newRow("flipped") << QTransform{}.translate(0, 64).scale(1, -1).translate(0, 62).scale(0.75, 0.75);
+    }
+
+    void testRender()
+    {
+        const QFETCH(QTransform, transform);
+
+        const auto path = ring();
+        const auto field = DistanceField::fromPath(path, 64, 56, 8);
+        const auto size = transform.mapRect(field.bounds()).toAlignedRect().bottomRight() + QPoint{2, 2};
+
+        const auto mask = field.render({size.x(), size.y()}, transform);
+        const auto expected = referenceMask(path, mask.size(), transform, path.fillRule());
+
+        QCOMPARE(mask.format(), QImage::Format_Alpha8);
+        QVERIFY2(meanDifference(mask, expected) < 3, qPrintable(QString::number(meanDifference(mask, expected))));
+    }
+
+    void testDrawIcon_data()
+    {
+        QTest::addColumn<DrawIconOptions>("options");
+
+        QTest::newRow("fillBox")   << DrawIconOptions{.fillBox = true};
+        QTest::newRow("pixelSize") << DrawIconOptions{.pixelSize = 64};
+        QTest::newRow("pointSize") << DrawIconOptions{.pointSize = 48};
+        QTest::newRow("fontSize")  << DrawIconOptions{};
+    }
+
+    void testDrawIcon()
+    {
+        const QFETCH(DrawIconOptions, options);
+        const auto icon = firstAvailableIcon();
+
+        if (icon.isNull())
+            QSKIP("No fonts available for testing");
+
+        icon.symbol().fontInfo().prepareDistanceFields();
+
+        auto expected = QImage{120, 120, QImage::Format_ARGB32_Premultiplied};
+        expected.fill(Qt::transparent);
+
+        auto actual = expected;
+
+        {
+            auto painter = QPainter{&expected};
+            icon.draw(&painter, QRectF{10, 10, 100, 100}, QPalette{}, options);
+        }
+
+        {
+            auto distanceFieldOptions = options;
+            distanceFieldOptions.distanceField = true;
+
+            auto painter = QPainter{&actual};
+            icon.draw(&painter, QRectF{10, 10, 100, 100}, QPalette{}, distanceFieldOptions);
+        }
+
+        const auto expectedMask = expected.convertToFormat(QImage::Format_Alpha8);
+        const auto actualMask = actual.convertToFormat(QImage::Format_Alpha8);
+
+        QVERIFY(std::any_of(actualMask.constBits(), actualMask.constBits() + actualMask.sizeInBytes(),
+                            [](uchar coverage) { return coverage > 0; }));
+        QVERIFY2(meanDifference(actualMask, expectedMask) < 8,
+                 qPrintable(QString::number(meanDifference(actualMask, expectedMask))));
+    }
+
+    void testTrimAndThreads()
+    {
+        const auto icon = firstAvailableIcon();
+
+        if (icon.isNull())
+            QSKIP("No fonts available for testing");
+
+        const auto draw = [&icon] {
+            auto image = QImage{120, 120, QImage::Format_ARGB32_Premultiplied};
+            image.fill(Qt::transparent);
+
+            auto painter = QPainter{&image};
+            icon.draw(&painter, QRectF{10, 10, 100, 100}, QPalette{}, {.fillBox = true, .distanceField = true});
+            painter.end();
+
+            return image;
+        };
+
+        const auto expected = draw();
+
+        // the fields get generated again, also from threads other than the one that created the font
+        QVERIFY(trimCaches(TrimLevel::Rasters).rasters > 0);
+
+        auto actual = QImage{};
+        auto thread = std::thread{[&actual, &draw] { actual = draw(); }};
+        thread.join();
+
+        QCOMPARE(actual, expected);
+    }
+
+    void benchmarkFromPath()
+    {
+        const auto path = ring();
+
+        QBENCHMARK {
+            const auto field = DistanceField::fromPath(path, 64, 56, 8);
+            Q_UNUSED(field);
+        }
+    }
+
+    void benchmarkRender()
+    {
+        const auto field = DistanceField::fromPath(ring(), 64, 56, 8);
+        const auto transform = QTransform::fromScale(4, 4).translate(2, 62);
+
+        QBENCHMARK {
+            const auto mask = field.render({256, 256}, transform);
+            Q_UNUSED(mask);
+        }
+    }
+};
+
+} // namespace
+} // namespace IconFonts::Tests
+
+QTEST_MAIN(IconFonts::Tests::DistanceFieldTest)
+
+#include "tst_distancefield.moc"
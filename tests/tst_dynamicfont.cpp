@@ -0,0 +1,392 @@
+#include "iconfonts/dynamicfont.h"
+#include "iconfonts/opentypereader_p.h"
+#include "iconfonts/symboltable_p.h"
+
+#ifdef ICONFONTS_ENABLE_FONTAWESOME6_FREESOLID
+#include "iconfonts/fontawesome6freesolid.h"
+#endif
+
+#ifdef ICONFONTS_ENABLE_MATERIALSYMBOLS_ROUNDED
+#include "iconfonts/materialsymbolsrounded.h"
+#endif
+
+#include <QFile>
+#include <QTest>
+#include <QtEndian>
+
+#include <algorithm>
+
+using namespace Qt::StringLiterals;
+
+namespace IconFonts::Tests {
+namespace {
+
+using SymbolList = QList<std::pair<QByteArray, char32_t>>;
+using MappingList = QList<std::pair<char32_t, quint16>>;
+
+struct CharacterMapGroup
+{
+    quint32 startCode;
+    quint32 endCode;
+    quint32 startGlyph;
+};
+
+// Builds a `cmap` table with a single Windows full Unicode subtable of format 12.
+[[nodiscard]] QByteArray characterMap12(const QList<CharacterMapGroup> &groups)
+{
+    auto cmap = QByteArray{};
+
+    const auto append = [&cmap](auto value) {
+        char buffer[sizeof value];
+        qToBigEndian(value, buffer);
+        cmap.append(buffer, sizeof buffer);
+    };
+
+    append(quint16{0});                                     // version
+    append(quint16{1});                                     // number of subtables
+    append(quint16{3});                                     // platform
+    append(quint16{10});                                    // encoding
+    append(quint32{12});                                    // offset
+
+    append(quint16{12});                                    // format
+    append(quint16{0});                                     // reserved
+    append(static_cast<quint32>(16 + 12 * groups.size()));  // length
+    append(quint32{0});                                     // language
+    append(static_cast<quint32>(groups.size()));
+
+    for (const auto &group : groups) {
+        append(group.startCode);
+        append(group.endCode);
+        append(group.startGlyph);
+    }
+
+    return cmap;
+}
+
+template<symbol_enum S>
+[[nodiscard]] QByteArray readFontData()
+{
+    if (!Private::loadResources<S>())
+        return {};
+
+    auto file = QFile{fontFileName<S>()};
+
+    if (!file.open(QFile::ReadOnly))
+        return {};
+
+    return file.readAll();
+}
+
+class DynamicFontTest : public QObject
+{
+    Q_OBJECT
+
+private:
+    QByteArray m_fontData;
+
+private slots:
+    void initTestCase()
+    {
+#ifdef ICONFONTS_ENABLE_MATERIALSYMBOLS_ROUNDED
+        m_fontData = readFontData<MaterialSymbolsRounded>();
+        QVERIFY(!m_fontData.isEmpty());
+#else
+        QSKIP("Material Symbols Rounded is needed for testing dynamic fonts");
+#endif
+    }
+
+    void testRegisterFont_data()
+    {
+        QTest::addColumn<DynamicFont::Options>("options");
+        QTest::addColumn<QByteArray>("metadata");
+        QTest::addColumn<SymbolList>("expectedSymbols");
+
+        QTest::newRow("codepoints")
+                << DynamicFont::Options{.format = DynamicFont::Format::Codepoints}
+                << "home e88a\n3d_rotation e84d\nhome e88b\n\nsearch e8b6\n"_ba
+                << SymbolList{{"_3dRotation", 0xe84d}, {"Home", 0xe88a}, {"HomeAlt", 0xe88b}, {"Search", 0xe8b6}};
+
+        QTest::newRow("duplicates") // renamed like deduplicate_icons() of iconfontstool.py
+                << DynamicFont::Options{.format = DynamicFont::Format::Codepoints}
+                << "star e838\nhome e88a\nstar e839\nhome e88b\nhome_alt e88c\nhome e88d\nhome e88a\n"_ba
+                << SymbolList{{"Star", 0xe838}, {"Home", 0xe88a}, {"StarAlt", 0xe839}, {"HomeAlt1", 0xe88b},
+                              {"HomeAlt", 0xe88c}, {"HomeAlt2", 0xe88d}, {"HomeAlt3", 0xe88a}};
+
+        QTest::newRow("css")
+                << DynamicFont::Options{.format = DynamicFont::Format::Css, .prefix = u".ti-"_s}
+                << "/* comment */ @charset \"utf-8\";\n"
+                   "@font-face { font-family: \"x\"; }\n"
+                   ".ti-home:before { content: \"\\e88a\"; }\n"
+                   ".ti-search::before,\n.ti-find:before {\n  content: '\\e8b6';\n}\n"
+                   "@media screen { .ti-star:before { content: \"\\e838\"; } }\n"
+                   ".other-home:before { content: \"\\e88a\"; }\n"_ba
+                << SymbolList{{"Star", 0xe838}, {"Home", 0xe88a}, {"Search", 0xe8b6}, {"Find", 0xe8b6}};
+
+        QTest::newRow("icomoon")
+                << DynamicFont::Options{.format = DynamicFont::Format::IcoMoon}
+                << R"({"IcoMoonType": "selection", "icons": [
+                        {"icon": {"paths": ["M0 0"], "tags": ["home"]}, "properties": {"name": "home", "code": 59530}},
+                        {"properties": {"code": 59574, "name": "search\u0021"}, "setIdx": 0}
+                      ], "preferences": {"fontPref": {"prefix": "icon-"}}})"_ba
+                << SymbolList{{"Home", 0xe88a}, {"Search", 0xe8b6}};
+
+        QTest::newRow("mapping")
+                << DynamicFont::Options{.format = DynamicFont::Format::Mapping}
+                << R"({"arrow-up": 59530, "arrow-down": "\ue8b6"})"_ba
+                << SymbolList{{"ArrowUp", 0xe88a}, {"ArrowDown", 0xe8b6}};
+
+        QTest::newRow("javascript")
+                << DynamicFont::Options{.format = DynamicFont::Format::Mapping, .mapping = u"fillGlyphMap"_s}
+                << "const outlineGlyphMap = { x: 1 };\n"
+                   "// the interesting part\n"
+                   "export const fillGlyphMap = {\n  home: 59530,\n  'magnifier': 0xe8b6,\n};\n"_ba
+                << SymbolList{{"Home", 0xe88a}, {"Magnifier", 0xe8b6}};
+    }
+
+    void testRegisterFont()
+    {
+        const QFETCH(DynamicFont::Options, options);
+        const QFETCH(QByteArray, metadata);
+        const QFETCH(SymbolList, expectedSymbols);
+
+        const auto font = DynamicFont::registerFont(m_fontData, metadata, options);
+
+        QVERIFY(font.isValid());
+        QVERIFY(font.isDynamic());
+        QVERIFY(font.isAvailable());
+        QCOMPARE(font.type(), FontInfo::Type::Application);
+        QVERIFY(!font.fontFamily().isEmpty());
+        QCOMPARE(font.fontName(), font.fontFamily());
+        QVERIFY(DynamicFont::registeredFonts().contains(font));
+        QCOMPARE(FontInfo::fromTag(font.tag()), font);
+
+        auto actualSymbols = SymbolList{};
+
+        for (auto i = 0; i < font.symbolCount(); ++i)
+            actualSymbols.emplaceBack(font.key(i), font.unicode(i));
+
+        // symbols are sorted by their codepoint, therefore only compare sets
+        std::ranges::sort(actualSymbols);
+        auto sortedSymbols = expectedSymbols;
+        std::ranges::sort(sortedSymbols);
+        QCOMPARE(actualSymbols, sortedSymbols);
+
+        for (const auto &[key, unicode] : expectedSymbols) {
+            const auto symbol = Symbol{font, unicode};
+            const auto index = font.indexOf(unicode);
+
+            QVERIFY(index >= 0);
+            QCOMPARE(font.unicode(index), unicode);
+            QCOMPARE(symbol.fontInfo(), font);
+            QCOMPARE(Symbol{symbol.tag()}, symbol);
+        }
+
+        QCOMPARE(font.indexOf(0x20), -1);
+    }
+
+    void testGlyphNames()
+    {
+#ifdef ICONFONTS_ENABLE_MATERIALSYMBOLS_ROUNDED
+        const auto font = DynamicFont::registerFont(m_fontData, {}, {});
+        const auto &staticFont = FontInfo::instance<MaterialSymbolsRounded>();
+
+        QVERIFY(font.isValid());
+        QVERIFY(font.isDynamic());
+        QVERIFY(font.symbolCount() > 0);
+
+        // every symbol of the generated enumeration also must be found in the font's character map
+        for (auto i = 0; i < staticFont.symbolCount(); ++i)
+            QVERIFY2(font.indexOf(staticFont.unicode(i)) >= 0, staticFont.key(i));
+
+        for (auto i = 0; i < font.symbolCount(); ++i) {
+            QVERIFY(font.unicode(i) > 0x20);
+            QVERIFY(qstrlen(font.key(i)) > 0);
+        }
+#endif
+    }
+
+    void testOpenTypeReader()
+    {
+        const auto reader = Private::OpenTypeReader{m_fontData};
+
+        QVERIFY(reader.isValid());
+        QVERIFY(reader.glyphCount() > 0);
+        QVERIFY(!reader.table("cmap").isEmpty());
+        QVERIFY(reader.table("xxxx").isEmpty());
+
+        const auto characterMap = reader.characterMap();
+
+        QVERIFY(!characterMap.empty());
+        QVERIFY(std::ranges::is_sorted(characterMap, {}, &Private::OpenTypeReader::Mapping::unicode));
+        QVERIFY(std::ranges::all_of(characterMap, [&reader](const auto &mapping) {
+            return mapping.glyph > 0 && mapping.glyph < reader.glyphCount();
+        }));
+
+        QVERIFY(!Private::OpenTypeReader{m_fontData.left(10)}.isValid());
+        QVERIFY(!Private::OpenTypeReader{"not a font, really not a font"}.isValid());
+    }
+
+    void testCharacterMap12_data()
+    {
+        QTest::addColumn<QList<CharacterMapGroup>>("groups");
+        QTest::addColumn<MappingList>("expectedMappings");
+
+        QTest::newRow("valid")
+                << QList<CharacterMapGroup>{{0x41, 0x43, 1}, {0x1f600, 0x1f600, 10}}
+                << MappingList{{0x41, 1}, {0x42, 2}, {0x43, 3}, {0x1f600, 10}};
+
+        QTest::newRow("reversed")
+                << QList<CharacterMapGroup>{{0x41, 0x43, 1}, {0x50, 0x4f, 5}}
+                << MappingList{{0x41, 1}, {0x42, 2}, {0x43, 3}};
+
+        QTest::newRow("beyond-unicode")
+                << QList<CharacterMapGroup>{{0x41, 0x41, 1}, {0x10fffe, 0xffffffff, 2}}
+                << MappingList{{0x41, 1}};
+
+        QTest::newRow("overlapping")
+                << QList<CharacterMapGroup>{{0x41, 0x43, 1}, {0x42, 0x44, 5}}
+                << MappingList{{0x41, 1}, {0x42, 2}, {0x43, 3}};
+
+        QTest::newRow("unsorted")
+                << QList<CharacterMapGroup>{{0x50, 0x50, 1}, {0x41, 0x41, 2}}
+                << MappingList{{0x50, 1}};
+    }
+
+    void testCharacterMap12()
+    {
+        const QFETCH(QList<CharacterMapGroup>, groups);
+        const QFETCH(MappingList, expectedMappings);
+
+        auto actualMappings = MappingList{};
+
+        for (const auto &mapping : Private::OpenTypeReader::readCharacterMap(characterMap12(groups)))
+            actualMappings.emplaceBack(mapping.unicode, mapping.glyph);
+
+        QCOMPARE(actualMappings, expectedMappings);
+    }
+
+    void benchmarkOpenTypeReader_data()
+    {
+        QTest::addColumn<QByteArray>("fontData");
+
+#ifdef ICONFONTS_ENABLE_FONTAWESOME6_FREESOLID
+        QTest::newRow("FontAwesome6FreeSolid") << readFontData<FontAwesome6FreeSolid>();
+#endif
+
+#ifdef ICONFONTS_ENABLE_MATERIALSYMBOLS_ROUNDED
+        QTest::newRow("MaterialSymbolsRounded") << m_fontData;
+#endif
+    }
+
+    void benchmarkOpenTypeReader()
+    {
+        const QFETCH(QByteArray, fontData);
+
+        QVERIFY(!fontData.isEmpty());
+
+        auto symbolCount = 0;
+
+        QBENCHMARK {
+            auto builder = Private::SymbolTableBuilder{};
+            QVERIFY(Private::parseOpenType(fontData, builder));
+            symbolCount = builder.build().count();
+        }
+
+        QVERIFY(symbolCount > 0);
+    }
+
+    void testInvalidMetadata_data()
+    {
+        QTest::addColumn<DynamicFont::Options>("options");
+        QTest::addColumn<QByteArray>("metadata");
+        QTest::addColumn<QString>("expectedMessage");
+
+        QTest::newRow("automatic")
+                << DynamicFont::Options{}
+                << "home e88a"_ba
+                << u"Cannot detect format of the icon font's metadata"_s;
+
+        QTest::newRow("codepoints")
+                << DynamicFont::Options{.format = DynamicFont::Format::Codepoints}
+                << "home e88a\nsearch xyz\n"_ba
+                << u"Unexpected codepoint definition in line 2: search xyz"_s;
+
+        // symbol tags have 24 bits for the codepoint, and zero would make them invalid
+        QTest::newRow("codepoints:zero")
+                << DynamicFont::Options{.format = DynamicFont::Format::Codepoints}
+                << "home e88a\nnothing 0\n"_ba
+                << u"Unexpected codepoint definition in line 2: nothing 0"_s;
+
+        QTest::newRow("codepoints:too-large")
+                << DynamicFont::Options{.format = DynamicFont::Format::Codepoints}
+                << "home 1000000\n"_ba
+                << u"Unexpected codepoint definition in line 1: home 1000000"_s;
+
+        QTest::newRow("css:no-prefix")
+                << DynamicFont::Options{.format = DynamicFont::Format::Css}
+                << ".ti-home:before { content: \"\\e88a\"; }"_ba
+                << u"A selector prefix is required for parsing style sheets"_s;
+
+        QTest::newRow("css:unterminated")
+                << DynamicFont::Options{.format = DynamicFont::Format::Css, .prefix = u".ti-"_s}
+                << ".ti-home:before { content: \"\\e88a\"; "_ba
+                << u"Unterminated block in style sheet at offset 16"_s;
+
+        QTest::newRow("css:zero")
+                << DynamicFont::Options{.format = DynamicFont::Format::Css, .prefix = u".ti-"_s}
+                << ".ti-home:before { content: \"\\0\"; }"_ba
+                << uR"(Invalid codepoint 0x0 for "home")"_s;
+
+        QTest::newRow("icomoon")
+                << DynamicFont::Options{.format = DynamicFont::Format::IcoMoon}
+                << R"({"IcoMoonType": "project", "icons": []})"_ba
+                << uR"(Unexpected IcoMoon file type: "project")"_s;
+
+        QTest::newRow("icomoon:negative")
+                << DynamicFont::Options{.format = DynamicFont::Format::IcoMoon}
+                << R"({"IcoMoonType": "selection", "icons": [{"properties": {"name": "home", "code": -1}}]})"_ba
+                << uR"(Invalid codepoint -1 for "home")"_s;
+
+        QTest::newRow("mapping")
+                << DynamicFont::Options{.format = DynamicFont::Format::Mapping}
+                << R"({"home": 59530, "search": })"_ba
+                << uR"(Unexpected mapping for "search")"_s;
+
+        QTest::newRow("mapping:negative")
+                << DynamicFont::Options{.format = DynamicFont::Format::Mapping}
+                << R"({"home": -59530})"_ba
+                << uR"(Unexpected mapping for "home")"_s;
+
+        QTest::newRow("mapping:too-large")
+                << DynamicFont::Options{.format = DynamicFont::Format::Mapping}
+                << R"({"home": "1000000"})"_ba
+                << uR"(Unexpected mapping for "home")"_s;
+
+        QTest::newRow("empty")
+                << DynamicFont::Options{.format = DynamicFont::Format::Mapping}
+                << "{}"_ba
+                << u"No symbols found in the icon font's metadata"_s;
+    }
+
+    void testInvalidMetadata()
+    {
+        const QFETCH(DynamicFont::Options, options);
+        const QFETCH(QByteArray, metadata);
+        const QFETCH(QString, expectedMessage);
+
+        QTest::ignoreMessage(QtWarningMsg, qPrintable(expectedMessage));
+
+        const auto fontCount = DynamicFont::registeredFonts().count();
+        const auto font = DynamicFont::registerFont(m_fontData, metadata, options);
+
+        QVERIFY(font.isNull());
+        QCOMPARE(DynamicFont::registeredFonts().count(), fontCount);
+    }
+};
+
+} // namespace
+} // namespace IconFonts::Tests
+
+QTEST_MAIN(IconFonts::Tests::DynamicFontTest)
+
+#include "tst_dynamicfont.moc"
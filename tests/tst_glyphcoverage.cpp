@@ -0,0 +1,173 @@
+#include "iconfonts/glyphcoverage.h"
+
+#include <QFontMetrics>
+#include <QRawFont>
+#include <QTest>
+
+namespace IconFonts::Tests {
+namespace {
+
+class GlyphCoverageTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testEmptyCoverage()
+    {
+        const auto coverage = GlyphCoverage{};
+
+        QVERIFY(coverage.isEmpty());
+        QCOMPARE(coverage.count(), 0);
+        QVERIFY(!coverage.contains(U'A'));
+        QVERIFY(!coverage.contains(0x110000));
+        QCOMPARE(coverage, GlyphCoverage{std::span<const char32_t>{}});
+    }
+
+    void testSetOperations()
+    {
+        const auto lhsCodepoints = std::array<char32_t, 5>{U'A', U'B', 0xe000, 0xf0000, 0x10ffff};
+        const auto rhsCodepoints = std::array<char32_t, 4>{U'B', U'C', 0xe000, 0x110000};
+
+        const auto lhs = GlyphCoverage{lhsCodepoints};
+        const auto rhs = GlyphCoverage{rhsCodepoints};
+
+        QVERIFY(!lhs.isEmpty());
+        QCOMPARE(lhs.count(), 5);
+        QCOMPARE(rhs.count(), 3); // 0x110000 is not a valid codepoint
+
+        QVERIFY( lhs.contains(U'A'));
+        QVERIFY(!lhs.contains(U'C'));
+        QVERIFY( lhs.contains(0xf0000));
+        QVERIFY(!lhs.contains(0xf0001));
+        QVERIFY( lhs.contains(0x10ffff));
+        QVERIFY(!rhs.contains(0x110000));
+
+        const auto united = lhs | rhs;
+        const auto intersected = lhs & rhs;
+        const auto subtracted = lhs - rhs;
+
+        QCOMPARE(united.count(), 6);
+        QCOMPARE(intersected.count(), 2);
+        QCOMPARE(subtracted.count(), 3);
+
+        QVERIFY(united.contains(U'C'));
+        QVERIFY(intersected.contains(0xe000));
+        QVERIFY(!intersected.contains(U'A'));
+        QVERIFY(subtracted.contains(U'A'));
+        QVERIFY(!subtracted.contains(U'B'));
+
+        QCOMPARE(united - rhs, subtracted);
+        QCOMPARE(intersected | subtracted, lhs);
+        QVERIFY((lhs - lhs).isEmpty());
+        QVERIFY(lhs != rhs);
+    }
+
+    void testKnownFonts_data()
+    {
+        QTest::addColumn<FontInfo>("font");
+
+        for (const auto &font : FontInfo::knownFonts())
+            QTest::newRow(font.enumType().name()) << font;
+    }
+
+    void testKnownFonts()
+    {
+        const QFETCH(FontInfo, font);
+
+        if (!font.isAvailable())
+            QSKIP("This font is not available");
+
+        const auto rawFont = QRawFont::fromFont(font);
+        const auto &coverage = font.coverage();
+
+        QVERIFY(!coverage.isEmpty());
+        QCOMPARE(&font.coverage(), &coverage);
+
+        for (auto count = font.symbolCount(), i = 0; i < count; ++i) {
+            const auto unicode = font.unicode(i);
+            QVERIFY2(font.hasGlyph(unicode) == rawFont.supportsCharacter(unicode), font.key(i));
+        }
+    }
+
+    void testFallbackChain()
+    {
+        const auto fonts = FontInfo::knownFonts();
+
+        if (fonts.size() < 2)
+            QSKIP("At least two fonts are needed for this test");
+
+        const auto &primary = fonts[0];
+        const auto &secondary = fonts[1];
+        const auto chain = FallbackChain{primary, secondary};
+
+        QCOMPARE(chain.fonts(), (QList{primary, secondary}));
+        QCOMPARE(chain.coverage(), primary.coverage() | secondary.coverage());
+        QVERIFY(FallbackChain{}.fontFor(U'A').isNull());
+
+        // symbols found in their own font remain untouched
+        const auto ownSymbol = primary.symbol(0);
+        QCOMPARE(chain.resolve(ownSymbol), ownSymbol);
+
+        // symbols missing in their font get resolved from the next font having them
+        for (auto count = secondary.symbolCount(), i = 0; i < count; ++i) {
+            const auto unicode = secondary.unicode(i);
+
+            if (primary.hasGlyph(unicode) || !secondary.hasGlyph(unicode))
+                continue;
+
+            QCOMPARE(chain.fontFor(unicode), secondary);
+            QCOMPARE(chain.resolve(Symbol{primary, unicode}), (Symbol{secondary, unicode}));
+            return;
+        }
+
+        QSKIP("The secondary font has no glyphs missing in the primary font");
+    }
+
+    void benchmarkHasGlyph()
+    {
+        const auto fonts = FontInfo::knownFonts();
+
+        if (fonts.isEmpty())
+            QSKIP("No fonts configured for testing");
+
+        const auto &font = fonts.constFirst();
+        auto found = 0;
+
+        QBENCHMARK {
+            found = 0;
+
+            for (auto count = font.symbolCount(), i = 0; i < count; ++i)
+                found += font.hasGlyph(font.unicode(i));
+        }
+
+        QVERIFY(found > 0);
+    }
+
+    void benchmarkBoundingRect()
+    {
+        const auto fonts = FontInfo::knownFonts();
+
+        if (fonts.isEmpty())
+            QSKIP("No fonts configured for testing");
+
+        const auto &font = fonts.constFirst();
+        const auto metrics = QFontMetrics{font};
+        auto found = 0;
+
+        QBENCHMARK {
+            found = 0;
+
+            for (auto count = font.symbolCount(), i = 0; i < count; ++i)
+                found += !metrics.boundingRect(font.symbol(i)).isEmpty();
+        }
+
+        QVERIFY(found > 0);
+    }
+};
+
+} // namespace
+} // namespace IconFonts::Tests
+
+QTEST_MAIN(IconFonts::Tests::GlyphCoverageTest)
+
+#include "tst_glyphcoverage.moc"
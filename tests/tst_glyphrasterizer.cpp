@@ -0,0 +1,274 @@
+#include "iconfonts/glyphrasterizer_p.h"
+#include "iconfonts/iconfonts.h"
+
+#include "testutils.h"
+
+#include <QElapsedTimer>
+#include <QPainter>
+#include <QRawFont>
+#include <QTest>
+
+#include <thread>
+
+namespace IconFonts::Tests {
+namespace {
+
+using Private::GlyphRasterizer;
+
+struct Difference
+{
+    int maximum = 0;
+    double mean = 0;
+};
+
+[[nodiscard]] Difference compare(const QImage &actual, const QImage &expected)
+{
+    auto difference = Difference{};
+
+    for (auto y = 0; y < actual.height(); ++y) {
+        const auto actualLine = actual.constScanLine(y);
+        const auto expectedLine = expected.constScanLine(y);
+
+        for (auto x = 0; x < actual.width(); ++x) {
+            const auto delta = std::abs(actualLine[x] - expectedLine[x]);
+            difference.maximum = std::max(difference.maximum, delta);
+            difference.mean += delta;
+        }
+    }
+
+    difference.mean /= actual.width() * actual.height();
+    return difference;
+}
+
+[[nodiscard]] QPainterPath ellipse(const QRectF &rect, bool reversed = false)
+{
+    auto path = QPainterPath{};
+    path.addEllipse(rect);
+    return reversed ? path.toReversed() : path;
+}
+
+// Returns the outlines of the first `count` symbols of the first available font, moved to the origin.
+[[nodiscard]] QList<QPainterPath> glyphPaths(int count, qreal pixelSize)
+{
+    auto paths = QList<QPainterPath>{};
+
+    for (const auto &font : FontInfo::knownFonts()) {
+        if (!font.isAvailable())
+            continue;
+
+        auto rawFont = QRawFont::fromFont(font.font());
+        rawFont.setPixelSize(pixelSize);
+
+        for (auto i = 0; i < font.symbolCount() && paths.size() < count; ++i) {
+            const auto glyphs = rawFont.glyphIndexesForString(font.symbol(i).toString());
+
+            if (glyphs.isEmpty() || glyphs[0] == 0)
+                continue;
+
+            const auto path = rawFont.pathForGlyph(glyphs[0]);
+
+            if (!path.isEmpty())
+                paths.append(path.translated(-path.boundingRect().topLeft()));
+        }
+
+        break;
+    }
+
+    return paths;
+}
+
+class GlyphRasterizerTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testSupports()
+    {
+        QVERIFY(!GlyphRasterizer::supports({}));
+        QVERIFY(!GlyphRasterizer::supports({0, 16}));
+        QVERIFY( GlyphRasterizer::supports({1, 1}));
+        QVERIFY( GlyphRasterizer::supports({GlyphRasterizer::MaximumSize, GlyphRasterizer::MaximumSize}));
+        QVERIFY(!GlyphRasterizer::supports({GlyphRasterizer::MaximumSize + 1, 16}));
+
+        QTest::ignoreMessage(QtWarningMsg, "Unsupported size for rasterizing glyphs: 0x0");
+        QVERIFY(GlyphRasterizer::rasterize(ellipse({0, 0, 8, 8}), {}).isNull());
+    }
+
+    void testRasterize_data()
+    {
+        QTest::addColumn<QPainterPath>("path");
+        QTest::addColumn<QSize>("size");
+        QTest::addColumn<QTransform>("transform");
+
+        auto rectangle = QPainterPath{};
+        rectangle.addRect(2.3, 2.7, 18.3, 14.5);
+
+        auto donut = ellipse({4, 4, 24, 24});
+        donut.addPath(ellipse({10, 10, 12, 12}, true));
+
+        auto overlap = ellipse({4, 8, 16, 16});
+        overlap.addPath(ellipse({12, 8, 16, 16}));
+
+        auto curves = QPainterPath{};
+        curves.moveTo(4, 28);
+        curves.quadTo(16, -8, 28, 28);
+        curves.cubicTo(20, 12, 12, 36, 4, 28);
+
+        const auto rotation = QTransform{}.translate(16, 0).rotate(30);
+
+        QTest::newRow("empty")      << QPainterPath{}               << QSize{16, 16}    << QTransform{};
+        QTest::newRow("rectangle")  << rectangle                    << QSize{24, 24}    << QTransform{};
+        QTest::newRow("ellipse")    << ellipse({3.5, 4, 25, 23})    << QSize{32, 32}    << QTransform{};
+        QTest::newRow("donut")      << donut                        << QSize{32, 32}    << QTransform{};
+        QTest::newRow("overlap")    << overlap                      << QSize{32, 32}    << QTransform{};
+        QTest::newRow("curves")     << curves                       << QSize{32, 32}    << QTransform{};
+        QTest::newRow("clipped")    << ellipse({-8, -8, 28, 28})    << QSize{16, 16}    << QTransform{};
+        QTest::newRow("scaled")     << curves                       << QSize{256, 256}  << QTransform::fromScale(8, 8);
+        QTest::newRow("rotated")    << rectangle                    << QSize{32, 32}    << rotation;
+        QTest::newRow("tiny")       << ellipse({0.5, 0.5, 7, 7})    << QSize{8, 8}      << QTransform{};
+
+        const auto glyphs = glyphPaths(20, 32);
+
+        for (auto i = 0; i < glyphs.size(); ++i) {
+            const auto bounds = glyphs[i].boundingRect();
+            const auto size = QSize{qCeil(bounds.width()) + 2, qCeil(bounds.height()) + 2};
+            QTest::addRow("glyph-%d", i) << glyphs[i] << size << QTransform::fromTranslate(1, 1);
+        }
+    }
+
+    void testRasterize()
+    {
+        const QFETCH(QPainterPath, path);
+        const QFETCH(QSize, size);
+        const QFETCH(QTransform, transform);
+
+        const auto mask = GlyphRasterizer::rasterize(path, size, transform);
+
+        QCOMPARE(mask.format(), QImage::Format_Alpha8);
+        QCOMPARE(mask.size(), size);
+
+        // both compute the area covered per pixel, but differ in detail, like how they flatten curves
+        const auto difference = compare(mask, referenceMask(path, size, transform));
+
+        QVERIFY2(difference.maximum <= 48, qPrintable(QString::number(difference.maximum)));
+        QVERIFY2(difference.mean < 1.5, qPrintable(QString::number(difference.mean)));
+    }
+
+    void testColorize()
+    {
+        auto mask = QImage{3, 1, QImage::Format_Alpha8};
+        mask.scanLine(0)[0] = 0;
+        mask.scanLine(0)[1] = 128;
+        mask.scanLine(0)[2] = 255;
+
+        const auto image = GlyphRasterizer::colorize(mask, QColor{255, 0, 102, 255});
+        const auto pixels = reinterpret_cast<const QRgb *>(image.constScanLine(0));
+
+        QCOMPARE(image.format(), QImage::Format_ARGB32_Premultiplied);
+        QCOMPARE(pixels[0], qRgba(0, 0, 0, 0));
+        QCOMPARE(pixels[1], qRgba(128, 0, 51, 128));
+        QCOMPARE(pixels[2], qRgba(255, 0, 102, 255));
+    }
+
+    void testParallelRasterization()
+    {
+        const auto paths = [] {
+            if (auto glyphs = glyphPaths(64, 48); !glyphs.isEmpty())
+                return glyphs;
+
+            return QList{ellipse({0, 0, 40, 30}), ellipse({4, 4, 24, 40})};
+        }();
+
+        constexpr auto threadCount = std::size_t{4};
+        const auto size = QSize{50, 50};
+
+        auto expected = std::vector<QImage>{};
+        auto actual = std::vector<QImage>(static_cast<std::size_t>(paths.size()));
+
+        for (const auto &path : paths)
+            expected.emplace_back(GlyphRasterizer::rasterize(path, size));
+
+        {
+            auto threads = std::vector<std::jthread>{};
+
+            for (auto offset = std::size_t{0}; offset < threadCount; ++offset) {
+                threads.emplace_back([&paths, &actual, &size, offset] {
+                    for (auto i = offset; i < actual.size(); i += threadCount)
+                        actual[i] = GlyphRasterizer::rasterize(paths[static_cast<qsizetype>(i)], size);
+                });
+            }
+        } // joins all threads
+
+        QVERIFY(actual == expected);
+    }
+
+    void benchmarkRasterizer_data()
+    {
+        QTest::addColumn<int>("pixelSize");
+
+        for (const auto pixelSize : {8, 16, 32, 64, 128, 256})
+            QTest::addRow("%dpx", pixelSize) << pixelSize;
+    }
+
+    void benchmarkRasterizer()
+    {
+        const QFETCH(int, pixelSize);
+        const auto paths = glyphPaths(100, pixelSize * 0.9);
+
+        if (paths.isEmpty())
+            QSKIP("No fonts available for testing");
+
+        const auto size = QSize{pixelSize, pixelSize};
+        auto timer = QElapsedTimer{};
+        auto glyphCount = qint64{0};
+
+        timer.start();
+
+        QBENCHMARK {
+            for (const auto &path : paths) {
+                const auto mask = GlyphRasterizer::rasterize(path, size);
+                Q_UNUSED(mask);
+                ++glyphCount;
+            }
+        }
+
+        qInfo("%.0f glyphs per second", glyphCount * 1000.0 / std::max(timer.elapsed(), qint64{1}));
+    }
+
+    void benchmarkPainter_data()
+    {
+        benchmarkRasterizer_data();
+    }
+
+    void benchmarkPainter()
+    {
+        const QFETCH(int, pixelSize);
+        const auto paths = glyphPaths(100, pixelSize * 0.9);
+
+        if (paths.isEmpty())
+            QSKIP("No fonts available for testing");
+
+        const auto size = QSize{pixelSize, pixelSize};
+        auto timer = QElapsedTimer{};
+        auto glyphCount = qint64{0};
+
+        timer.start();
+
+        QBENCHMARK {
+            for (const auto &path : paths) {
+                const auto mask = referenceMask(path, size);
+                Q_UNUSED(mask);
+                ++glyphCount;
+            }
+        }
+
+        qInfo("%.0f glyphs per second", glyphCount * 1000.0 / std::max(timer.elapsed(), qint64{1}));
+    }
+};
+
+} // namespace
+} // namespace IconFonts::Tests
+
+QTEST_MAIN(IconFonts::Tests::GlyphRasterizerTest)
+
+#include "tst_glyphrasterizer.moc"
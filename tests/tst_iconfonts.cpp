@@ -1,4 +1,5 @@
 #include "iconfonts/iconfonts.h"
+#include "iconfonts/memorypressure.h"
 
 #ifdef ICONFONTS_ENABLE_SEGOE_FLUENTICONS
 #include "iconfonts/segoefluenticons.h"
@@ -8,7 +9,12 @@
 #include "iconfonts/segoemdl2assets.h"
 #endif
 
+#include <QFontDatabase>
 #include <QFontMetrics>
+#include <QGuiApplication>
+#include <QPainter>
+#include <QRawFont>
+#include <QScopeGuard>
 #include <QTest>
 
 using namespace Qt::StringLiterals;
@@ -69,6 +75,14 @@ private:
     };
 
 private slots:
+    void testTrimUnusedFonts() // must run first, before any icon font got used
+    {
+        const auto families = QFontDatabase::families();
+
+        QCOMPARE(trimCaches(TrimLevel::Fonts).fonts, qint64{0});
+        QCOMPARE(QFontDatabase::families(), families);
+    }
+
     void testSymbolConstructors()
     {
         const auto null1 = Symbol{};
@@ -432,6 +446,219 @@ private slots:
         QCOMPARE(transformMatrix.type(), expectedMatrixType);
     }
 
+    void testInternedTransform()
+    {
+        const auto matrix = QTransform{}.rotate(22.5).scale(0.9, 0.9);
+
+        const auto first = SolidStar | matrix;
+        const auto second = FontIcon{AddFriend, Qt::red} | matrix;
+
+        QCOMPARE(first.transformType(), FontIcon::Transform::Matrix);
+        QCOMPARE(first.transform(), matrix);
+        QCOMPARE(second.transform(), matrix);
+        QCOMPARE(&first.transform(), &second.transform());
+
+        QCOMPARE(FontIcon(second, SolidStar), FontIcon(first, Qt::red));
+        QCOMPARE(qHash(FontIcon(second, SolidStar)), qHash(FontIcon(first, Qt::red)));
+        QVERIFY(first != (SolidStar | QTransform{}.rotate(45)));
+    }
+
+    void testRoundedRotation()
+    {
+        // rotations get rounded, so that animating them does not intern a matrix per frame
+        const auto rotated = SolidStar | QTransform{}.rotate(22.5001);
+
+        QCOMPARE(rotated.transformType(), FontIcon::Transform::Matrix);
+        QCOMPARE(rotated.transform(), QTransform{}.rotate(22.5));
+        QCOMPARE(rotated, SolidStar | QTransform{}.rotate(22.4999));
+        QCOMPARE(rotated, SolidStar | QTransform{}.rotate(22.5 - 360));
+        QVERIFY(rotated != (SolidStar | QTransform{}.rotate(22.75)));
+
+        QCOMPARE((SolidStar | QTransform{}.rotate(90.001)).transformType(), FontIcon::Transform::Rotate90);
+        QCOMPARE((SolidStar | QTransform{}.rotate(359.999)).transformType(), FontIcon::Transform::None);
+    }
+
+    void testManyTransforms()
+    {
+        // once many matrices got interned, further ones get snapped to a fine grid, but are never dropped
+        QTest::ignoreMessage(QtWarningMsg, QRegularExpression{u"distinct transforms used by font icons"_s});
+
+        auto icon = FontIcon{};
+
+        for (auto i = 0; i < 2000; ++i) {
+            const auto scale = 0.5 + i / 8000.0;
+            icon = SolidStar | QTransform::fromScale(scale, scale);
+
+            QCOMPARE(icon.transformType(), FontIcon::Transform::Matrix);
+            QVERIFY2(qAbs(icon.transform().m11() - scale) <= 1.0 / 8192, qPrintable(QString::number(i)));
+            QVERIFY2(qAbs(icon.transform().m22() - scale) <= 1.0 / 8192, qPrintable(QString::number(i)));
+        }
+
+        const auto size = QSize{48, 48};
+        QVERIFY(icon.toImage(size) != FontIcon{SolidStar}.toImage(size));
+    }
+
+    void testInternedIcon()
+    {
+        const auto icon = FontIcon{SolidStar, Qt::red};
+
+        QCOMPARE(icon.toIcon().cacheKey(), FontIcon(SolidStar, Qt::red).toIcon().cacheKey());
+        QCOMPARE((icon ^ AddFriend).toIcon().cacheKey(), (icon ^ AddFriend).toIcon().cacheKey());
+
+        QVERIFY(icon.toIcon().cacheKey() != FontIcon{SolidStar}.toIcon().cacheKey());
+        QVERIFY(icon.toIcon().cacheKey() != (icon ^ AddFriend).toIcon().cacheKey());
+
+        // modifying a shared icon must not modify the other ones
+        auto modified = icon.toIcon();
+        modified.addPixmap(QPixmap{16, 16});
+        QVERIFY(modified.cacheKey() != icon.toIcon().cacheKey());
+    }
+
+    void testTransformedPixmap_data()
+    {
+        QTest::addColumn<FontIcon::Transform>("transformType");
+        QTest::addColumn<QSize>("size");
+
+        using enum FontIcon::Transform;
+
+        for (const auto transform : {HorizontalFlip, VerticalFlip, Rotate90, Rotate180, Rotate270}) {
+            const auto name = QMetaEnum::fromType<FontIcon::Transform>().valueToKey(std::to_underlying(transform));
+            QTest::addRow("%s-square", name) << transform << QSize{37, 37};
+
+            if (transform != Rotate90 && transform != Rotate270) // these must be rasterized for other sizes
+                QTest::addRow("%s-wide", name) << transform << QSize{48, 24};
+        }
+    }
+
+    void testTransformedPixmap()
+    {
+        const QFETCH(FontIcon::Transform, transformType);
+        const QFETCH(QSize,               size);
+
+        const auto pixmap = FontIcon{SolidStar, transformType}.toIcon().pixmap(size, 1.0);
+        const auto actual = pixmap.toImage().convertToFormat(QImage::Format_ARGB32_Premultiplied);
+
+        // the permuted pixels get cached, just like rasterized ones
+        QCOMPARE(FontIcon{SolidStar, transformType}.toIcon().pixmap(size, 1.0).cacheKey(), pixmap.cacheKey());
+
+        // permuting the pixels of the untransformed raster must look like painting the transformed icon
+        auto expected = QImage{size, QImage::Format_ARGB32_Premultiplied};
+        expected.fill(Qt::transparent);
+
+        {
+            auto painter = QPainter{&expected};
+            FontIcon{SolidStar, transformType}.draw(&painter, QSizeF{size}, {}, {.fillBox = true});
+        }
+
+        QCOMPARE(actual.size(), expected.size());
+
+        // the rasterizer's antialiasing is not perfectly symmetric
+        constexpr auto tolerance = 8;
+
+        for (auto y = 0; y < expected.height(); ++y) {
+            for (auto x = 0; x < expected.width(); ++x) {
+                const auto actualPixel = actual.pixel(x, y);
+                const auto expectedPixel = expected.pixel(x, y);
+
+                QVERIFY2(qAbs(qAlpha(actualPixel) - qAlpha(expectedPixel)) <= tolerance
+                         && qAbs(qRed(actualPixel)   - qRed(expectedPixel))   <= tolerance
+                         && qAbs(qGreen(actualPixel) - qGreen(expectedPixel)) <= tolerance
+                         && qAbs(qBlue(actualPixel)  - qBlue(expectedPixel))  <= tolerance,
+                         qPrintable(u"pixel at %1,%2"_s.arg(x).arg(y)));
+            }
+        }
+    }
+
+    void testTrimCaches()
+    {
+        const auto pixmap = FontIcon{SolidStar, Qt::blue}.toIcon().pixmap(QSize{48, 48}, 1.0);
+        QVERIFY(!pixmap.isNull());
+
+        const auto result = trimCaches(TrimLevel::Rasters);
+        QVERIFY(result.rasters >= 48 * 48 * pixmap.depth() / 8);
+        QCOMPARE(result.indexes, qint64{0});
+        QCOMPARE(result.fonts, qint64{0});
+
+        // trimmed caches get rebuilt on demand
+        QCOMPARE(trimCaches(TrimLevel::Rasters).total(), qint64{0});
+        QCOMPARE(FontIcon{SolidStar, Qt::blue}.toIcon().pixmap(QSize{48, 48}, 1.0).toImage(), pixmap.toImage());
+
+        const auto all = trimCaches(TrimLevel::Fonts);
+        QVERIFY(all.rasters > 0);
+        QVERIFY(all.fonts >= 0);
+        QVERIFY(all.total() >= all.rasters);
+    }
+
+    void testPaletteChange()
+    {
+        const auto restorePalette = qScopeGuard([palette = QGuiApplication::palette()] {
+            QGuiApplication::setPalette(palette);
+        });
+
+        const auto centerColor = [](const FontIcon &icon) {
+            return icon.toIcon().pixmap(QSize{48, 48}, 1.0).toImage().pixelColor(24, 24);
+        };
+
+        const auto setTextColor = [](const QColor &color) {
+            auto palette = QGuiApplication::palette();
+            palette.setColor(QPalette::Text, color);
+            QGuiApplication::setPalette(palette);
+        };
+
+        // icons without color of their own follow the palette, also after their pixmaps got cached
+        setTextColor(Qt::red);
+        QCOMPARE(centerColor(FontIcon{SolidStar}), QColor{Qt::red});
+        QCOMPARE(centerColor(FontIcon{SolidStar, Qt::green}), QColor{Qt::green});
+
+        setTextColor(Qt::blue);
+        QCOMPARE(centerColor(FontIcon{SolidStar}), QColor{Qt::blue});
+        QCOMPARE(centerColor(FontIcon{SolidStar, Qt::green}), QColor{Qt::green});
+    }
+
+    void testMemoryPressure_data()
+    {
+        QTest::addColumn<QByteArray>("pressure");
+        QTest::addColumn<std::optional<TrimLevel>>("expectedLevel");
+
+        const auto pressure = [](double some, double full) {
+            return "some avg10=%1 avg60=0.00 avg300=0.00 total=123\nfull avg10=%2 avg60=0.00 avg300=0.00 total=45\n"_ba
+                    .replace("%1", QByteArray::number(some, 'f', 2)).replace("%2", QByteArray::number(full, 'f', 2));
+        };
+
+        QTest::newRow("empty")   << QByteArray{}        << std::optional<TrimLevel>{};
+        QTest::newRow("idle")    << pressure(0.0, 0.0)  << std::optional<TrimLevel>{};
+        QTest::newRow("some")    << pressure(7.5, 0.0)  << std::optional{TrimLevel::Rasters};
+        QTest::newRow("more")    << pressure(25.0, 1.0) << std::optional{TrimLevel::Indexes};
+        QTest::newRow("full")    << pressure(30.0, 8.0) << std::optional{TrimLevel::Fonts};
+    }
+
+    void testMemoryPressure()
+    {
+        const QFETCH(QByteArray,               pressure);
+        const QFETCH(std::optional<TrimLevel>, expectedLevel);
+
+        QCOMPARE(MemoryPressureMonitor::trimLevel(pressure), expectedLevel);
+    }
+
+    void testMemoryPressureNotify()
+    {
+        std::ignore = FontIcon{SolidStar, Qt::green}.toIcon().pixmap(QSize{32, 32}, 1.0);
+
+        auto monitor = MemoryPressureMonitor{};
+        auto trimmedLevel = std::optional<TrimLevel>{};
+        auto trimmedBytes = qint64{0};
+
+        connect(&monitor, &MemoryPressureMonitor::trimmed, this, [&](TrimLevel level, const TrimResult &result) {
+            trimmedLevel = level;
+            trimmedBytes = result.total();
+        });
+
+        monitor.notify(TrimLevel::Rasters);
+
+        QCOMPARE(trimmedLevel, std::optional{TrimLevel::Rasters});
+        QVERIFY(trimmedBytes > 0);
+    }
+
     void testFontLoadable_data()
     {
         collectFontInfoData();
@@ -478,6 +705,107 @@ private slots:
                  font.licenseText().toUtf8());
     }
 
+    void testSymbolLookup_data()
+    {
+        collectFontInfoData();
+    }
+
+    void testSymbolLookup()
+    {
+        const QFETCH(FontInfo, font);
+
+#ifdef ICONFONTS_COMPACT_METADATA
+        QVERIFY(font.enumType().metaObject() == nullptr);
+#endif
+
+        QVERIFY(font.symbolCount() > 0);
+
+        for (auto i = 0; i < font.symbolCount(); ++i) {
+            const auto key = font.key(i);
+            QVERIFY(key != nullptr);
+            QVERIFY(qstrlen(key) > 0);
+
+            // aliases share their codepoint, therefore indexOf() not necessarily returns `i`
+            const auto index = font.indexOf(font.unicode(i));
+            QVERIFY2(index >= 0, key);
+            QCOMPARE(font.unicode(index), font.unicode(i));
+        }
+    }
+
+    void testSymbolMetrics_data()
+    {
+        collectFontInfoData();
+    }
+
+    void testSymbolMetrics()
+    {
+        const QFETCH(FontInfo, font);
+        ignoreFontLoadingMessage(font);
+
+        auto qfont = font.font();
+        qfont.setPixelSize(100);
+        qfont.setHintingPreference(QFont::PreferNoHinting);
+
+        const auto metrics = QFontMetricsF{qfont};
+
+        for (auto count = std::min(font.symbolCount(), 50), i = 0; i < count; ++i) {
+            const auto symbol = font.symbol(i);
+            const auto glyphMetrics = symbol.metrics(100);
+
+            if (!font.hasGlyph(symbol.unicode())) {
+                QVERIFY2(glyphMetrics.isNull(), font.key(i));
+                continue;
+            }
+
+            const auto expectedBounds = metrics.boundingRect(symbol.toString());
+
+            QVERIFY2(qAbs(glyphMetrics.advance - metrics.horizontalAdvance(symbol.toString())) < 1, font.key(i));
+            QVERIFY2(qAbs(glyphMetrics.boundingRect.left()   - expectedBounds.left())   < 1, font.key(i));
+            QVERIFY2(qAbs(glyphMetrics.boundingRect.top()    - expectedBounds.top())    < 1, font.key(i));
+            QVERIFY2(qAbs(glyphMetrics.boundingRect.width()  - expectedBounds.width())  < 1, font.key(i));
+            QVERIFY2(qAbs(glyphMetrics.boundingRect.height() - expectedBounds.height()) < 1, font.key(i));
+
+            QCOMPARE(symbol.metrics(50).advance, glyphMetrics.advance / 2);
+        }
+
+        QVERIFY(Symbol{}.metrics(100).isNull());
+    }
+
+    void testSymbolOutlines_data()
+    {
+        collectFontInfoData();
+    }
+
+    void testSymbolOutlines()
+    {
+        const QFETCH(FontInfo, font);
+
+        if (!font.hasOutlines()) {
+            QVERIFY(font.outline(font.unicode(0), 100).isEmpty());
+            QSKIP("This font was added without the OUTLINES option");
+        }
+
+        ignoreFontLoadingMessage(font);
+
+        auto rawFont = QRawFont::fromFont(font.font());
+        rawFont.setPixelSize(100);
+
+        for (auto count = std::min(font.symbolCount(), 50), i = 0; i < count; ++i) {
+            const auto symbol = font.symbol(i);
+            const auto glyphs = rawFont.glyphIndexesForString(symbol.toString());
+            const auto expectedBounds = rawFont.pathForGlyph(glyphs.value(0)).boundingRect();
+            const auto bounds = symbol.outline(100).boundingRect();
+
+            // the outlines are quantized to design units
+            QVERIFY2(qAbs(bounds.left()   - expectedBounds.left())   < 1, font.key(i));
+            QVERIFY2(qAbs(bounds.top()    - expectedBounds.top())    < 1, font.key(i));
+            QVERIFY2(qAbs(bounds.width()  - expectedBounds.width())  < 1, font.key(i));
+            QVERIFY2(qAbs(bounds.height() - expectedBounds.height()) < 1, font.key(i));
+        }
+
+        QVERIFY(font.outline(0x10ffff, 100).isEmpty());
+    }
+
     void testSymbolProperties_data()
     {
         QTest::addColumn<Symbol>("symbol");
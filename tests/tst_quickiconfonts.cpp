@@ -1,17 +1,150 @@
 #include "iconfonts/quickiconfonts.h"
+#include "iconfonts/quickiconatlas_p.h"
+#include "iconfonts/quickimageprovider.h"
+#include "iconfonts/dynamicfont.h"
 
+#ifdef ICONFONTS_ENABLE_MATERIALSYMBOLS_ROUNDED
+#include "iconfonts/materialsymbolsrounded.h"
+#endif
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QGuiApplication>
+#include <QQmlComponent>
+#include <QQmlEngine>
+#include <QQuickView>
+#include <QScopeGuard>
+#include <QSignalSpy>
 #include <QTest>
 
+#include <QtQml/private/qqmlmetatype_p.h>
+
+#include <array>
+#include <memory>
+#include <optional>
+
 using namespace Qt::StringLiterals;
 
 namespace QuickIconFonts::Tests {
 namespace {
 
+// the Item and Text composition that FontIconItem replaced, kept for comparing performance
+constexpr auto ComposedFontIcon = R"(
+    component ComposedFontIcon: Item {
+        id: fontIcon
+
+        property fonticon icon
+        property drawIconOptions options
+        property bool active: Window.window ? Window.window.active : true
+
+        Text {
+            id: content
+
+            anchors.centerIn: parent
+
+            renderType: Text.NativeRendering
+            renderTypeQuality: Text.VeryHighRenderTypeQuality
+            horizontalAlignment: Text.AlignHCenter
+            verticalAlignment: Text.AlignVCenter
+            text: fontIcon.icon.text
+
+            color: fontIcon.options.effectiveColor(fontIcon, fontIcon.icon.color, fontIcon.active)
+
+            font: {
+                let font = {family: fontIcon.icon.font.family};
+
+                if (fontIcon.options.hasPointSize)
+                    font.pointSize = fontIcon.options.pointSize;
+                else if (fontIcon.options.hasPixelSize)
+                    font.pixelSize = fontIcon.options.pixelSize;
+                else
+                    font.pixelSize = Math.min(fontIcon.width, fontIcon.height);
+
+                return font;
+            }
+
+            transform: [
+                Translate { x: -content.width/2; y: -content.height/2 },
+                Matrix4x4 { matrix: fontIcon.icon.transform },
+                Translate { x: +content.width/2; y: +content.height/2 }
+            ]
+        }
+    }
+)"_L1;
+
+#ifdef ICONFONTS_QML_FONT_MODULES
+constexpr auto FontImports = "import IconFonts.MaterialSymbolsRounded"_L1;
+#else
+constexpr auto FontImports = ""_L1;
+#endif
+
+[[nodiscard]] QByteArray iconGrid(const QString &delegate, int count)
+{
+    return uR"(
+        import IconFonts
+        import QtQuick
+        %4
+
+        Grid {
+            columns: 25
+            %1
+            Repeater {
+                model: %2
+                delegate: %3 { width: 24; height: 24; icon: MaterialSymbolsRounded.Bubbles }
+            }
+        }
+    )"_s.arg(ComposedFontIcon, QString::number(count), delegate, FontImports).toUtf8();
+}
+
+// Names of the QML singletons providing the symbols of each font.
+[[nodiscard]] QStringList fontSingletons()
+{
+#ifdef ICONFONTS_QML_FONT_MODULES
+    // each font has a module of its own
+    return QDir{QString::fromUtf8(ICONFONTS_QML_IMPORT_PATH "/IconFonts")}.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+#else
+    // the module's types get registered when it is imported the first time
+    auto engine = QQmlEngine{};
+    auto component = QQmlComponent{&engine};
+    component.setData("import IconFonts\nimport QtQml\nQtObject {}"_ba, QUrl{});
+    delete component.create();
+
+    auto names = QStringList{};
+
+    for (const auto &type : QQmlMetaType::qmlAllTypes()) {
+        if (type.module() == "IconFonts"_L1 && type.isSingleton()
+                && type.metaObject() && type.metaObject()->indexOfEnumerator("TaggedSymbol") >= 0)
+            names.append(type.elementName());
+    }
+
+    names.sort();
+    return names;
+#endif
+}
+
+[[nodiscard]] IconFonts::FontInfo availableFont()
+{
+    for (const auto &font : IconFonts::FontInfo::knownFonts()) {
+        if (font.isAvailable() && font.symbolCount() > 0)
+            return font;
+    }
+
+    return {};
+}
+
 class CPlusPlusTest : public QObject
 {
     Q_OBJECT
 
 private slots:
+    void initTestCase()
+    {
+#ifdef ICONFONTS_QML_FONT_MODULES
+        // the modules of the fonts are plugins, which must be found on the import path
+        qputenv("QML_IMPORT_PATH", ICONFONTS_QML_IMPORT_PATH);
+#endif
+    }
+
     void testPropertiesComplete_data()
     {
         QMetaType::registerConverter<Symbol, IconFonts::Symbol>(); // FIXME: find better place
@@ -65,6 +198,380 @@ private slots:
             QVERIFY(QMetaType::canConvert(baseProperty.metaType(), quickProperty.metaType()));
         }
     }
+
+    void testFontIconItem()
+    {
+        auto view = QQuickView{};
+        auto component = QQmlComponent{view.engine()};
+        component.setData(iconGrid(u"FontIcon"_s, 1), QUrl{});
+
+        const auto root = qobject_cast<QQuickItem *>(component.create());
+        QVERIFY2(root, qPrintable(component.errorString()));
+        view.setContent(component.url(), &component, root);
+
+        const auto icon = root->findChild<FontIconItem *>();
+        QVERIFY(icon);
+        QVERIFY(!icon->icon().isNull());
+
+        view.resize(48, 48);
+        view.show();
+        QVERIFY(QTest::qWaitForWindowExposed(&view));
+
+        const auto image = view.grabWindow();
+        auto hasContent = false;
+
+        for (auto y = 0; y < 24 && !hasContent; ++y) {
+            for (auto x = 0; x < 24 && !hasContent; ++x)
+                hasContent = image.pixelColor(x, y) != image.pixelColor(40, 40);
+        }
+
+        QVERIFY(hasContent);
+
+        auto iconChanges = 0;
+        connect(icon, &FontIconItem::iconChanged, this, [&iconChanges] { ++iconChanges; });
+
+        icon->setIcon(icon->icon());
+        QCOMPARE(iconChanges, 0);
+        icon->setIcon(FontIcon{});
+        QCOMPARE(iconChanges, 1);
+    }
+
+    void testEffectiveColor()
+    {
+        auto view = QQuickView{};
+        auto component = QQmlComponent{view.engine()};
+        component.setData(iconGrid(u"FontIcon"_s, 1), QUrl{});
+
+        const auto root = qobject_cast<QQuickItem *>(component.create());
+        QVERIFY2(root, qPrintable(component.errorString()));
+        view.setContent(component.url(), &component, root);
+
+        view.show();
+        QVERIFY(QTest::qWaitForWindowExposed(&view));
+
+        const auto icon = root->findChild<FontIconItem *>();
+        QVERIFY(icon);
+
+        const auto resolvedColor = [icon] {
+            return icon->options().effectiveColor(icon, icon->icon().color(), icon->isActive());
+        };
+
+        const auto enabledColor = icon->effectiveColor();
+        QVERIFY(enabledColor.isValid());
+        QCOMPARE(enabledColor, resolvedColor());
+
+        auto colorChanges = QSignalSpy{icon, &FontIconItem::effectiveColorChanged};
+
+        // the color only gets resolved again, and reported, when it actually changed
+        icon->setSize({32, 32});
+        icon->setIcon(icon->icon());
+        QCOMPARE(colorChanges.count(), 0);
+
+        icon->setEnabled(false);
+        const auto disabledColor = resolvedColor();
+        QCOMPARE(icon->effectiveColor(), disabledColor);
+        QCOMPARE(colorChanges.count(), disabledColor != enabledColor ? 1 : 0);
+
+        colorChanges.clear();
+        icon->setEnabled(true);
+        QCOMPARE(icon->effectiveColor(), enabledColor);
+        QCOMPARE(colorChanges.count(), disabledColor != enabledColor ? 1 : 0);
+
+        // palette changes reach the item via events
+        const auto restorePalette = qScopeGuard([palette = QGuiApplication::palette()] {
+            QGuiApplication::setPalette(palette);
+        });
+
+        // the text color is set for all color groups, so that it doesn't matter if the window is active
+        auto palette = QGuiApplication::palette();
+        palette.setColor(QPalette::Text, Qt::magenta);
+        QVERIFY(enabledColor != palette.color(QPalette::Text));
+
+        colorChanges.clear();
+        QGuiApplication::setPalette(palette);
+
+        QTRY_COMPARE(icon->effectiveColor(), palette.color(QPalette::Text));
+        QCOMPARE(colorChanges.count(), 1);
+    }
+
+    void testIconAtlas()
+    {
+        auto view = QQuickView{};
+        auto component = QQmlComponent{view.engine()};
+        component.setData(iconGrid(u"FontIcon"_s, 3), QUrl{});
+
+        const auto root = qobject_cast<QQuickItem *>(component.create());
+        QVERIFY2(root, qPrintable(component.errorString()));
+        view.setContent(component.url(), &component, root);
+
+        const auto icons = root->findChildren<FontIconItem *>();
+        QCOMPARE(icons.size(), 3);
+
+        // icons of different color still share the texture, since their color gets baked into their cell
+        const auto colors = std::array{QColor{Qt::red}, QColor{Qt::green}, QColor{Qt::blue}};
+
+        for (auto i = 0U; i < colors.size(); ++i) {
+            const auto icon = IconFonts::FontIcon{icons[static_cast<qsizetype>(i)]->icon()};
+            icons[static_cast<qsizetype>(i)]->setIcon(IconFonts::FontIcon{icon, colors[i]});
+        }
+
+        view.resize(96, 48);
+        view.show();
+        QVERIFY(QTest::qWaitForWindowExposed(&view));
+
+        const auto image = view.grabWindow();
+        const auto atlas = Private::IconAtlas::forWindow(&view);
+        QVERIFY(atlas);
+
+        QCOMPARE(atlas->pageCount(), 1);
+        QCOMPARE(atlas->cellCount(), 3);
+
+        // the cells must not bleed into each other, and each icon must show its own color
+        for (auto i = 0U; i < colors.size(); ++i) {
+            auto hasColor = false;
+
+            for (auto y = 0; y < 24 && !hasColor; ++y) {
+                for (auto x = 0; x < 24 && !hasColor; ++x)
+                    hasColor = image.pixelColor(static_cast<int>(i) * 24 + x, y) == colors[i];
+            }
+
+            QVERIFY2(hasColor, qPrintable(colors[i].name()));
+        }
+
+        // pages whose cells are not shown anymore get reused, so that animated colors do not grow the atlas
+        const auto icon = IconFonts::FontIcon{icons.constFirst()->icon()};
+
+        for (auto i = 0; i < 1000; ++i) {
+            const auto key = Private::IconAtlas::Key{
+                .icon   = IconFonts::FontIcon{icon, QColor::fromRgb(static_cast<QRgb>(i))},
+                .size   = QSize{24, 24},
+            };
+
+            QVERIFY(atlas->insert(key).isValid());
+            atlas->release(key);
+        }
+
+        QCOMPARE(atlas->pageCount(), 2);
+        QVERIFY(atlas->cellCount() > 3);
+
+        // trimming keeps the cells still shown
+        const auto pageBytes = qint64{Private::IconAtlas::PageSize} * Private::IconAtlas::PageSize * 4;
+        QVERIFY(IconFonts::trimCaches(IconFonts::TrimLevel::Rasters).rasters >= pageBytes);
+        QCOMPARE(atlas->pageCount(), 1);
+        QCOMPARE(atlas->cellCount(), 3);
+
+        QCOMPARE(view.grabWindow(), image);
+    }
+
+    void testImageProvider_data()
+    {
+        QTest::addColumn<QString>("id");
+        QTest::addColumn<IconFonts::FontIcon>("expectedIcon");
+
+        const auto font = availableFont();
+        QVERIFY(font.isValid());
+
+        const auto tag = QString::number(font.tag().index());
+        const auto key = QString::fromLatin1(font.key(0));
+        const auto unicode = QString::number(font.unicode(0), 16);
+        const auto symbol = font.symbol(0);
+
+        QTest::newRow("tag")       << tag + u'/' + key                      << IconFonts::FontIcon{symbol};
+        QTest::newRow("name")      << font.fontName() + u'/' + key          << IconFonts::FontIcon{symbol};
+        QTest::newRow("unicode")   << tag + u"/U+"_s + unicode              << IconFonts::FontIcon{symbol};
+        QTest::newRow("color")     << tag + u'/' + key + u"?color=%23f00"_s << IconFonts::FontIcon{symbol, Qt::red};
+
+        QTest::newRow("transform")
+                << tag + u'/' + key + u"?transform=Rotate90"_s
+                << IconFonts::FontIcon{symbol, {}, IconFonts::FontIcon::Transform::Rotate90};
+
+#ifdef ICONFONTS_ENABLE_MATERIALSYMBOLS_ROUNDED
+        using IconFonts::MaterialSymbolsRounded;
+
+        // numeric tags also identify fonts registered at runtime
+        QVERIFY(IconFonts::Private::loadResources<MaterialSymbolsRounded>());
+
+        const auto fileName = IconFonts::fontFileName<MaterialSymbolsRounded>();
+        const auto runtimeFont = IconFonts::DynamicFont::registerFont(fileName);
+        QVERIFY(runtimeFont.isValid());
+
+        QTest::newRow("runtime-tag")
+                << QString::number(runtimeFont.tag().index()) + u'/' + QString::fromLatin1(runtimeFont.key(0))
+                << IconFonts::FontIcon{runtimeFont.symbol(0)};
+#endif
+
+        QTest::newRow("unknown-font")      << u"unknown/"_s + key                      << IconFonts::FontIcon{};
+        QTest::newRow("unknown-tag")       << u"127/"_s + key                          << IconFonts::FontIcon{};
+        QTest::newRow("invalid-tag")       << u"0/"_s + key                            << IconFonts::FontIcon{};
+        QTest::newRow("unknown-symbol")    << tag + u"/unknown-symbol"_s               << IconFonts::FontIcon{};
+        QTest::newRow("invalid-color")     << tag + u'/' + key + u"?color=invalid"_s   << IconFonts::FontIcon{};
+        QTest::newRow("invalid-transform") << tag + u'/' + key + u"?transform=Matrix"_s << IconFonts::FontIcon{};
+    }
+
+    void testImageProvider()
+    {
+        const QFETCH(QString, id);
+        const QFETCH(IconFonts::FontIcon, expectedIcon);
+
+        QCOMPARE(FontIconImageProvider::iconForId(id), expectedIcon);
+
+        auto view = QQuickView{};
+        auto component = QQmlComponent{view.engine()};
+        component.setData(uR"(
+            import IconFonts
+            import QtQuick
+
+            Image {
+                asynchronous: true
+                source: "image://iconfonts/%1"
+                sourceSize: Qt.size(24, 24)
+            }
+        )"_s.arg(id).toUtf8(), QUrl{});
+
+        const auto root = qobject_cast<QQuickItem *>(component.create());
+        QVERIFY2(root, qPrintable(component.errorString()));
+        view.setContent(component.url(), &component, root);
+
+        // the module registered the provider, which rasterized the icon at the requested size
+        constexpr auto Ready = 1;
+        constexpr auto Error = 3;
+
+        QTRY_VERIFY(root->property("status").toInt() == Ready || root->property("status").toInt() == Error);
+        QCOMPARE(root->property("status").toInt(), expectedIcon.isNull() ? Error : Ready);
+
+        if (!expectedIcon.isNull())
+            QCOMPARE(root->implicitWidth(), 24);
+    }
+
+    void benchmarkImport_data()
+    {
+        QTest::addColumn<QStringList>("fonts");
+
+        const auto fonts = fontSingletons();
+        QVERIFY(!fonts.isEmpty());
+
+        QTest::newRow("one-font")  << fonts.first(1);
+        QTest::newRow("all-fonts") << fonts;
+    }
+
+    void benchmarkImport()
+    {
+        const QFETCH(QStringList, fonts);
+
+        auto imports = QStringList{u"import IconFonts"_s, u"import QtQml"_s};
+        auto references = QStringList{};
+
+        for (const auto &font : fonts) {
+#ifdef ICONFONTS_QML_FONT_MODULES
+            imports.append(u"import IconFonts."_s + font);
+#endif
+            references.append(font + u".font"_s);
+        }
+
+        const auto qml = u"%1\nQtObject { readonly property var fonts: [%2] }"_s
+                .arg(imports.join(u'\n'), references.join(u", "_s)).toUtf8();
+
+        // types are registered once per process, the first round therefore also measures registering them
+        auto timer = QElapsedTimer{};
+        auto firstRound = std::optional<qint64>{};
+
+        QBENCHMARK {
+            timer.start();
+
+            auto engine = QQmlEngine{};
+            auto component = QQmlComponent{&engine};
+            component.setData(qml, QUrl{});
+
+            const auto object = std::unique_ptr<QObject>{component.create()};
+            QVERIFY2(object, qPrintable(component.errorString()));
+
+            if (!firstRound)
+                firstRound = timer.nsecsElapsed() / 1000;
+        }
+
+        qInfo("first import of %lld font(s) took %lld us",
+              static_cast<qint64>(fonts.size()), firstRound.value_or(0));
+    }
+
+    void benchmarkFontIcon_data()
+    {
+        QTest::addColumn<QString>("delegate");
+
+        QTest::newRow("item")     << u"FontIcon"_s;
+        QTest::newRow("composed") << u"ComposedFontIcon"_s;
+    }
+
+    void benchmarkFontIcon()
+    {
+        const QFETCH(QString, delegate);
+
+        auto view = QQuickView{};
+        auto component = QQmlComponent{view.engine()};
+        component.setData(iconGrid(delegate, 500), QUrl{});
+
+        const auto root = qobject_cast<QQuickItem *>(component.create());
+        QVERIFY2(root, qPrintable(component.errorString()));
+        view.setContent(component.url(), &component, root);
+
+        view.resize(600, 480);
+        view.show();
+        QVERIFY(QTest::qWaitForWindowExposed(&view));
+
+        qInfo("%lld objects for 500 icons", static_cast<qint64>(root->findChildren<QObject *>().size()));
+
+        // each round changes the icons' size, which invalidates whatever the delegates derived from it
+        auto size = 24;
+
+        QBENCHMARK {
+            size = (size == 24 ? 23 : 24);
+
+            for (const auto item : root->childItems())
+                item->setSize(QSizeF(size, size));
+
+            std::ignore = view.grabWindow();
+        }
+    }
+
+    void benchmarkEffectiveColor_data()
+    {
+        QTest::addColumn<bool>("cached");
+
+        QTest::newRow("cached")   << true;
+        QTest::newRow("resolved") << false;
+    }
+
+    void benchmarkEffectiveColor()
+    {
+        const QFETCH(bool, cached);
+
+        auto view = QQuickView{};
+        auto component = QQmlComponent{view.engine()};
+        component.setData(iconGrid(u"FontIcon"_s, 500), QUrl{});
+
+        const auto root = qobject_cast<QQuickItem *>(component.create());
+        QVERIFY2(root, qPrintable(component.errorString()));
+        view.setContent(component.url(), &component, root);
+
+        const auto icons = root->findChildren<FontIconItem *>();
+        QCOMPARE(icons.size(), 500);
+
+        // reading the cached property, versus what each binding of a delegate did before
+        auto validCount = 0;
+
+        QBENCHMARK {
+            validCount = 0;
+
+            for (const auto icon : icons) {
+                const auto color = cached ? icon->effectiveColor()
+                                          : icon->options().effectiveColor(icon, icon->icon().color());
+
+                if (color.isValid())
+                    ++validCount;
+            }
+        }
+
+        QCOMPARE(validCount, icons.size());
+    }
 };
 
 } // namespace
@@ -0,0 +1,158 @@
+#include "iconfonts/rastercache_p.h"
+#include "testutils.h"
+
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QTest>
+
+using namespace Qt::StringLiterals;
+
+namespace IconFonts::Tests {
+namespace {
+
+using Private::RasterCache;
+
+class RasterCacheTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testPersistence()
+    {
+        const auto directory = QTemporaryDir{};
+        QVERIFY(directory.isValid());
+
+        const auto fileName = directory.filePath(u"test.rasters"_s);
+
+        const auto argb = testImage({17, 23}, QImage::Format_ARGB32_Premultiplied);
+        const auto alpha = testImage({31, 5}, QImage::Format_Alpha8);
+
+        {
+            auto cache = RasterCache{fileName};
+            QVERIFY(cache.isValid());
+            QVERIFY(cache.find(testKey('A', argb.size())).isNull());
+
+            cache.insert(testKey('A', argb.size()), argb);
+            cache.insert(testKey('B', alpha.size()), alpha);
+
+            // new rasters are served from memory until the next launch
+            QCOMPARE(cache.find(testKey('A', argb.size())), argb);
+            QCOMPARE(cache.find(testKey('B', alpha.size())), alpha);
+        }
+
+        const auto cache = RasterCache{fileName};
+        QVERIFY(cache.isValid());
+
+        QCOMPARE(cache.find(testKey('A', argb.size())), argb);
+        QCOMPARE(cache.find(testKey('B', alpha.size())), alpha);
+        QVERIFY(cache.find(testKey('A', alpha.size())).isNull());
+        QVERIFY(cache.find(testKey('C', argb.size())).isNull());
+    }
+
+    void testTruncatedFile()
+    {
+        const auto directory = QTemporaryDir{};
+        QVERIFY(directory.isValid());
+
+        const auto fileName = directory.filePath(u"test.rasters"_s);
+        const auto first = testImage({16, 16}, QImage::Format_ARGB32_Premultiplied);
+        const auto second = testImage({24, 24}, QImage::Format_ARGB32_Premultiplied);
+
+        {
+            auto cache = RasterCache{fileName};
+            cache.insert(testKey('A', first.size()), first);
+            cache.insert(testKey('B', second.size()), second);
+        }
+
+        // simulates an application that got killed while writing its last raster
+        auto file = QFile{fileName};
+        QVERIFY(file.resize(file.size() - 100));
+
+        {
+            const auto cache = RasterCache{fileName};
+            QVERIFY(cache.isValid());
+            QCOMPARE(cache.find(testKey('A', first.size())), first);
+            QVERIFY(cache.find(testKey('B', second.size())).isNull());
+        }
+
+        // the incomplete record got removed, so that new records can follow
+        {
+            auto cache = RasterCache{fileName};
+            cache.insert(testKey('C', second.size()), second);
+        }
+
+        const auto cache = RasterCache{fileName};
+        QCOMPARE(cache.find(testKey('A', first.size())), first);
+        QCOMPARE(cache.find(testKey('C', second.size())), second);
+    }
+
+    void testTrim()
+    {
+        const auto directory = QTemporaryDir{};
+        QVERIFY(directory.isValid());
+
+        const auto fileName = directory.filePath(u"test.rasters"_s);
+        const auto image = testImage({16, 16}, QImage::Format_ARGB32_Premultiplied);
+
+        {
+            auto cache = RasterCache{fileName};
+            cache.insert(testKey('A', image.size()), image);
+            QCOMPARE(cache.find(testKey('A', image.size())), image);
+
+            // trimmed rasters are not appended again
+            QCOMPARE(cache.trim(), image.sizeInBytes());
+            QVERIFY(cache.find(testKey('A', image.size())).isNull());
+            QCOMPARE(cache.trim(), qint64{0});
+
+            cache.insert(testKey('A', image.size()), image);
+            QVERIFY(cache.find(testKey('A', image.size())).isNull());
+
+            // rasters beyond the size limit of the pack file are neither written nor kept
+            auto largeImage = QImage{4096, 4096, QImage::Format_ARGB32_Premultiplied};
+            largeImage.fill(Qt::red);
+
+            cache.insert(testKey('B', largeImage.size()), largeImage);
+            QVERIFY(cache.find(testKey('B', largeImage.size())).isNull());
+        }
+
+        const auto cache = RasterCache{fileName};
+        QCOMPARE(cache.find(testKey('A', image.size())), image);
+        QVERIFY(cache.find(testKey('B', {4096, 4096})).isNull());
+        QVERIFY(QFileInfo{fileName}.size() < 1024 + image.sizeInBytes());
+    }
+
+    void testInvalidFile()
+    {
+        const auto directory = QTemporaryDir{};
+        QVERIFY(directory.isValid());
+
+        const auto fileName = directory.filePath(u"test.rasters"_s);
+
+        auto file = QFile{fileName};
+        QVERIFY(file.open(QFile::WriteOnly));
+        QVERIFY(file.write(QByteArray(1000, 'x')) == 1000);
+        file.close();
+
+        const auto cache = RasterCache{fileName};
+        QVERIFY(cache.isValid());
+        QCOMPARE(QFileInfo{fileName}.size(), qint64{16});
+    }
+
+    void testFingerprint()
+    {
+        for (const auto &font : FontInfo::knownFonts()) {
+            if (!font.isAvailable())
+                continue;
+
+            QCOMPARE(RasterCache::fingerprint(font), RasterCache::fingerprint(font));
+            QVERIFY(RasterCache::fingerprint(font) != 0);
+        }
+    }
+};
+
+} // namespace
+} // namespace IconFonts::Tests
+
+QTEST_MAIN(IconFonts::Tests::RasterCacheTest)
+
+#include "tst_rastercache.moc"
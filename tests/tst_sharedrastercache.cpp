@@ -0,0 +1,93 @@
+#include "iconfonts/sharedrastercache_p.h"
+#include "testutils.h"
+
+#include <QRegularExpression>
+#include <QTest>
+#include <QUuid>
+
+using namespace Qt::StringLiterals;
+
+namespace IconFonts::Tests {
+namespace {
+
+using Private::SharedRasterCache;
+
+[[nodiscard]] QString uniqueName()
+{
+    return QUuid::createUuid().toString(QUuid::WithoutBraces);
+}
+
+class SharedRasterCacheTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testSharing()
+    {
+        const auto name = uniqueName();
+        const auto argb = testImage({17, 23}, QImage::Format_ARGB32_Premultiplied);
+        const auto alpha = testImage({31, 5}, QImage::Format_Alpha8);
+
+        auto first = SharedRasterCache{name, 1024 * 1024};
+        QVERIFY(first.isValid());
+        QVERIFY(first.find(testKey('A', argb.size())).isNull());
+
+        // simulates another process that attaches to the same segment
+        auto second = SharedRasterCache{name};
+        QVERIFY(second.isValid());
+
+        first.insert(testKey('A', argb.size()), argb);
+        second.insert(testKey('B', alpha.size()), alpha);
+
+        QCOMPARE(first.find(testKey('A', argb.size())), argb);
+        QCOMPARE(first.find(testKey('B', alpha.size())), alpha);
+        QCOMPARE(second.find(testKey('A', argb.size())), argb);
+        QCOMPARE(second.find(testKey('B', alpha.size())), alpha);
+
+        QVERIFY(second.find(testKey('A', alpha.size())).isNull());
+        QVERIFY(second.find(testKey('C', argb.size())).isNull());
+    }
+
+    void testFullSlab()
+    {
+        const auto name = uniqueName();
+        const auto image = testImage({64, 64}, QImage::Format_ARGB32_Premultiplied);
+
+        auto cache = SharedRasterCache{name, 1024 * 1024};
+        QVERIFY(cache.isValid());
+
+        // the slab holds less than 64 of these rasters, a full cache gets reset to make room for new ones
+        for (auto unicode = U'A'; unicode < U'A' + 128; ++unicode) {
+            cache.insert(testKey(unicode, image.size()), image);
+            QCOMPARE(cache.find(testKey(unicode, image.size())), image);
+        }
+
+        QVERIFY(cache.find(testKey('A', image.size())).isNull());
+
+        // other processes see the reset too
+        const auto other = SharedRasterCache{name};
+        QVERIFY(other.isValid());
+        QVERIFY(other.find(testKey('A', image.size())).isNull());
+        QCOMPARE(other.find(testKey(U'A' + 127, image.size())), image);
+
+        // rasters larger than the entire slab never reset the cache
+        const auto huge = testImage({1024, 1024}, QImage::Format_ARGB32_Premultiplied);
+        cache.insert(testKey('Z', huge.size()), huge);
+
+        QVERIFY(cache.find(testKey('Z', huge.size())).isNull());
+        QCOMPARE(cache.find(testKey(U'A' + 127, image.size())), image);
+    }
+
+    void testTooSmall()
+    {
+        QTest::ignoreMessage(QtWarningMsg, QRegularExpression{u"Shared raster cache .* is too small"_s});
+        QVERIFY(!SharedRasterCache{uniqueName(), 1024}.isValid());
+    }
+};
+
+} // namespace
+} // namespace IconFonts::Tests
+
+QTEST_MAIN(IconFonts::Tests::SharedRasterCacheTest)
+
+#include "tst_sharedrastercache.moc"
@@ -0,0 +1,134 @@
+#include "iconfonts/symbolindex.h"
+
+#include <QTest>
+
+#include <algorithm>
+
+namespace IconFonts::Tests {
+namespace {
+
+[[nodiscard]] bool contains(std::span<const Symbol> symbols, const Symbol &symbol)
+{
+    return std::ranges::find(symbols, symbol) != symbols.end();
+}
+
+// turns "ArrowLeft" into "a-r-r-o-w-l-e-f-t"
+[[nodiscard]] QByteArray scramble(QByteArrayView key)
+{
+    auto result = QByteArray{};
+
+    for (const auto ch : key) {
+        if (!result.isEmpty())
+            result.append('-');
+
+        result.append(ch);
+    }
+
+    return result.toLower();
+}
+
+class SymbolIndexTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase()
+    {
+        if (FontInfo::knownFonts().isEmpty())
+            QSKIP("No fonts configured for testing");
+    }
+
+    void testEmptyIndex()
+    {
+        const auto index = SymbolIndex{};
+
+        QVERIFY(index.isEmpty());
+        QCOMPARE(index.symbolCount(), 0);
+        QVERIFY(index.find(U'\xf060').empty());
+        QVERIFY(index.find("arrow-left").empty());
+    }
+
+    void testKnownFonts_data()
+    {
+        QTest::addColumn<FontInfo>("font");
+
+        for (const auto &font : FontInfo::knownFonts())
+            QTest::newRow(font.enumType().name()) << font;
+    }
+
+    void testKnownFonts()
+    {
+        const QFETCH(FontInfo, font);
+        const auto &index = SymbolIndex::instance();
+
+        QVERIFY(!index.isEmpty());
+
+        for (auto count = font.symbolCount(), i = 0; i < count; ++i) {
+            const auto symbol = font.symbol(i);
+            const auto key = QByteArrayView{font.key(i)};
+
+            QVERIFY2(contains(index.find(symbol.unicode()), symbol), key.data());
+            QVERIFY2(contains(index.find(key), symbol), key.data());
+            QVERIFY2(contains(index.find(scramble(key)), symbol), key.data());
+        }
+    }
+
+    void testUnicodeResults()
+    {
+        const auto &index = SymbolIndex::instance();
+        const auto &font = FontInfo::knownFonts().constFirst();
+        const auto unicode = font.unicode(0);
+        const auto symbols = index.find(unicode);
+
+        QVERIFY(!symbols.empty());
+
+        // each font is reported once, even if it has aliases for the codepoint
+        for (const auto &symbol : symbols) {
+            QCOMPARE(symbol.unicode(), unicode);
+            QCOMPARE(std::ranges::count(symbols, symbol.fontInfo(), &Symbol::fontInfo), 1);
+        }
+
+        QVERIFY(index.find("no-such-symbol-exists-in-any-font").empty());
+    }
+
+    void benchmarkBuild()
+    {
+        const auto &fonts = FontInfo::knownFonts();
+        auto symbolCount = qsizetype{0};
+
+        QBENCHMARK {
+            symbolCount = SymbolIndex{fonts}.symbolCount();
+        }
+
+        qInfo() << "font count:" << fonts.count() << "symbol count:" << symbolCount;
+    }
+
+    void benchmarkFindByName()
+    {
+        const auto &index = SymbolIndex::instance();
+        const auto &font = FontInfo::knownFonts().constFirst();
+        const auto key = scramble(font.key(font.symbolCount() / 2));
+
+        QBENCHMARK {
+            QVERIFY(!index.find(key).empty());
+        }
+    }
+
+    void benchmarkFindByUnicode()
+    {
+        const auto &index = SymbolIndex::instance();
+        const auto &font = FontInfo::knownFonts().constFirst();
+        const auto unicode = font.unicode(font.symbolCount() / 2);
+
+        QBENCHMARK {
+            QVERIFY(!index.find(unicode).empty());
+        }
+    }
+};
+
+} // namespace
+} // namespace IconFonts::Tests
+
+QTEST_MAIN(IconFonts::Tests::SymbolIndexTest)
+
+#include "tst_symbolindex.moc"
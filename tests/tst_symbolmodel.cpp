@@ -0,0 +1,288 @@
+#include "iconfonts/symbolmodel.h"
+
+#include <QAbstractItemModelTester>
+#include <QSignalSpy>
+#include <QTest>
+
+namespace IconFonts::Tests {
+namespace {
+
+using namespace Qt::StringLiterals;
+
+[[nodiscard]] int matchCount(const QList<FontInfo> &fonts, const QString &filter)
+{
+    auto count = 0;
+
+    for (const auto &font : fonts) {
+        for (auto i = 0; i < font.symbolCount(); ++i) {
+            if (font.name(i).contains(filter, Qt::CaseInsensitive))
+                ++count;
+        }
+    }
+
+    return count;
+}
+
+[[nodiscard]] int totalSymbolCount(const QList<FontInfo> &fonts)
+{
+    auto count = 0;
+
+    for (const auto &font : fonts)
+        count += font.symbolCount();
+
+    return count;
+}
+
+void fetchAll(QAbstractItemModel *model)
+{
+    while (model->canFetchMore({}))
+        model->fetchMore({});
+}
+
+class SymbolModelTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase()
+    {
+        if (FontInfo::knownFonts().isEmpty())
+            QSKIP("No fonts configured for testing");
+    }
+
+    void testEmptyModel()
+    {
+        auto model = SymbolModel{};
+        const auto tester = QAbstractItemModelTester{&model};
+
+        QCOMPARE(model.rowCount(), 0);
+        QCOMPARE(model.symbolCount(), 0);
+        QVERIFY(!model.canFetchMore({}));
+        QVERIFY(model.symbol(0).isNull());
+    }
+
+    void testConcatenatedFonts()
+    {
+        const auto fonts = FontInfo::knownFonts().first(std::min(FontInfo::knownFonts().size(), qsizetype{2}));
+
+        auto model = SymbolModel{};
+        const auto tester = QAbstractItemModelTester{&model};
+
+        model.setFonts(fonts);
+
+        QCOMPARE(model.symbolCount(), totalSymbolCount(fonts));
+        QCOMPARE(model.rowCount(), std::min(model.symbolCount(), SymbolModel::FetchSize));
+
+        fetchAll(&model);
+
+        QCOMPARE(model.rowCount(), model.symbolCount());
+
+        // the symbols of each font follow the symbols of the fonts before
+        auto row = 0;
+
+        for (const auto &font : fonts) {
+            for (const auto i : {0, font.symbolCount() - 1}) {
+                const auto index = model.index(row + i);
+                const auto symbol = font.symbol(i);
+
+                QCOMPARE(model.symbol(row + i), symbol);
+                QCOMPARE(index.data(SymbolModel::NameRole).toString(), font.name(i));
+                QCOMPARE(index.data(SymbolModel::CodepointRole).toUInt(), static_cast<uint>(symbol.unicode()));
+                QCOMPARE(index.data(SymbolModel::TextRole).toString(), symbol.toString());
+                QCOMPARE(index.data(SymbolModel::TagRole).toUInt(), symbol.tag().value());
+                QCOMPARE(index.data(SymbolModel::FontIconRole).value<FontIcon>(), FontIcon{symbol});
+                QCOMPARE(index.data(Qt::DisplayRole).toString(), font.name(i));
+            }
+
+            row += font.symbolCount();
+        }
+
+        const auto roleNames = model.roleNames();
+
+        QCOMPARE(roleNames.value(SymbolModel::NameRole),     "name"_ba);
+        QCOMPARE(roleNames.value(SymbolModel::FontIconRole), "fonticon"_ba);
+    }
+
+    void testFilter()
+    {
+        const auto &font = FontInfo::knownFonts().constFirst();
+        const auto filter = QString::fromLatin1(font.key(font.symbolCount() / 2)).left(3);
+
+        auto model = SymbolModel{};
+        model.setFonts({font});
+
+        auto filterModel = SymbolFilterModel{};
+        const auto tester = QAbstractItemModelTester{&filterModel};
+
+        filterModel.setSourceModel(&model);
+
+        // without filter all symbols are listed immediately
+        QVERIFY(!filterModel.isFiltering());
+        QCOMPARE(filterModel.matchCount(), font.symbolCount());
+
+        auto filteringChanges = QSignalSpy{&filterModel, &SymbolFilterModel::filteringChanged};
+
+        filterModel.setFilter(filter);
+
+        QVERIFY(filterModel.isFiltering());
+        QTRY_VERIFY(!filterModel.isFiltering());
+        QCOMPARE(filteringChanges.count(), 2);
+
+        auto expectedCount = 0;
+
+        for (auto i = 0; i < font.symbolCount(); ++i) {
+            if (font.name(i).contains(filter, Qt::CaseInsensitive))
+                ++expectedCount;
+        }
+
+        QVERIFY(expectedCount > 0);
+        QCOMPARE(filterModel.matchCount(), expectedCount);
+
+        fetchAll(&filterModel);
+        QCOMPARE(filterModel.rowCount(), expectedCount);
+
+        for (auto row = 0; row < filterModel.rowCount(); ++row) {
+            const auto name = filterModel.index(row).data(SymbolModel::NameRole).toString();
+            QVERIFY2(name.contains(filter, Qt::CaseInsensitive), qPrintable(name));
+            QCOMPARE(filterModel.row(filterModel.sourceRow(row)), row);
+        }
+
+        for (auto i = 0; i < font.symbolCount(); ++i) {
+            if (!font.name(i).contains(filter, Qt::CaseInsensitive))
+                QCOMPARE(filterModel.row(i), -1);
+        }
+
+        // results of outdated filters are dropped
+        filterModel.setFilter(u"no-such-symbol-exists-in-any-font"_s);
+        filterModel.setFilter({});
+
+        QVERIFY(!filterModel.isFiltering());
+        QTest::qWait(100);
+        QCOMPARE(filterModel.matchCount(), font.symbolCount());
+    }
+
+    void testRefineFilter()
+    {
+        const auto fonts = FontInfo::knownFonts();
+        const auto &font = fonts.constFirst();
+        const auto name = font.name(font.symbolCount() / 3);
+
+        auto model = SymbolModel{};
+        model.setFonts(fonts);
+
+        auto filterModel = SymbolFilterModel{};
+        filterModel.setSourceModel(&model);
+
+        // typing the name letter by letter refines the previous matches, which must not lose any symbol;
+        // the upper case variants check that the index of trigrams ignores case
+        for (const auto &typedName : {name, name.toUpper()}) {
+            for (auto length = 1; length <= typedName.size(); ++length) {
+                const auto filter = typedName.left(length);
+
+                filterModel.setFilter(filter);
+                QTRY_VERIFY(!filterModel.isFiltering());
+                QCOMPARE(filterModel.matchCount(), matchCount(fonts, filter));
+            }
+
+            filterModel.setFilter({});
+        }
+
+        // filters that don't refine the previous one get matched from scratch
+        filterModel.setFilter(name);
+        QTRY_VERIFY(!filterModel.isFiltering());
+
+        const auto other = font.name(0);
+
+        filterModel.setFilter(other);
+        QTRY_VERIFY(!filterModel.isFiltering());
+        QCOMPARE(filterModel.matchCount(), matchCount(fonts, other));
+        QVERIFY(filterModel.matchCount() > 0);
+    }
+
+    void testFilterDelay()
+    {
+        const auto &font = FontInfo::knownFonts().constFirst();
+        const auto name = font.name(font.symbolCount() / 2);
+
+        auto model = SymbolModel{};
+        model.setFonts({font});
+
+        auto filterModel = SymbolFilterModel{};
+        filterModel.setSourceModel(&model);
+        filterModel.setDelay(std::chrono::milliseconds{50});
+
+        auto modelResets = QSignalSpy{&filterModel, &SymbolFilterModel::modelReset};
+
+        // only the last filter gets matched, and applied as one batch
+        for (auto length = 1; length <= name.size(); ++length)
+            filterModel.setFilter(name.left(length));
+
+        QVERIFY(filterModel.isFiltering());
+        QCOMPARE(modelResets.count(), 0);
+
+        QTRY_VERIFY(!filterModel.isFiltering());
+        QCOMPARE(modelResets.count(), 1);
+        QCOMPARE(filterModel.matchCount(), matchCount({font}, name));
+    }
+
+    void testFontsChanged()
+    {
+        const auto fonts = FontInfo::knownFonts();
+
+        if (fonts.size() < 2)
+            QSKIP("At least two fonts must be configured for this test");
+
+        const auto &font = fonts.constFirst();
+        const auto name = font.name(font.symbolCount() / 2);
+
+        auto model = SymbolModel{};
+        model.setFonts(fonts);
+
+        auto filterModel = SymbolFilterModel{};
+        const auto tester = QAbstractItemModelTester{&filterModel};
+
+        filterModel.setSourceModel(&model);
+        filterModel.setDelay(std::chrono::milliseconds{50});
+        filterModel.setFilter(name);
+        QTRY_VERIFY(!filterModel.isFiltering());
+        QVERIFY(filterModel.matchCount() > 0);
+
+        // the previous matches are rows of other symbols now, they must be dropped before matching starts
+        model.setFonts({font});
+
+        QVERIFY(filterModel.isFiltering());
+        QCOMPARE(filterModel.matchCount(), 0);
+        QCOMPARE(filterModel.rowCount(), 0);
+
+        QTRY_VERIFY(!filterModel.isFiltering());
+        QCOMPARE(filterModel.matchCount(), matchCount({font}, name));
+    }
+
+    void benchmarkFilter()
+    {
+        const auto fonts = FontInfo::knownFonts();
+
+        auto model = SymbolModel{};
+        model.setFonts(fonts);
+
+        auto filterModel = SymbolFilterModel{};
+        filterModel.setSourceModel(&model);
+
+        auto filter = u"arrow"_s;
+
+        QBENCHMARK {
+            filterModel.setFilter(filter);
+            QTRY_VERIFY(!filterModel.isFiltering());
+            filter = (filter == "arrow"_L1 ? u"arrow-left"_s : u"arrow"_s);
+        }
+
+        qInfo() << "font count:" << fonts.count() << "symbol count:" << model.symbolCount();
+    }
+};
+
+} // namespace
+} // namespace IconFonts::Tests
+
+QTEST_MAIN(IconFonts::Tests::SymbolModelTest)
+
+#include "tst_symbolmodel.moc"
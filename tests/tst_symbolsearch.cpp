@@ -0,0 +1,201 @@
+#include "iconfonts/symbolsearch.h"
+
+#include <QTest>
+
+#include <algorithm>
+
+namespace IconFonts::Tests {
+namespace {
+
+using namespace Qt::StringLiterals;
+using Match = SymbolSearch::Match;
+
+[[nodiscard]] bool contains(const QList<Match> &matches, const Symbol &symbol)
+{
+    return std::ranges::find(matches, symbol, &Match::symbol) != matches.end();
+}
+
+// turns "ArrowLeft" into "arrowleft"
+[[nodiscard]] QString normalized(QByteArrayView key)
+{
+    auto result = QString{};
+
+    for (const auto ch : key) {
+        if (const auto latin1 = QChar::fromLatin1(ch); latin1.isLetterOrNumber())
+            result.append(latin1.toLower());
+    }
+
+    return result;
+}
+
+// turns "ArrowLeft" into "Arrow Left", and "HTMLParser" into "HTML Parser",
+// but keeps names with digits like "Html5Logo" in one piece
+[[nodiscard]] QString spaced(QByteArrayView key)
+{
+    auto result = QString::fromLatin1(key);
+
+    if (std::ranges::any_of(key, [](char ch) { return ch >= '0' && ch <= '9'; }))
+        return result;
+
+    for (auto i = result.size() - 1; i > 0; --i) {
+        const auto next = i + 1 < result.size() ? result[i + 1] : QChar{};
+
+        if (result[i].isUpper() && (result[i - 1].isLower() || (result[i - 1].isUpper() && next.isLower())))
+            result.insert(i, u' ');
+    }
+
+    return result;
+}
+
+class SymbolSearchTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase()
+    {
+        if (FontInfo::knownFonts().isEmpty())
+            QSKIP("No fonts configured for testing");
+    }
+
+    void testEmpty()
+    {
+        const auto search = SymbolSearch{};
+
+        QVERIFY(search.isEmpty());
+        QCOMPARE(search.symbolCount(), 0);
+        QCOMPARE(search.termCount(), 0);
+        QVERIFY(search.find(u"arrow left").isEmpty());
+        QVERIFY(SymbolSearch::instance().find(u"").isEmpty());
+        QVERIFY(SymbolSearch::instance().find(u" -_ ").isEmpty());
+        QVERIFY(SymbolSearch::instance().find(u"arrow", 0).isEmpty());
+    }
+
+    void testKnownFonts_data()
+    {
+        QTest::addColumn<FontInfo>("font");
+
+        for (const auto &font : FontInfo::knownFonts())
+            QTest::newRow(font.enumType().name()) << font;
+    }
+
+    void testKnownFonts()
+    {
+        const QFETCH(FontInfo, font);
+        const auto &search = SymbolSearch::instance();
+        const auto limit = search.symbolCount();
+
+        QVERIFY(!search.isEmpty());
+
+        for (auto count = font.symbolCount(), i = 0; i < count; i += std::max(1, count / 16)) {
+            const auto symbol = font.symbol(i);
+            const auto key = QByteArrayView{font.key(i)};
+            const auto name = normalized(key);
+
+            // exact names, with and without separate words, always get the best score
+            const auto exactMatches = search.find(name, limit);
+            QVERIFY2(contains(exactMatches, symbol), key.data());
+            QCOMPARE(std::ranges::find(exactMatches, symbol, &Match::symbol)->score, exactMatches.constFirst().score);
+
+            QVERIFY2(contains(search.find(spaced(key), limit), symbol), key.data());
+
+            // prefixes
+            if (name.size() > 2)
+                QVERIFY2(contains(search.find(name.chopped(1), limit), symbol), key.data());
+
+            // typos, like swapped characters
+            if (const auto middle = name.size() / 2; name.size() >= 5 && name[middle] != name[middle + 1]) {
+                auto typo = name;
+                std::swap(typo[middle], typo[middle + 1]);
+                QVERIFY2(contains(search.find(typo, limit), symbol), qPrintable(typo));
+            }
+        }
+    }
+
+    void testTags()
+    {
+        for (const auto &font : FontInfo::knownFonts()) {
+            const auto tags = font.searchTags();
+
+            if (tags.isEmpty())
+                continue;
+
+            const auto line = tags.first(tags.indexOf('\n'));
+            const auto separator = line.indexOf('=');
+            const auto key = line.first(separator);
+            const auto tag = QString::fromLatin1(line.sliced(separator + 1)).section(u',', 0, 0);
+
+            const auto &search = SymbolSearch::instance();
+
+            for (auto count = font.symbolCount(), i = 0; i < count; ++i) {
+                if (key == font.key(i)) {
+                    QVERIFY2(contains(search.find(tag, search.symbolCount()), font.symbol(i)), qPrintable(tag));
+                    return;
+                }
+            }
+
+            QFAIL(key.data());
+        }
+
+        QSKIP("None of the configured fonts has search tags");
+    }
+
+    void testRanking()
+    {
+        const auto &search = SymbolSearch::instance();
+        const auto matches = search.find(u"arrow", 10);
+
+        QVERIFY(matches.size() <= 10);
+        QVERIFY(std::ranges::is_sorted(matches, std::ranges::greater{}, &Match::score));
+        QVERIFY(search.find(u"qqqxxxzzzjjj").isEmpty());
+
+        // each word must match
+        QVERIFY(search.find(u"arrow qqqxxxzzzjjj").isEmpty());
+    }
+
+    void benchmarkBuild()
+    {
+        const auto &fonts = FontInfo::knownFonts();
+        auto termCount = qsizetype{0};
+        auto symbolCount = qsizetype{0};
+
+        QBENCHMARK {
+            const auto search = SymbolSearch{fonts};
+            termCount = search.termCount();
+            symbolCount = search.symbolCount();
+        }
+
+        qInfo() << "font count:" << fonts.count() << "symbol count:" << symbolCount << "term count:" << termCount;
+    }
+
+    void benchmarkFind_data()
+    {
+        QTest::addColumn<QString>("query");
+
+        QTest::newRow("exact") << u"arrow"_s;
+        QTest::newRow("prefix") << u"arr"_s;
+        QTest::newRow("typo") << u"arorw"_s;
+        QTest::newRow("words") << u"arrow left"_s;
+        QTest::newRow("unknown") << u"qqqxxxzzzjjj"_s;
+    }
+
+    void benchmarkFind()
+    {
+        const QFETCH(QString, query);
+        const auto &search = SymbolSearch::instance();
+        auto matchCount = qsizetype{0};
+
+        QBENCHMARK {
+            matchCount = search.find(query).size();
+        }
+
+        qInfo() << "match count:" << matchCount;
+    }
+};
+
+} // namespace
+} // namespace IconFonts::Tests
+
+QTEST_MAIN(IconFonts::Tests::SymbolSearchTest)
+
+#include "tst_symbolsearch.moc"
@@ -0,0 +1,41 @@
+#include "tst_symboltable.h"
+
+#include <QTest>
+
+namespace IconFonts::Tests {
+namespace {
+
+class SymbolTableTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testStaticSymbolTable()
+    {
+        const auto table = Private::SymbolTable::fromData(s_symbolTable.toByteArray());
+
+        QVERIFY(!table.isNull());
+        QCOMPARE(table.count(), 3);
+
+        // sorted by codepoint, aliases keep the order of their definition
+        QCOMPARE(table.unicode(0), U'\xf101');
+        QCOMPARE(table.unicode(1), U'\xf101');
+        QCOMPARE(table.unicode(2), U'\xf102');
+
+        QCOMPARE(table.key(0), "Settings");
+        QCOMPARE(table.key(1), "Gear");
+        QCOMPARE(table.key(2), "Launch");
+        QVERIFY(table.key(3) == nullptr);
+
+        QCOMPARE(table.unicode(table.indexOf(U'\xf101')), U'\xf101');
+        QCOMPARE(table.indexOf(U'\xf102'), 2);
+        QCOMPARE(table.indexOf(U'\xf103'), -1);
+    }
+};
+
+} // namespace
+} // namespace IconFonts::Tests
+
+QTEST_MAIN(IconFonts::Tests::SymbolTableTest)
+
+#include "tst_symboltable.moc"